@@ -199,7 +199,8 @@ MSC_SRC = \
             drivers/usb_msc_common.c \
             drivers/usb_msc_f4xx.c \
             msc/usbd_msc_desc.c \
-            msc/usbd_storage.c
+            msc/usbd_storage.c \
+            msc/usbd_storage_cache.c
 
 ifneq ($(filter SDCARD_SPI,$(FEATURES)),)
 MSC_SRC += \
@@ -198,7 +198,8 @@ MCU_EXCLUDES = \
 MSC_SRC = \
             drivers/usb_msc_common.c \
             drivers/usb_msc_f7xx.c \
-            msc/usbd_storage.c
+            msc/usbd_storage.c \
+            msc/usbd_storage_cache.c
 
 ifneq ($(filter SDCARD_SDIO,$(FEATURES)),)
 MCU_COMMON_SRC += \
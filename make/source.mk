@@ -177,6 +177,7 @@ COMMON_SRC = \
             sensors/barometer.c \
             sensors/rangefinder.c \
             telemetry/telemetry.c \
+            telemetry/sensors.c \
             telemetry/crsf.c \
             telemetry/ghst.c \
             telemetry/srxl.c \
@@ -314,6 +315,7 @@ SIZE_OPTIMISED_SRC := $(SIZE_OPTIMISED_SRC) \
             fc/init.c \
             fc/board_info.c \
             config/config_eeprom.c \
+            config/config_snapshot.c \
             config/feature.c \
             config/config_streamer.c \
             config/simplified_tuning.c \
@@ -112,4 +112,9 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     DEBUG_NAME(ERROR_DECAY),
     DEBUG_NAME(HS_OFFSET),
     DEBUG_NAME(HS_BLEED),
+    DEBUG_NAME(USB_MSC),
+    DEBUG_NAME(RC_PREDICTION),
+    DEBUG_NAME(RX_EXPRESSLRS_ISR),
+    DEBUG_NAME(GYRO_FIFO),
+    DEBUG_NAME(RPM_ESTIMATOR),
 };
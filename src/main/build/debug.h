@@ -123,6 +123,11 @@ typedef enum {
     DEBUG_ERROR_DECAY,
     DEBUG_HS_OFFSET,
     DEBUG_HS_BLEED,
+    DEBUG_USB_MSC,
+    DEBUG_RC_PREDICTION,
+    DEBUG_RX_EXPRESSLRS_ISR,
+    DEBUG_GYRO_FIFO,
+    DEBUG_RPM_ESTIMATOR,
     DEBUG_COUNT
 } debugType_e;
 
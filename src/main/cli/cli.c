@@ -57,6 +57,7 @@ bool cliMode = false;
 
 #include "config/config.h"
 #include "config/config_eeprom.h"
+#include "config/config_snapshot.h"
 #include "config/feature.h"
 
 #include "drivers/accgyro/accgyro.h"
@@ -99,6 +100,7 @@ bool cliMode = false;
 #include "fc/board_info.h"
 #include "fc/rc_rates.h"
 #include "fc/core.h"
+#include "fc/init.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
@@ -110,6 +112,7 @@ bool cliMode = false;
 #include "flight/pid.h"
 #include "flight/position.h"
 #include "flight/servos.h"
+#include "flight/setpoint.h"
 #include "flight/motors.h"
 
 #include "io/asyncfatfs/asyncfatfs.h"
@@ -168,6 +171,7 @@ bool cliMode = false;
 #include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
 #include "sensors/gyro_init.h"
+#include "sensors/initialisation.h"
 #include "sensors/sensors.h"
 
 #include "telemetry/frsky_hub.h"
@@ -198,8 +202,13 @@ static int8_t rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
 #ifdef USE_CLI_BATCH
 static bool commandBatchActive = false;
 static bool commandBatchError = false;
+// Profile selections made inside a batch are activated when it ends
+static int8_t commandBatchPidProfileIndex = CURRENT_PROFILE_INDEX;
+static int8_t commandBatchRateProfileIndex = CURRENT_PROFILE_INDEX;
 #endif
 
+static bool valueTableHashValid = false;
+
 #if defined(USE_BOARD_INFO)
 static bool boardInformationUpdated = false;
 #if defined(USE_SIGNATURE)
@@ -806,11 +815,21 @@ static void backupAndResetConfigs(const bool useCustomDefaults)
 
 static uint8_t getPidProfileIndexToUse()
 {
+#ifdef USE_CLI_BATCH
+    if (pidProfileIndexToUse == CURRENT_PROFILE_INDEX && commandBatchPidProfileIndex != CURRENT_PROFILE_INDEX) {
+        return commandBatchPidProfileIndex;
+    }
+#endif
     return pidProfileIndexToUse == CURRENT_PROFILE_INDEX ? getCurrentPidProfileIndex() : pidProfileIndexToUse;
 }
 
 static uint8_t getRateProfileIndexToUse()
 {
+#ifdef USE_CLI_BATCH
+    if (rateProfileIndexToUse == CURRENT_PROFILE_INDEX && commandBatchRateProfileIndex != CURRENT_PROFILE_INDEX) {
+        return commandBatchRateProfileIndex;
+    }
+#endif
     return rateProfileIndexToUse == CURRENT_PROFILE_INDEX ? getCurrentControlRateProfileIndex() : rateProfileIndexToUse;
 }
 
@@ -2682,6 +2701,14 @@ static void cliFlashInfo(const char *cmdName, char *cmdline)
             FLASH_PARTITION_SECTOR_COUNT(flashPartition) * layout->sectorSize,
             flashfsGetOffset()
     );
+
+    if (flashfsHasLogIndex()) {
+        cliPrintLinef("Logs: %u", flashfsGetLogCount());
+        for (unsigned index = 0; index < flashfsGetLogCount(); index++) {
+            const flashfsLog_t *log = flashfsGetLog(index);
+            cliPrintLinef("  %u: start=%u, size=%u", log->number, log->start, log->end - log->start);
+        }
+    }
 #endif
 }
 
@@ -4102,7 +4129,14 @@ static void cliProfile(const char *cmdName, char *cmdline)
     } else {
         const int i = atoi(cmdline);
         if (i >= 0 && i < PID_PROFILE_COUNT) {
-            changePidProfile(i);
+#ifdef USE_CLI_BATCH
+            if (commandBatchActive) {
+                commandBatchPidProfileIndex = i;
+            } else
+#endif
+            {
+                changePidProfile(i);
+            }
             cliProfile(cmdName, "");
         } else {
             cliPrintErrorLinef(cmdName, "PROFILE OUTSIDE OF [0..%d]", PID_PROFILE_COUNT - 1);
@@ -4118,7 +4152,14 @@ static void cliRateProfile(const char *cmdName, char *cmdline)
     } else {
         const int i = atoi(cmdline);
         if (i >= 0 && i < CONTROL_RATE_PROFILE_COUNT) {
-            changeControlRateProfile(i);
+#ifdef USE_CLI_BATCH
+            if (commandBatchActive) {
+                commandBatchRateProfileIndex = i;
+            } else
+#endif
+            {
+                changeControlRateProfile(i);
+            }
             cliRateProfile(cmdName, "");
         } else {
             cliPrintErrorLinef(cmdName, "RATE PROFILE OUTSIDE OF [0..%d]", CONTROL_RATE_PROFILE_COUNT - 1);
@@ -4173,8 +4214,22 @@ static void cliPrintCommandBatchWarning(const char *cmdName, const char *warning
     }
 }
 
+static void applyCommandBatchProfiles(void)
+{
+    if (commandBatchPidProfileIndex != CURRENT_PROFILE_INDEX) {
+        changePidProfile(commandBatchPidProfileIndex);
+        commandBatchPidProfileIndex = CURRENT_PROFILE_INDEX;
+    }
+    if (commandBatchRateProfileIndex != CURRENT_PROFILE_INDEX) {
+        changeControlRateProfile(commandBatchRateProfileIndex);
+        commandBatchRateProfileIndex = CURRENT_PROFILE_INDEX;
+    }
+}
+
 static void resetCommandBatch(void)
 {
+    applyCommandBatchProfiles();
+
     commandBatchActive = false;
     commandBatchError = false;
 }
@@ -4212,6 +4267,8 @@ static bool prepareSave(void)
     if (commandBatchActive && commandBatchError) {
         return false;
     }
+
+    applyCommandBatchProfiles();
 #endif
 
 #if defined(USE_BOARD_INFO)
@@ -4472,13 +4529,44 @@ static uint8_t getWordLength(char *bufBegin, char *bufEnd)
     return bufEnd - bufBegin;
 }
 
+static uint8_t cliSettingNameHash(const char *name, uint8_t length)
+{
+    uint32_t hash = 2166136261U;
+
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ tolower((unsigned char)name[i])) * 16777619U;
+    }
+
+    return (hash ^ (hash >> 8) ^ (hash >> 16) ^ (hash >> 24)) & (VALUE_TABLE_HASH_BUCKETS - 1);
+}
+
+static void cliBuildSettingIndex(void)
+{
+    for (int i = 0; i < VALUE_TABLE_HASH_BUCKETS; i++) {
+        valueTableHashHead[i] = valueTableEntryCount;
+    }
+
+    // Insert backwards so that each chain is in table order
+    for (int i = valueTableEntryCount - 1; i >= 0; i--) {
+        const uint8_t hash = cliSettingNameHash(valueTable[i].name, strlen(valueTable[i].name));
+        valueTableHashNext[i] = valueTableHashHead[hash];
+        valueTableHashHead[hash] = i;
+    }
+
+    valueTableHashValid = true;
+}
+
 uint16_t cliGetSettingIndex(char *name, uint8_t length)
 {
-    for (uint32_t i = 0; i < valueTableEntryCount; i++) {
+    if (!valueTableHashValid) {
+        cliBuildSettingIndex();
+    }
+
+    for (uint16_t i = valueTableHashHead[cliSettingNameHash(name, length)]; i < valueTableEntryCount; i = valueTableHashNext[i]) {
         const char *settingName = valueTable[i].name;
 
         // ensure exact match when setting to prevent setting variables with shorter names
-        if (strncasecmp(name, settingName, strlen(settingName)) == 0 && length == strlen(settingName)) {
+        if (length == strlen(settingName) && strncasecmp(name, settingName, length) == 0) {
             return i;
         }
     }
@@ -4662,6 +4750,12 @@ STATIC_UNIT_TESTED void cliSet(const char *cmdName, char *cmdline)
         }
 
         if (valueChanged) {
+#ifdef USE_CLI_BATCH
+            // Only errors are reported inside a batch
+            if (commandBatchActive) {
+                return;
+            }
+#endif
             cliPrintf("%s set to ", val->name);
             cliPrintVar(cmdName, val, 0);
         } else {
@@ -4793,6 +4887,29 @@ static void cliStatus(const char *cmdName, char *cmdline)
     cliPrintLinefeed();
 #endif /* USE_SENSOR_NAMES */
 
+    // Boot stage timing
+    cliPrint("Boot time:");
+    timeUs_t bootStageStartUs = 0;
+    for (bootStage_e stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+        const timeUs_t bootStageEndUs = bootStageTimeUs(stage);
+        if (bootStageEndUs) {
+            cliPrintf(" %s=%dms", bootStageName(stage), (int)(bootStageEndUs - bootStageStartUs) / 1000);
+            bootStageStartUs = bootStageEndUs;
+        }
+    }
+    cliPrintf(", total=%dms", (int)bootStageStartUs / 1000);
+    const uint32_t skippedSensors = sensorsProbeSkipped();
+    if (skippedSensors) {
+        cliPrint(", not probed:");
+        if (skippedSensors & SENSOR_BARO) {
+            cliPrint(" BARO");
+        }
+        if (skippedSensors & SENSOR_MAG) {
+            cliPrint(" MAG");
+        }
+    }
+    cliPrintLinefeed();
+
 #if defined(USE_OSD)
     osdDisplayPortDevice_e displayPortDeviceType;
     osdGetDisplayPort(&displayPortDeviceType);
@@ -4852,6 +4969,37 @@ static void cliStatus(const char *cmdName, char *cmdline)
     cliPrintLinefeed();
 }
 
+#ifdef USE_SPI
+static void cliSpi(const char *cmdName, char *cmdline)
+{
+    UNUSED(cmdName);
+
+    if (strcasecmp(cmdline, "reset") == 0) {
+        spiResetBusStats();
+        cliPrintLine("SPI statistics reset");
+        return;
+    }
+
+    const uint32_t cyclesPerUs = clockMicrosToCycles(1);
+
+    for (int device = 0; device < SPIDEV_COUNT; device++) {
+        const busStats_t *stats = spiGetBusStats(device);
+        if (!stats) {
+            continue;
+        }
+
+        const uint32_t elapsedUs = cmpTimeUs(micros(), stats->resetTimeUs);
+        const uint32_t busyUs = stats->busyCycles / cyclesPerUs;
+        const uint32_t busyPermille = elapsedUs ? (uint64_t)busyUs * 1000 / elapsedUs : 0;
+        const uint32_t waitAvgUs = stats->queued ? stats->waitCycles / cyclesPerUs / stats->queued : 0;
+
+        cliPrintLinef("SPI%d: busy %d.%d%%, transfers %u, queued %u, wait avg %uus max %uus, preempted %u",
+            SPI_DEV_TO_CFG(device), busyPermille / 10, busyPermille % 10, stats->transfers, stats->queued,
+            waitAvgUs, stats->waitMaxCycles / cyclesPerUs, stats->preemptions);
+    }
+}
+#endif
+
 static void cliTasks(const char *cmdName, char *cmdline)
 {
     UNUSED(cmdName);
@@ -4954,6 +5102,8 @@ static void cliSetpointInfo(const char *cmdName, char *cmdline)
     cliPrint("# Detected RX frame rate: ");
     if (rxIsReceivingSignal()) {
         cliPrintLinef("%d.%03dms", avgRxFrameUs / 1000, avgRxFrameUs % 1000);
+        const uint16_t latencyUs = lrintf(setpointGetLatency());
+        cliPrintLinef("# RX to PID latency: %d.%03dms", latencyUs / 1000, latencyUs % 1000);
     } else {
         cliPrintLine("NO SIGNAL");
     }
@@ -6519,6 +6669,9 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("set", "change setting", "[<name>=<value>]", cliSet),
 #if defined(USE_SIGNATURE)
     CLI_COMMAND_DEF("signature", "get / set the board type signature", "[signature]", cliSignature),
+#endif
+#ifdef USE_SPI
+    CLI_COMMAND_DEF("spi", "show SPI bus statistics", "[reset]", cliSpi),
 #endif
     CLI_COMMAND_DEF("status", "show status", NULL, cliStatus),
     CLI_COMMAND_DEF("tasks", "show task stats", NULL, cliTasks),
@@ -6767,6 +6920,9 @@ void cliEnter(serialPort_t *serialPort)
     bufWriterInit(&cliWriterDesc, cliWriteBuffer, sizeof(cliWriteBuffer), (bufWrite_t)serialWriteBufShim, serialPort);
     cliErrorWriter = cliWriter = &cliWriterDesc;
 
+    // The CLI uses the PG copies a pending snapshot write is staged in
+    configSnapshotCancel();
+
 #ifndef MINIMAL_CLI
     cliPrintLine("\r\nEntering CLI Mode, type 'exit' to return, or 'help'");
 #else
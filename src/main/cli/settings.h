@@ -131,6 +131,7 @@ typedef enum {
     TABLE_CRSF_ATT_REUSE,
     TABLE_CRSF_GPS_REUSE,
     TABLE_CRSF_GPS_SATS_REUSE,
+    TABLE_CRSF_TELEMETRY_MODE,
     TABLE_DTERM_MODE,
 
     LOOKUP_TABLE_COUNT
@@ -224,6 +225,11 @@ extern const lookupTableEntry_t lookupTables[];
 extern const uint16_t valueTableEntryCount;
 
 extern const clivalue_t valueTable[];
+
+// Hash chains over valueTable names, built by the CLI on first lookup
+#define VALUE_TABLE_HASH_BUCKETS 256
+extern uint16_t valueTableHashHead[VALUE_TABLE_HASH_BUCKETS];
+extern uint16_t valueTableHashNext[];
 //extern const uint8_t lookupTablesEntryCount;
 
 extern const char * const lookupTableGyroHardware[];
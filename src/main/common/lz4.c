@@ -0,0 +1,161 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LZ4
+
+#include "common/maths.h"
+
+#include "lz4.h"
+
+#define LZ4_MIN_MATCH           4
+#define LZ4_LAST_LITERALS       5
+#define LZ4_MF_LIMIT            12
+#define LZ4_SKIP_TRIGGER        6
+
+static inline uint32_t lz4Read32(const uint8_t *ptr)
+{
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static inline uint32_t lz4Hash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+static uint8_t *lz4WriteLength(uint8_t *op, unsigned length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = length;
+
+    return op;
+}
+
+/*
+ * Compress inBuf into a single LZ4 block.
+ *
+ * Returns the number of bytes written to outBuf, or -1 if the input
+ * is too large or the compressed block does not fit in outBuf.
+ */
+int lz4CompressBlock(lz4State_t *state, uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen)
+{
+    const uint8_t *ip = inBuf;
+    const uint8_t *anchor = inBuf;
+    const uint8_t * const iend = inBuf + inLen;
+    const uint8_t * const mflimit = iend - LZ4_MF_LIMIT;
+    const uint8_t * const matchlimit = iend - LZ4_LAST_LITERALS;
+
+    uint8_t *op = outBuf;
+    const uint8_t * const oend = outBuf + outBufLen;
+
+    if (inLen < 0 || inLen > LZ4_MAX_INPUT_SIZE) {
+        return -1;
+    }
+
+    if (inLen > LZ4_MF_LIMIT) {
+        // Stale entries are harmless; every candidate is verified before use
+        memset(state->hashTable, 0, sizeof(state->hashTable));
+
+        ip++;
+
+        while (ip < mflimit) {
+            const uint32_t sequence = lz4Read32(ip);
+            const uint32_t hash = lz4Hash(sequence);
+            const uint8_t *match = inBuf + state->hashTable[hash];
+
+            state->hashTable[hash] = ip - inBuf;
+
+            if (lz4Read32(match) != sequence) {
+                // Step faster through incompressible data
+                ip += 1 + ((ip - anchor) >> LZ4_SKIP_TRIGGER);
+                continue;
+            }
+
+            // Extend the match backwards into pending literals
+            while (ip > anchor && match > inBuf && ip[-1] == match[-1]) {
+                ip--;
+                match--;
+            }
+
+            // Extend the match forwards
+            const uint8_t *matchEnd = ip + LZ4_MIN_MATCH;
+            const uint8_t *ref = match + LZ4_MIN_MATCH;
+            while (matchEnd < matchlimit && *matchEnd == *ref) {
+                matchEnd++;
+                ref++;
+            }
+
+            const unsigned literalLen = ip - anchor;
+            const unsigned matchLen = matchEnd - ip - LZ4_MIN_MATCH;
+            const unsigned offset = ip - match;
+
+            if (op + 1 + literalLen / 255 + 1 + literalLen + 2 + matchLen / 255 + 1 > oend) {
+                return -1;
+            }
+
+            uint8_t *token = op++;
+            *token = (MIN(literalLen, 15U) << 4) | MIN(matchLen, 15U);
+
+            if (literalLen >= 15) {
+                op = lz4WriteLength(op, literalLen - 15);
+            }
+            memcpy(op, anchor, literalLen);
+            op += literalLen;
+
+            *op++ = offset & 0xff;
+            *op++ = offset >> 8;
+
+            if (matchLen >= 15) {
+                op = lz4WriteLength(op, matchLen - 15);
+            }
+
+            // Seed the table with the tail of the match
+            state->hashTable[lz4Hash(lz4Read32(matchEnd - 2))] = matchEnd - 2 - inBuf;
+
+            ip = anchor = matchEnd;
+        }
+    }
+
+    // Final literals
+    const unsigned literalLen = iend - anchor;
+
+    if (op + 1 + literalLen / 255 + 1 + literalLen > oend) {
+        return -1;
+    }
+
+    *op++ = MIN(literalLen, 15U) << 4;
+    if (literalLen >= 15) {
+        op = lz4WriteLength(op, literalLen - 15);
+    }
+    memcpy(op, anchor, literalLen);
+    op += literalLen;
+
+    return op - outBuf;
+}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * LZ4 block format compressor.
+ *
+ * The output is a raw LZ4 block (no frame header), which can be decoded
+ * on the host with any standard LZ4 block decoder. Input blocks are
+ * limited to 64kB so that all match offsets fit the 16-bit format.
+ */
+
+#define LZ4_HASH_LOG            10
+#define LZ4_HASH_TABLE_SIZE     (1 << LZ4_HASH_LOG)
+#define LZ4_MAX_INPUT_SIZE      65535
+
+// Worst case output size for incompressible input
+#define LZ4_COMPRESS_BOUND(len) ((len) + (len) / 255 + 16)
+
+typedef struct lz4State_s {
+    uint16_t    hashTable[LZ4_HASH_TABLE_SIZE];
+} lz4State_t;
+
+int lz4CompressBlock(lz4State_t *state, uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen);
@@ -748,6 +748,20 @@ bool readEEPROM(void)
     return success;
 }
 
+// Validates and applies a config that was written to the PGs directly
+void activateNewConfig(void)
+{
+    suspendRxSignal();
+
+    featureInit();
+
+    validateAndFixConfig();
+
+    activateConfig();
+
+    resumeRxSignal();
+}
+
 void writeUnmodifiedConfigToEEPROM(void)
 {
     validateAndFixConfig();
@@ -821,6 +835,9 @@ void saveConfigAndNotify(void)
 void setConfigDirty(void)
 {
     configIsDirty = true;
+#ifdef USE_CONFIG_JOURNAL_TASK
+    configJournalRequest();
+#endif
 }
 
 bool isConfigDirty(void)
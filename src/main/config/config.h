@@ -64,6 +64,7 @@ extern struct pidProfile_s *currentPidProfile;
 void initEEPROM(void);
 bool resetEEPROM(bool useCustomDefaults);
 bool readEEPROM(void);
+void activateNewConfig(void);
 void writeEEPROM(void);
 void writeEEPROMDelayed(int delayUs);
 void writeUnmodifiedConfigToEEPROM(void);
@@ -49,6 +49,7 @@ typedef enum {
 } configRecordFlags_e;
 
 #define CR_CLASSIFICATION_MASK  (0x3)
+#define CR_JOURNAL_ENTRY        (0x80)
 #define CRC_START_VALUE         0xFFFF
 #define CRC_CHECK_VALUE         0x1D0F  // pre-calculated value of CRC that includes the CRC itself
 
@@ -83,6 +84,53 @@ typedef struct {
     uint32_t word;
 } PG_PACKED packingTest_t;
 
+#ifdef USE_CONFIG_JOURNAL
+/*
+ * Config journal
+ *
+ * Saves append the changed PGs after the full config image instead of
+ * erasing and rewriting the whole sector. Each entry is a config record
+ * followed by a CRC that is seeded with the CRC of the full image, so
+ * entries left over from an older image never validate. The last valid
+ * entry of a PG overrides the record in the image. When the sector is
+ * full the config is compacted by a normal full write.
+ */
+
+// Bytes programmed per configJournalProcess() call
+#define CONFIG_JOURNAL_STEP_SIZE    32
+
+// Largest PG that can be journaled in flight, which must fit the snapshot
+#define CONFIG_JOURNAL_SNAPSHOT_SIZE 2048
+
+typedef struct {
+    const uint8_t *start;   // first entry
+    const uint8_t *end;     // end of the last valid entry
+    uint16_t seed;          // CRC of the full image
+    bool clean;             // flash after the last entry is erased
+} configJournal_t;
+
+typedef struct {
+    const pgRegistry_t *reg;
+    const uint8_t *data;    // PG contents being written
+    uint8_t header[sizeof(configRecord_t)];
+    uint16_t size;
+    uint16_t pos;
+    uint16_t crc;
+    uint32_t hash;
+    config_streamer_t streamer;
+} configJournalWriter_t;
+
+static configJournal_t journal;
+static configJournalWriter_t journalWriter;
+
+#ifdef USE_CONFIG_JOURNAL_TASK
+// Copy of the PG being journaled in flight, so that changes made meanwhile
+// cannot tear the entry. They are journaled as the next entry instead.
+static uint8_t journalSnapshot[CONFIG_JOURNAL_SNAPSHOT_SIZE];
+static bool journalPending;
+#endif
+#endif
+
 #if defined(CONFIG_IN_EXTERNAL_FLASH)
 bool loadEEPROMFromExternalFlash(void)
 {
@@ -320,7 +368,7 @@ bool isEEPROMStructureValid(void)
     // include stored CRC in the CRC calculation
     const uint16_t *storedCrc = (const uint16_t *)p;
     crc = crc16_ccitt_update(crc, storedCrc, sizeof(*storedCrc));
-    p += sizeof(storedCrc);
+    p += sizeof(*storedCrc);
 
     eepromConfigSize = p - &__config_start;
 
@@ -369,6 +417,250 @@ static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFla
     return NULL;
 }
 
+#ifdef USE_CONFIG_JOURNAL
+static const uint8_t *journalAlign(const uint8_t *p)
+{
+    const uintptr_t offset = p - &__config_start;
+    return &__config_start + (offset + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE;
+}
+
+static const configRecord_t *journalEntry(const uint8_t *p)
+{
+    const configRecord_t *record = (const configRecord_t *)p;
+
+    if (p + sizeof(*record) + sizeof(uint16_t) > &__config_end
+        || record->size < sizeof(*record)
+        || p + record->size + sizeof(uint16_t) > &__config_end
+        || !(record->flags & CR_JOURNAL_ENTRY))
+        return NULL;
+
+    const uint16_t crc = crc16_ccitt_update(journal.seed, p, record->size);
+    const uint16_t storedCrc = p[record->size] | (p[record->size + 1] << 8);
+
+    return (crc == storedCrc) ? record : NULL;
+}
+
+static const uint8_t *journalEntryNext(const uint8_t *p)
+{
+    const configRecord_t *record = (const configRecord_t *)p;
+    return journalAlign(p + record->size + sizeof(uint16_t));
+}
+
+// Locate the journal behind the full image. Assumes the image is valid.
+static void journalScan(void)
+{
+    const uint8_t *p = &__config_start + sizeof(configHeader_t);
+
+    while (true) {
+        const configRecord_t *record = (const configRecord_t *)p;
+        if (record->size == 0
+            || p + record->size >= &__config_end
+            || record->size < sizeof(*record))
+            break;
+        p += record->size;
+    }
+
+    p += sizeof(configFooter_t) + sizeof(uint16_t);
+
+    journal.seed = p[-2] | (p[-1] << 8);
+    journal.start = journalAlign(p);
+
+    p = journal.start;
+    while (journalEntry(p)) {
+        p = journalEntryNext(p);
+    }
+
+    journal.end = p;
+    journal.clean = (p < &__config_end);
+
+    for (int i = 0; i < CONFIG_STREAMER_BUFFER_SIZE && p + i < &__config_end; i++) {
+        if (p[i] != 0xFF) {
+            journal.clean = false;
+        }
+    }
+}
+
+// Find the most recent journal entry for the PG
+static const configRecord_t *findJournal(const pgRegistry_t *reg, configRecordFlags_e classification, const configRecord_t *found)
+{
+    for (const uint8_t *p = journal.start; p < journal.end; p = journalEntryNext(p)) {
+        const configRecord_t *record = (const configRecord_t *)p;
+        if (pgN(reg) == record->pgn
+            && (record->flags & CR_CLASSIFICATION_MASK) == classification)
+            found = record;
+    }
+    return found;
+}
+
+static int journalEntrySize(const pgRegistry_t *reg)
+{
+    const int size = sizeof(configRecord_t) + pgSize(reg) + sizeof(uint16_t);
+    return (size + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE;
+}
+
+// Start an entry for the PG, written from `data` which must stay unchanged until it is complete
+static bool journalBegin(const pgRegistry_t *reg, const uint8_t *data)
+{
+    if (!journal.clean || journal.end + journalEntrySize(reg) > &__config_end) {
+        return false;
+    }
+
+    memset(&journalWriter, 0, sizeof(journalWriter));
+
+    configRecord_t *record = (configRecord_t *)journalWriter.header;
+    record->size = sizeof(configRecord_t) + pgSize(reg);
+    record->pgn = pgN(reg);
+    record->version = pgVersion(reg);
+    record->flags = CR_CLASSICATION_SYSTEM | CR_JOURNAL_ENTRY;
+
+    journalWriter.reg = reg;
+    journalWriter.data = data;
+    journalWriter.size = record->size;
+    journalWriter.crc = journal.seed;
+    journalWriter.hash = fnv_update(FNV_OFFSET_BASIS, data, pgSize(reg));
+
+    config_streamer_init(&journalWriter.streamer);
+    journalWriter.streamer.address = (uintptr_t)journal.end;
+
+    return true;
+}
+
+// Program up to `budget` bytes of the current entry
+static bool journalStep(int budget)
+{
+    configJournalWriter_t *w = &journalWriter;
+    const uint16_t total = w->size + sizeof(uint16_t);
+
+    config_streamer_start(&w->streamer, w->streamer.address, &__config_end - (uint8_t *)w->streamer.address);
+
+    for (; budget > 0 && w->pos < total; budget--, w->pos++) {
+        uint8_t byte;
+
+        if (w->pos < sizeof(configRecord_t)) {
+            byte = w->header[w->pos];
+        } else if (w->pos < w->size) {
+            byte = w->data[w->pos - sizeof(configRecord_t)];
+        } else if (w->pos == w->size) {
+            byte = w->crc & 0xFF;
+        } else {
+            byte = w->crc >> 8;
+        }
+
+        if (w->pos < w->size) {
+            w->crc = crc16_ccitt(w->crc, byte);
+        }
+
+        config_streamer_write(&w->streamer, &byte, 1);
+    }
+
+    if (w->pos == total) {
+        config_streamer_flush(&w->streamer);
+    }
+
+    if (config_streamer_finish(&w->streamer) != 0) {
+        // A broken entry ends the journal; the next save compacts
+        journal.clean = false;
+        w->reg = NULL;
+        return false;
+    }
+
+    if (w->pos == total) {
+        *w->reg->fnv_hash = w->hash;
+        journal.end = (const uint8_t *)w->streamer.address;
+        w->reg = NULL;
+    }
+
+    return true;
+}
+
+static bool journalComplete(void)
+{
+    while (journalWriter.reg) {
+        if (!journalStep(INT16_MAX)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Append all changed PGs. Returns false if a full write is needed instead.
+static bool journalWriteChanges(void)
+{
+    if (!journalComplete()) {
+        return false;
+    }
+
+    journalScan();
+
+    int required = 0;
+    PG_FOREACH(reg) {
+        if (*reg->fnv_hash != fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg))) {
+            required += journalEntrySize(reg);
+        }
+    }
+
+    if (required == 0) {
+        return true;
+    }
+    if (!journal.clean || journal.end + required > &__config_end) {
+        return false;
+    }
+
+    PG_FOREACH(reg) {
+        if (*reg->fnv_hash != fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg))) {
+            // Written in one go, so the live PG cannot change underneath
+            if (!journalBegin(reg, reg->address) || !journalComplete()) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+#ifdef USE_CONFIG_JOURNAL_TASK
+// Called when the config is changed, to journal it in flight
+void configJournalRequest(void)
+{
+    journalPending = true;
+}
+
+/*
+ * Incremental save, called periodically while armed with a dirty config.
+ * Programs one small step of an entry per call so that the flash stalls
+ * stay short. The PGs are only compared again after the next change is
+ * requested. Gives up quietly when the journal is full; the config is then
+ * compacted by the next full save.
+ */
+void configJournalProcess(void)
+{
+    if (!journalWriter.reg) {
+        if (!journalPending) {
+            return;
+        }
+        journalPending = false;
+
+        PG_FOREACH(reg) {
+            if (pgSize(reg) <= sizeof(journalSnapshot) &&
+                *reg->fnv_hash != fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg))) {
+                memcpy(journalSnapshot, reg->address, pgSize(reg));
+                if (!journalBegin(reg, journalSnapshot)) {
+                    return;
+                }
+                // Look for more changed PGs once this one is written
+                journalPending = true;
+                break;
+            }
+        }
+    }
+
+    if (journalWriter.reg) {
+        journalStep(CONFIG_JOURNAL_STEP_SIZE);
+    }
+}
+#endif
+#endif
+
 // Initialize all PG records from EEPROM.
 // This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
 //   but each PG is loaded/initialized exactly once and in defined order.
@@ -376,8 +668,16 @@ bool loadEEPROM(void)
 {
     bool success = true;
 
+#ifdef USE_CONFIG_JOURNAL
+    journalWriter.reg = NULL;
+    journalScan();
+#endif
+
     PG_FOREACH(reg) {
         const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+#ifdef USE_CONFIG_JOURNAL
+        rec = findJournal(reg, CR_CLASSICATION_SYSTEM, rec);
+#endif
         if (rec) {
             // config from EEPROM is available, use it to initialize PG. pgLoad will handle version mismatch
             if (!pgLoad(reg, rec->pg, rec->size - offsetof(configRecord_t, pg), rec->version)) {
@@ -398,6 +698,13 @@ static bool writeSettingsToEEPROM(void)
 {
     bool dirtyConfig = !isEEPROMVersionValid() || !isEEPROMStructureValid();
 
+#ifdef USE_CONFIG_JOURNAL
+    if (!dirtyConfig && journalWriteChanges()) {
+        return true;
+    }
+    journalWriter.reg = NULL;
+#endif
+
     configHeader_t header = {
         .eepromConfigVersion =  EEPROM_CONF_VERSION,
         .magic_be =             0xBE,
@@ -434,6 +741,7 @@ static bool writeSettingsToEEPROM(void)
             crc = crc16_ccitt_update(crc, (uint8_t *)&record, sizeof(record));
             config_streamer_write(&streamer, reg->address, regSize);
             crc = crc16_ccitt_update(crc, reg->address, regSize);
+            *reg->fnv_hash = fnv_update(FNV_OFFSET_BASIS, reg->address, regSize);
         }
 
         configFooter_t footer = {
@@ -476,6 +784,9 @@ void writeConfigToEEPROM(void)
 
 
     if (success && isEEPROMVersionValid() && isEEPROMStructureValid()) {
+#ifdef USE_CONFIG_JOURNAL
+        journalScan();
+#endif
         return;
     }
 
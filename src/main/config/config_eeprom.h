@@ -29,6 +29,8 @@ bool isEEPROMVersionValid(void);
 bool isEEPROMStructureValid(void);
 bool loadEEPROM(void);
 void writeConfigToEEPROM(void);
+void configJournalRequest(void);
+void configJournalProcess(void);
 
 uint16_t getEEPROMConfigSize(void);
 size_t getEEPROMStorageSize(void);
@@ -0,0 +1,341 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/crc.h"
+#include "common/maths.h"
+#include "common/streambuf.h"
+
+#include "config/config.h"
+#include "config/config_eeprom.h"
+#include "config/config_snapshot.h"
+
+#include "pg/pg.h"
+
+#define SNAPSHOT_TERMINATOR     0xFFFF
+
+// Equal bytes between two differences that are still sent in one run
+#define SNAPSHOT_RUN_GAP        ((int)sizeof(snapshotRecord_t))
+
+typedef struct {
+    uint8_t format;
+    uint8_t eepromVersion;
+    uint8_t flags;
+    uint8_t reserved;
+} PG_PACKED snapshotHeader_t;
+
+typedef struct {
+    uint16_t pgn;
+    uint8_t version;
+    uint16_t offset;
+    uint16_t length;
+} PG_PACKED snapshotRecord_t;
+
+typedef struct {
+    sbuf_t *dst;
+    uint32_t pos;
+    uint32_t start;
+    uint32_t end;
+    uint16_t crc;
+} snapshotStream_t;
+
+typedef enum {
+    SNAPSHOT_STATE_HEADER = 0,
+    SNAPSHOT_STATE_RECORD,
+    SNAPSHOT_STATE_DATA,
+    SNAPSHOT_STATE_CRC,
+    SNAPSHOT_STATE_DONE,
+} snapshotState_e;
+
+typedef struct {
+    bool active;
+    snapshotState_e state;
+    uint32_t offset;
+    uint16_t crc;
+    uint8_t buf[sizeof(snapshotRecord_t)];
+    uint8_t bufLen;
+    const pgRegistry_t *reg;
+    uint16_t dataOffset;
+    uint16_t dataRemaining;
+    uint8_t skipped;
+} snapshotWriter_t;
+
+static snapshotWriter_t writer;
+
+
+/*
+ * Reading
+ *
+ * The snapshot is generated from the live config on every request and only
+ * the requested window is copied out, so no buffer for the whole blob is needed.
+ */
+
+static void snapshotEmit(snapshotStream_t *s, const void *data, uint32_t len)
+{
+    const uint8_t *ptr = data;
+
+    if (s->pos < s->end && s->pos + len > s->start) {
+        const uint32_t from = MAX(s->pos, s->start);
+        const uint32_t to = MIN(s->pos + len, s->end);
+        sbufWriteData(s->dst, ptr + (from - s->pos), to - from);
+    }
+
+    s->crc = crc16_ccitt_update(s->crc, data, len);
+    s->pos += len;
+}
+
+static void snapshotEmitRecord(snapshotStream_t *s, const pgRegistry_t *reg, uint16_t offset, uint16_t length)
+{
+    const snapshotRecord_t record = {
+        .pgn = pgN(reg),
+        .version = pgVersion(reg),
+        .offset = offset,
+        .length = length,
+    };
+
+    snapshotEmit(s, &record, sizeof(record));
+    snapshotEmit(s, reg->address + offset, length);
+}
+
+static void snapshotEmitDiff(snapshotStream_t *s, const pgRegistry_t *reg)
+{
+    const uint16_t size = pgSize(reg);
+    const uint8_t *live = reg->address;
+    const uint8_t *defaults = reg->copy;
+
+    pgResetInstance(reg, reg->copy);
+
+    uint16_t index = 0;
+    while (index < size) {
+        if (live[index] == defaults[index]) {
+            index++;
+            continue;
+        }
+
+        const uint16_t start = index;
+        uint16_t last = index;
+
+        while (++index < size && index - last <= SNAPSHOT_RUN_GAP) {
+            if (live[index] != defaults[index]) {
+                last = index;
+            }
+        }
+
+        snapshotEmitRecord(s, reg, start, last - start + 1);
+        index = last + 1;
+    }
+}
+
+// Returns true when the window reaches the end of the snapshot
+bool configSnapshotRead(uint8_t flags, uint32_t offset, int length, sbuf_t *dst)
+{
+    // Diffs use the PG copies as scratch space
+    writer.active = false;
+
+    snapshotStream_t stream = {
+        .dst = dst,
+        .pos = 0,
+        .start = offset,
+        .end = offset + length,
+        .crc = 0xFFFF,
+    };
+
+    const snapshotHeader_t header = {
+        .format = CONFIG_SNAPSHOT_FORMAT,
+        .eepromVersion = EEPROM_CONF_VERSION,
+        .flags = flags & CONFIG_SNAPSHOT_DIFF,
+    };
+
+    snapshotEmit(&stream, &header, sizeof(header));
+
+    PG_FOREACH(reg) {
+        if (stream.pos >= stream.end) {
+            return false;
+        }
+        if (flags & CONFIG_SNAPSHOT_DIFF) {
+            snapshotEmitDiff(&stream, reg);
+        } else {
+            snapshotEmitRecord(&stream, reg, 0, pgSize(reg));
+        }
+    }
+
+    const uint16_t terminator = SNAPSHOT_TERMINATOR;
+    snapshotEmit(&stream, &terminator, sizeof(terminator));
+
+    const uint16_t crc = stream.crc;
+    snapshotEmit(&stream, &crc, sizeof(crc));
+
+    return stream.pos <= stream.end;
+}
+
+
+/*
+ * Writing
+ *
+ * Chunks must arrive in order. Records are staged in the PG copies on top
+ * of the defaults and only committed to the live config once the CRC over
+ * the whole snapshot has been verified. Unknown PGs and PGs with another
+ * version keep their defaults, the same way loadEEPROM() treats them.
+ *
+ * The CLI uses the PG copies too, so entering the CLI cancels a pending write.
+ */
+
+static void snapshotWriterStart(void)
+{
+    memset(&writer, 0, sizeof(writer));
+
+    writer.active = true;
+    writer.crc = 0xFFFF;
+
+    PG_FOREACH(reg) {
+        pgResetInstance(reg, reg->copy);
+    }
+}
+
+static void snapshotWriterCommit(void)
+{
+    PG_FOREACH(reg) {
+        memcpy(reg->address, reg->copy, pgSize(reg));
+    }
+
+    activateNewConfig();
+}
+
+static bool snapshotWriterRecord(void)
+{
+    const snapshotRecord_t *record = (const snapshotRecord_t *)writer.buf;
+    const pgRegistry_t *reg = pgFind(record->pgn);
+
+    writer.reg = NULL;
+    writer.dataOffset = record->offset;
+    writer.dataRemaining = record->length;
+
+    if (reg && pgVersion(reg) == record->version) {
+        if (record->offset + record->length > pgSize(reg)) {
+            return false;
+        }
+        writer.reg = reg;
+    } else {
+        writer.skipped++;
+    }
+
+    writer.state = record->length ? SNAPSHOT_STATE_DATA : SNAPSHOT_STATE_RECORD;
+
+    return true;
+}
+
+static bool snapshotWriterProcess(uint8_t c)
+{
+    if (writer.state != SNAPSHOT_STATE_CRC) {
+        writer.crc = crc16_ccitt(writer.crc, c);
+    }
+
+    switch (writer.state) {
+    case SNAPSHOT_STATE_HEADER:
+        writer.buf[writer.bufLen++] = c;
+        if (writer.bufLen == sizeof(snapshotHeader_t)) {
+            const snapshotHeader_t *header = (const snapshotHeader_t *)writer.buf;
+            if (header->format != CONFIG_SNAPSHOT_FORMAT) {
+                return false;
+            }
+            writer.bufLen = 0;
+            writer.state = SNAPSHOT_STATE_RECORD;
+        }
+        break;
+
+    case SNAPSHOT_STATE_RECORD:
+        writer.buf[writer.bufLen++] = c;
+        if (writer.bufLen == sizeof(uint16_t) && ((const snapshotRecord_t *)writer.buf)->pgn == SNAPSHOT_TERMINATOR) {
+            writer.bufLen = 0;
+            writer.state = SNAPSHOT_STATE_CRC;
+        } else if (writer.bufLen == sizeof(snapshotRecord_t)) {
+            writer.bufLen = 0;
+            return snapshotWriterRecord();
+        }
+        break;
+
+    case SNAPSHOT_STATE_DATA:
+        if (writer.reg) {
+            writer.reg->copy[writer.dataOffset] = c;
+        }
+        writer.dataOffset++;
+        if (--writer.dataRemaining == 0) {
+            writer.state = SNAPSHOT_STATE_RECORD;
+        }
+        break;
+
+    case SNAPSHOT_STATE_CRC:
+        writer.buf[writer.bufLen++] = c;
+        if (writer.bufLen == sizeof(uint16_t)) {
+            const uint16_t crc = writer.buf[0] | (writer.buf[1] << 8);
+            if (crc != writer.crc) {
+                return false;
+            }
+            writer.state = SNAPSHOT_STATE_DONE;
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+configSnapshotStatus_e configSnapshotWrite(uint32_t offset, sbuf_t *src)
+{
+    if (offset == 0) {
+        snapshotWriterStart();
+    }
+
+    if (!writer.active || offset != writer.offset) {
+        writer.active = false;
+        return CONFIG_SNAPSHOT_FAILED;
+    }
+
+    while (sbufBytesRemaining(src)) {
+        if (!snapshotWriterProcess(sbufReadU8(src))) {
+            writer.active = false;
+            return CONFIG_SNAPSHOT_FAILED;
+        }
+        writer.offset++;
+    }
+
+    if (writer.state == SNAPSHOT_STATE_DONE) {
+        writer.active = false;
+        snapshotWriterCommit();
+        return CONFIG_SNAPSHOT_APPLIED;
+    }
+
+    return CONFIG_SNAPSHOT_PENDING;
+}
+
+uint8_t configSnapshotSkippedRecords(void)
+{
+    return writer.skipped;
+}
+
+void configSnapshotCancel(void)
+{
+    writer.active = false;
+}
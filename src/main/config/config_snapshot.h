@@ -0,0 +1,53 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "common/streambuf.h"
+
+/*
+ * Binary config snapshot
+ *
+ *   header:   u8 format, u8 eeprom version, u8 flags, u8 reserved
+ *   records:  u16 pgn, u8 pg version, u16 offset, u16 length, data[length]
+ *   trailer:  u16 0xFFFF, u16 crc16 ccitt of everything before it
+ *
+ * A full snapshot has one record per PG. A diff only has the byte runs
+ * that differ from the defaults. Both are applied on top of defaults.
+ */
+
+#define CONFIG_SNAPSHOT_FORMAT          1
+
+typedef enum {
+    CONFIG_SNAPSHOT_FULL = 0,
+    CONFIG_SNAPSHOT_DIFF = (1 << 0),
+} configSnapshotFlags_e;
+
+typedef enum {
+    CONFIG_SNAPSHOT_PENDING = 0,
+    CONFIG_SNAPSHOT_APPLIED,
+    CONFIG_SNAPSHOT_FAILED,
+} configSnapshotStatus_e;
+
+bool configSnapshotRead(uint8_t flags, uint32_t offset, int length, sbuf_t *dst);
+configSnapshotStatus_e configSnapshotWrite(uint32_t offset, sbuf_t *src);
+uint8_t configSnapshotSkippedRecords(void);
+void configSnapshotCancel(void);
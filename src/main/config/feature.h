@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/utils.h"
+
 #include "pg/pg.h"
 
 #ifndef DEFAULT_FEATURES
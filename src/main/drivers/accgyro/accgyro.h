@@ -83,6 +83,9 @@ typedef enum {
     GYRO_RATE_32_kHz,
 } gyroRateKHz_e;
 
+// Maximum number of samples handled per FIFO burst
+#define GYRO_FIFO_MAX_FRAMES 8
+
 typedef enum {
     GYRO_EXTI_INIT = 0,
     GYRO_EXTI_INT_DMA,
@@ -114,7 +117,7 @@ typedef struct gyroDev_s {
     uint32_t gyroSyncEXTI;
     int32_t gyroShortPeriod;
     int32_t gyroDmaMaxDuration;
-    busSegment_t segments[2];
+    busSegment_t segments[3];
     volatile bool dataReady;
     bool gyro_high_fsr;
     bool gyro_rate_sync;
@@ -128,6 +131,13 @@ typedef struct gyroDev_s {
     uint16_t accSampleRateHz;
     uint8_t accDataReg;
     uint8_t gyroDataReg;
+#ifdef USE_GYRO_FIFO
+    uint8_t fifoFrames;                                      // samples per FIFO burst, 0 if FIFO mode is not used
+    uint8_t fifoCount;                                       // valid samples in the last burst
+    uint8_t *fifoBuf;                                        // DMA receive buffer for FIFO bursts
+    int16_t fifoGyroRaw[GYRO_FIFO_MAX_FRAMES][XYZ_AXIS_COUNT];
+    uint16_t fifoTimestamp[GYRO_FIFO_MAX_FRAMES];            // sensor time of each sample in us
+#endif
 } gyroDev_t;
 
 typedef struct accDev_s {
@@ -380,6 +380,9 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro, const gyro
 
     gyro->dev.busType_u.spi.csnPin = IOGetByTag(config->csnTag);
 
+    // Gyro reads take precedence over other devices sharing the bus
+    spiSetPriority(&gyro->dev, BUS_PRIORITY_HIGH);
+
     IOInit(gyro->dev.busType_u.spi.csnPin, OWNER_GYRO_CS, RESOURCE_INDEX(config->index));
     IOConfigGPIO(gyro->dev.busType_u.spi.csnPin, SPI_IO_CS_CFG);
     IOHi(gyro->dev.busType_u.spi.csnPin); // Ensure device is disabled, important when two devices are on the same bus.
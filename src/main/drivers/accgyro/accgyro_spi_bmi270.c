@@ -126,8 +126,7 @@ typedef enum {
     BMI270_VAL_FIFO_CONFIG_0 = 0x00,         // don't stop when full, disable sensortime frame
     BMI270_VAL_FIFO_CONFIG_1 = 0x80,         // only gyro data in FIFO, use headerless mode
     BMI270_VAL_FIFO_DOWNS = 0x00,            // select unfiltered gyro data with no downsampling (6.4KHz samples)
-    BMI270_VAL_FIFO_WTM_0 = 0x06,            // set the FIFO watermark level to 1 gyro sample (6 bytes)
-    BMI270_VAL_FIFO_WTM_1 = 0x00,            // FIFO watermark MSB
+    BMI270_VAL_FIFO_DOWNS_FILTERED = 0x08,   // select filtered gyro data at the gyro ODR
 } bmi270ConfigValues_e;
 
 // Need to see at least this many interrupts during initialisation to confirm EXTI connectivity
@@ -212,9 +211,18 @@ static void bmi270Config(gyroDev_t *gyro)
     // If running in hardware_lpf experimental mode then switch to FIFO-based,
     // 6.4KHz sampling, unfiltered data vs. the default 3.2KHz with hardware filtering
 #ifdef USE_GYRO_DLPF_EXPERIMENTAL
-    const bool fifoMode = (gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL);
+    const bool unfilteredMode = (gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL);
 #else
-    const bool fifoMode = false;
+    const bool unfilteredMode = false;
+#endif
+
+    // In FIFO burst mode the watermark is set to a full burst of gyro frames
+#ifdef USE_GYRO_FIFO
+    const unsigned fifoWatermark = MAX(gyro->fifoFrames, 1) * BMI270_FIFO_FRAME_SIZE;
+    const bool fifoMode = unfilteredMode || gyro->fifoFrames;
+#else
+    const unsigned fifoWatermark = BMI270_FIFO_FRAME_SIZE;
+    const bool fifoMode = unfilteredMode;
 #endif
 
     // Perform a soft reset to set all configuration to default
@@ -230,9 +238,9 @@ static void bmi270Config(gyroDev_t *gyro)
     if (fifoMode) {
         bmi270RegisterWrite(dev, BMI270_REG_FIFO_CONFIG_0, BMI270_VAL_FIFO_CONFIG_0, 1);
         bmi270RegisterWrite(dev, BMI270_REG_FIFO_CONFIG_1, BMI270_VAL_FIFO_CONFIG_1, 1);
-        bmi270RegisterWrite(dev, BMI270_REG_FIFO_DOWNS, BMI270_VAL_FIFO_DOWNS, 1);
-        bmi270RegisterWrite(dev, BMI270_REG_FIFO_WTM_0, BMI270_VAL_FIFO_WTM_0, 1);
-        bmi270RegisterWrite(dev, BMI270_REG_FIFO_WTM_1, BMI270_VAL_FIFO_WTM_1, 1);
+        bmi270RegisterWrite(dev, BMI270_REG_FIFO_DOWNS, unfilteredMode ? BMI270_VAL_FIFO_DOWNS : BMI270_VAL_FIFO_DOWNS_FILTERED, 1);
+        bmi270RegisterWrite(dev, BMI270_REG_FIFO_WTM_0, fifoWatermark & 0xFF, 1);
+        bmi270RegisterWrite(dev, BMI270_REG_FIFO_WTM_1, fifoWatermark >> 8, 1);
     }
 
     // Configure the accelerometer
@@ -328,8 +336,16 @@ static void bmi270IntExtiInit(gyroDev_t *gyro)
 static bool bmi270AccRead(accDev_t *acc)
 {
     extDevice_t *dev = &acc->gyro->dev;
+    gyroModeSPI_e gyroModeSPI = acc->gyro->gyroModeSPI;
+
+#ifdef USE_GYRO_FIFO
+    // FIFO bursts only carry gyro data, so the accelerometer is read separately
+    if (acc->gyro->fifoFrames && gyroModeSPI == GYRO_EXTI_INT_DMA) {
+        gyroModeSPI = GYRO_EXTI_INT;
+    }
+#endif
 
-    switch (acc->gyro->gyroModeSPI) {
+    switch (gyroModeSPI) {
     case GYRO_EXTI_INT:
     case GYRO_EXTI_NO_INT:
     {
@@ -512,8 +528,123 @@ static bool bmi270GyroReadFifo(gyroDev_t *gyro)
 }
 #endif
 
+#ifdef USE_GYRO_FIFO
+static bool bmi270GyroReadFifoBurst(gyroDev_t *gyro)
+{
+    enum {
+        IDX_SKIP = 0,
+        IDX_FIFO_LENGTH_L,
+        IDX_FIFO_LENGTH_H,
+        IDX_FIFO_DATA,
+    };
+
+    // FIFO bursts are only used with a single gyro
+    static uint32_t burstCycles;
+    static uint32_t burstTimeUs;
+    static uint16_t samplePeriodUs;
+
+    extDevice_t *dev = &gyro->dev;
+    const uint8_t *rxData = gyro->fifoBuf;
+
+    switch (gyro->gyroModeSPI) {
+    case GYRO_EXTI_INIT:
+    {
+        STATIC_DMA_DATA_AUTO uint8_t fifoReadCmd[1] = { BMI270_REG_FIFO_LENGTH_LSB | 0x80 };
+
+        // Burst read the FIFO length followed by fifoFrames headerless gyro frames
+        dev->callbackArg = (uint32_t)gyro;
+        gyro->segments[0].u.buffers.txData = fifoReadCmd;
+        gyro->segments[0].u.buffers.rxData = NULL;
+        gyro->segments[0].len = sizeof(fifoReadCmd);
+        gyro->segments[0].negateCS = false;
+        gyro->segments[0].callback = NULL;
+        gyro->segments[1].u.buffers.txData = NULL;
+        gyro->segments[1].u.buffers.rxData = gyro->fifoBuf;
+        gyro->segments[1].len = IDX_FIFO_DATA + gyro->fifoFrames * BMI270_FIFO_FRAME_SIZE;
+        gyro->segments[1].negateCS = true;
+        gyro->segments[1].callback = bmi270Intcallback;
+
+        samplePeriodUs = 1000000 / (gyro->gyroSampleRateHz * gyro->fifoFrames);
+
+        // We need some offset from the gyro interrupts to ensure sampling after the interrupt
+        gyro->gyroDmaMaxDuration = 5;
+        if (gyro->detectedEXTI > GYRO_EXTI_DETECT_THRESHOLD) {
+            if (spiUseDMA(dev)) {
+                gyro->gyroModeSPI = GYRO_EXTI_INT_DMA;
+            } else {
+                // Interrupts are present, but no DMA
+                gyro->gyroModeSPI = GYRO_EXTI_INT;
+            }
+        } else {
+            gyro->gyroModeSPI = GYRO_EXTI_NO_INT;
+        }
+        return false;
+    }
+
+    case GYRO_EXTI_INT:
+    case GYRO_EXTI_NO_INT:
+        spiSequence(dev, gyro->segments);
+
+        // Wait for completion
+        spiWait(dev);
+        break;
+
+    case GYRO_EXTI_INT_DMA:
+    default:
+        // If read was triggered in interrupt don't bother waiting. The worst that could happen is that we pick
+        // up an old burst.
+        break;
+    }
+
+    // The sensor has no timestamps in headerless mode, so the burst is timed by the
+    // watermark interrupt and the samples are spaced at the ODR period before it
+    const uint32_t nowCycles = (gyro->gyroModeSPI == GYRO_EXTI_NO_INT) ? getCycleCounter() : gyro->gyroLastEXTI;
+    const int32_t elapsedUs = clockCyclesToMicros(cmpTimeCycles(nowCycles, burstCycles));
+    burstTimeUs += elapsedUs;
+    burstCycles += clockMicrosToCycles(elapsedUs);
+
+    int fifoLength = (uint16_t)((rxData[IDX_FIFO_LENGTH_H] << 8) | rxData[IDX_FIFO_LENGTH_L]);
+    const unsigned frames = MIN(fifoLength / BMI270_FIFO_FRAME_SIZE, gyro->fifoFrames);
+    unsigned count = 0;
+
+    for (unsigned i = 0; i < frames; i++) {
+        const uint8_t *frame = &rxData[IDX_FIFO_DATA + i * BMI270_FIFO_FRAME_SIZE];
+        const int16_t gyroX = (int16_t)((frame[1] << 8) | frame[0]);
+        const int16_t gyroY = (int16_t)((frame[3] << 8) | frame[2]);
+        const int16_t gyroZ = (int16_t)((frame[5] << 8) | frame[4]);
+
+        // Invalid FIFO data reads back as 0x8000 (-32768) (pg. 43 of datasheet)
+        if ((gyroX != INT16_MIN) || (gyroY != INT16_MIN) || (gyroZ != INT16_MIN)) {
+            gyro->fifoGyroRaw[count][X] = gyroX;
+            gyro->fifoGyroRaw[count][Y] = gyroY;
+            gyro->fifoGyroRaw[count][Z] = gyroZ;
+            gyro->fifoTimestamp[count] = burstTimeUs - (frames - 1 - i) * samplePeriodUs;
+            count++;
+        }
+    }
+
+    gyro->fifoCount = count;
+    fifoLength -= frames * BMI270_FIFO_FRAME_SIZE;
+
+    // The watermark interrupt is level triggered, so a backlog of a full burst or more
+    // would hold the pin high and stop further interrupts. A partial frame would never
+    // be removed from the FIFO either. Flush the FIFO in both cases.
+    if (fifoLength >= gyro->fifoFrames * BMI270_FIFO_FRAME_SIZE || (fifoLength % BMI270_FIFO_FRAME_SIZE)) {
+        bmi270RegisterWrite(dev, BMI270_REG_CMD, BMI270_VAL_CMD_FIFOFLUSH, 0);
+    }
+
+    return count > 0;
+}
+#endif
+
 static bool bmi270GyroRead(gyroDev_t *gyro)
 {
+#ifdef USE_GYRO_FIFO
+    if (gyro->fifoFrames) {
+        // running in FIFO burst mode
+        return bmi270GyroReadFifoBurst(gyro);
+    }
+#endif
 #ifdef USE_GYRO_DLPF_EXPERIMENTAL
     if (gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL) {
         // running in 6.4KHz FIFO mode
@@ -111,6 +111,36 @@
 #define ICM426XX_RA_INT_SOURCE0                     0x65  // User Bank 0
 #define ICM426XX_UI_DRDY_INT1_EN_DISABLED           (0 << 3)
 #define ICM426XX_UI_DRDY_INT1_EN_ENABLED            (1 << 3)
+#define ICM426XX_FIFO_THS_INT1_EN_ENABLED           (1 << 2)
+
+// --- Registers for FIFO burst mode ------------------------
+#define ICM426XX_RA_FIFO_CONFIG                     0x16  // User Bank 0
+#define ICM426XX_FIFO_MODE_STREAM                   (1 << 6)
+#define ICM426XX_RA_FIFO_COUNTH                     0x2E  // User Bank 0, followed by FIFO_COUNTL and FIFO_DATA
+#define ICM426XX_RA_SIGNAL_PATH_RESET               0x4B  // User Bank 0
+#define ICM426XX_FIFO_FLUSH                         (1 << 1)
+#define ICM426XX_RA_INTF_CONFIG0                    0x4C  // User Bank 0
+#define ICM426XX_FIFO_COUNT_REC                     (1 << 6)
+#define ICM426XX_FIFO_COUNT_ENDIAN_BIG              (1 << 5)
+#define ICM426XX_SENSOR_DATA_ENDIAN_BIG             (1 << 4)
+#define ICM426XX_RA_TMST_CONFIG                     0x54  // User Bank 0
+#define ICM426XX_TMST_EN                            (1 << 0)
+#define ICM426XX_RA_FIFO_CONFIG1                    0x5F  // User Bank 0
+#define ICM426XX_FIFO_WM_GT_TH                      (1 << 5)
+#define ICM426XX_FIFO_TEMP_EN                       (1 << 2)
+#define ICM426XX_FIFO_GYRO_EN                       (1 << 1)
+#define ICM426XX_FIFO_ACCEL_EN                      (1 << 0)
+#define ICM426XX_RA_FIFO_CONFIG2                    0x60  // User Bank 0, watermark LSB
+#define ICM426XX_RA_FIFO_CONFIG3                    0x61  // User Bank 0, watermark MSB
+
+// FIFO packet 3: header, accel, gyro, temperature and 16-bit timestamp (see section 6.1)
+#define ICM426XX_FIFO_FRAME_SIZE                    16
+#define ICM426XX_FIFO_HEADER_EMPTY                  (1 << 7)
+#define ICM426XX_FIFO_HEADER_ACCEL                  (1 << 6)
+#define ICM426XX_FIFO_HEADER_GYRO                   (1 << 5)
+
+// Need to see at least this many interrupts during initialisation to confirm EXTI connectivity
+#define GYRO_EXTI_DETECT_THRESHOLD 100
 
 typedef enum {
     ODR_CONFIG_8K = 0,
@@ -195,6 +225,44 @@ void icm426xxAccInit(accDev_t *acc)
     acc->acc_1G = 512 * 4;
 }
 
+#ifdef USE_GYRO_FIFO
+static inline const uint8_t *icm426xxFifoFrame(const gyroDev_t *gyro, unsigned index)
+{
+    // The burst starts with the big-endian FIFO record count
+    return &gyro->fifoBuf[2 + index * ICM426XX_FIFO_FRAME_SIZE];
+}
+
+static unsigned icm426xxFifoFrameCount(const gyroDev_t *gyro)
+{
+    const unsigned count = (gyro->fifoBuf[0] << 8) | gyro->fifoBuf[1];
+
+    return MIN(count, gyro->fifoFrames);
+}
+#endif
+
+static bool icm426xxAccReadSPI(accDev_t *acc)
+{
+#ifdef USE_GYRO_FIFO
+    const gyroDev_t *gyro = acc->gyro;
+
+    if (gyro->fifoFrames) {
+        // Use the accelerometer sample of the newest record in the last burst
+        for (int i = icm426xxFifoFrameCount(gyro) - 1; i >= 0; i--) {
+            const uint8_t *frame = icm426xxFifoFrame(gyro, i);
+            if (!(frame[0] & ICM426XX_FIFO_HEADER_EMPTY) && (frame[0] & ICM426XX_FIFO_HEADER_ACCEL)) {
+                acc->ADCRaw[X] = (int16_t)((frame[1] << 8) | frame[2]);
+                acc->ADCRaw[Y] = (int16_t)((frame[3] << 8) | frame[4]);
+                acc->ADCRaw[Z] = (int16_t)((frame[5] << 8) | frame[6]);
+                break;
+            }
+        }
+        return true;
+    }
+#endif
+
+    return mpuAccReadSPI(acc);
+}
+
 bool icm426xxSpiAccDetect(accDev_t *acc)
 {
     switch (acc->mpuDetectionResult.sensor) {
@@ -207,7 +275,7 @@ bool icm426xxSpiAccDetect(accDev_t *acc)
     }
 
     acc->initFn = icm426xxAccInit;
-    acc->readFn = mpuAccReadSPI;
+    acc->readFn = icm426xxAccReadSPI;
 
     return true;
 }
@@ -269,7 +337,22 @@ void icm426xxGyroInit(gyroDev_t *gyro)
     spiWriteReg(dev, ICM426XX_RA_INT_CONFIG, ICM426XX_INT1_MODE_PULSED | ICM426XX_INT1_DRIVE_CIRCUIT_PP | ICM426XX_INT1_POLARITY_ACTIVE_HIGH);
     spiWriteReg(dev, ICM426XX_RA_INT_CONFIG0, ICM426XX_UI_DRDY_INT_CLEAR_ON_SBR);
 
-    spiWriteReg(dev, ICM426XX_RA_INT_SOURCE0, ICM426XX_UI_DRDY_INT1_EN_ENABLED);
+#ifdef USE_GYRO_FIFO
+    if (gyro->fifoFrames) {
+        // Stream accel, gyro, temperature and timestamp records into the FIFO and
+        // interrupt when a full burst is available (and on every ODR while it stays above)
+        spiWriteReg(dev, ICM426XX_RA_INTF_CONFIG0, ICM426XX_FIFO_COUNT_REC | ICM426XX_FIFO_COUNT_ENDIAN_BIG | ICM426XX_SENSOR_DATA_ENDIAN_BIG);
+        spiWriteReg(dev, ICM426XX_RA_TMST_CONFIG, ICM426XX_TMST_EN);
+        spiWriteReg(dev, ICM426XX_RA_FIFO_CONFIG1, ICM426XX_FIFO_WM_GT_TH | ICM426XX_FIFO_TEMP_EN | ICM426XX_FIFO_GYRO_EN | ICM426XX_FIFO_ACCEL_EN);
+        spiWriteReg(dev, ICM426XX_RA_FIFO_CONFIG2, gyro->fifoFrames);
+        spiWriteReg(dev, ICM426XX_RA_FIFO_CONFIG3, 0);
+        spiWriteReg(dev, ICM426XX_RA_FIFO_CONFIG, ICM426XX_FIFO_MODE_STREAM);
+        spiWriteReg(dev, ICM426XX_RA_INT_SOURCE0, ICM426XX_FIFO_THS_INT1_EN_ENABLED);
+    } else
+#endif
+    {
+        spiWriteReg(dev, ICM426XX_RA_INT_SOURCE0, ICM426XX_UI_DRDY_INT1_EN_ENABLED);
+    }
 
     uint8_t intConfig1Value = spiReadRegMsk(dev, ICM426XX_RA_INT_CONFIG1);
     // Datasheet says: "User should change setting to 0 from default setting of 1, for proper INT1 and INT2 pin operation"
@@ -307,6 +390,97 @@ void icm426xxGyroInit(gyroDev_t *gyro)
     STATIC_ASSERT(INV_FSR_16G == 3, "INV_FSR_16G must be 3 to generate correct value");
     spiWriteReg(dev, ICM426XX_RA_ACCEL_CONFIG0, (3 - INV_FSR_16G) << 5 | (odrConfig & 0x0F));
     delay(15);
+
+#ifdef USE_GYRO_FIFO
+    // Discard the samples collected while the sensor was being configured
+    if (gyro->fifoFrames) {
+        spiWriteReg(dev, ICM426XX_RA_SIGNAL_PATH_RESET, ICM426XX_FIFO_FLUSH);
+    }
+#endif
+}
+
+#ifdef USE_GYRO_FIFO
+static bool icm426xxGyroReadFifo(gyroDev_t *gyro)
+{
+    switch (gyro->gyroModeSPI) {
+    case GYRO_EXTI_INIT:
+    {
+        STATIC_DMA_DATA_AUTO uint8_t fifoReadCmd[1] = { ICM426XX_RA_FIFO_COUNTH | 0x80 };
+
+        // Burst read the FIFO record count followed by fifoFrames records
+        gyro->dev.callbackArg = (uint32_t)gyro;
+        gyro->segments[0].u.buffers.txData = fifoReadCmd;
+        gyro->segments[0].u.buffers.rxData = NULL;
+        gyro->segments[0].len = sizeof(fifoReadCmd);
+        gyro->segments[0].negateCS = false;
+        gyro->segments[0].callback = NULL;
+        gyro->segments[1].u.buffers.txData = NULL;
+        gyro->segments[1].u.buffers.rxData = gyro->fifoBuf;
+        gyro->segments[1].len = 2 + gyro->fifoFrames * ICM426XX_FIFO_FRAME_SIZE;
+        gyro->segments[1].negateCS = true;
+        gyro->segments[1].callback = mpuIntcallback;
+
+        // We need some offset from the gyro interrupts to ensure sampling after the interrupt
+        gyro->gyroDmaMaxDuration = 5;
+        if (gyro->detectedEXTI > GYRO_EXTI_DETECT_THRESHOLD) {
+            if (spiUseDMA(&gyro->dev)) {
+                gyro->gyroModeSPI = GYRO_EXTI_INT_DMA;
+            } else {
+                // Interrupts are present, but no DMA
+                gyro->gyroModeSPI = GYRO_EXTI_INT;
+            }
+        } else {
+            gyro->gyroModeSPI = GYRO_EXTI_NO_INT;
+        }
+        return false;
+    }
+
+    case GYRO_EXTI_INT:
+    case GYRO_EXTI_NO_INT:
+        spiSequence(&gyro->dev, gyro->segments);
+
+        // Wait for completion
+        spiWait(&gyro->dev);
+        break;
+
+    case GYRO_EXTI_INT_DMA:
+    default:
+        // If read was triggered in interrupt don't bother waiting. The worst that could happen is that we pick
+        // up an old burst.
+        break;
+    }
+
+    // Records beyond the FIFO count read back as empty and are skipped
+    const unsigned frames = icm426xxFifoFrameCount(gyro);
+    unsigned count = 0;
+
+    for (unsigned i = 0; i < frames; i++) {
+        const uint8_t *frame = icm426xxFifoFrame(gyro, i);
+        if ((frame[0] & ICM426XX_FIFO_HEADER_EMPTY) || !(frame[0] & ICM426XX_FIFO_HEADER_GYRO)) {
+            continue;
+        }
+        gyro->fifoGyroRaw[count][X] = (int16_t)((frame[7] << 8) | frame[8]);
+        gyro->fifoGyroRaw[count][Y] = (int16_t)((frame[9] << 8) | frame[10]);
+        gyro->fifoGyroRaw[count][Z] = (int16_t)((frame[11] << 8) | frame[12]);
+        gyro->fifoTimestamp[count] = (frame[14] << 8) | frame[15];
+        count++;
+    }
+
+    gyro->fifoCount = count;
+
+    return count > 0;
+}
+#endif
+
+static bool icm426xxGyroReadSPI(gyroDev_t *gyro)
+{
+#ifdef USE_GYRO_FIFO
+    if (gyro->fifoFrames) {
+        return icm426xxGyroReadFifo(gyro);
+    }
+#endif
+
+    return mpuGyroReadSPI(gyro);
 }
 
 bool icm426xxSpiGyroDetect(gyroDev_t *gyro)
@@ -321,7 +495,7 @@ bool icm426xxSpiGyroDetect(gyroDev_t *gyro)
     }
 
     gyro->initFn = icm426xxGyroInit;
-    gyro->readFn = mpuGyroReadSPI;
+    gyro->readFn = icm426xxGyroReadSPI;
 
     gyro->scale = GYRO_SCALE_2000DPS;
 
@@ -30,6 +30,8 @@
 
 #include "platform.h"
 
+#include "common/utils.h"
+
 #include "drivers/sensor.h"
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/accgyro/gyro_sync.h"
@@ -137,6 +139,26 @@ void gyroSetSampleRate(gyroDev_t *gyro)
 
     }
 
+#ifdef USE_GYRO_FIFO
+    switch (gyro->mpuDetectionResult.sensor) {
+        case ICM_42605_SPI:
+        case ICM_42688P_SPI:
+        case BMI_270_SPI:
+            if (gyro->fifoFrames) {
+                // Run the sensor undivided and handle fifoFrames samples per gyro cycle.
+                // With a single frame every sensor sample is read through the FIFO on its own.
+                gyroSampleRateHz = gyroSampleRateHz * gyroDivider / gyro->fifoFrames;
+                gyroDivider = 1;
+                break;
+            }
+            FALLTHROUGH;
+
+        default:
+            gyro->fifoFrames = 0;
+            break;
+    }
+#endif
+
     gyro->gyroRateKHz = gyroRateKHz;
     gyro->mpuDividerDrops = gyroDivider - 1;
     gyro->gyroSampleRateHz = gyroSampleRateHz;
@@ -84,6 +84,20 @@ ADCDevice adcDeviceByInstance(ADC_TypeDef *instance)
     return ADCINVALID;
 }
 
+#ifdef ADC_ACCUMULATE_COUNT
+// Average the conversions of each channel in a circular DMA buffer into adcValues[]
+void adcAccumulateValues(const volatile uint16_t *buffer, int channelCount)
+{
+    for (int channel = 0; channel < channelCount; channel++) {
+        uint32_t sum = 0;
+        for (int i = 0; i < ADC_ACCUMULATE_COUNT; i++) {
+            sum += buffer[i * channelCount + channel];
+        }
+        adcValues[channel] = (sum + ADC_ACCUMULATE_COUNT / 2) / ADC_ACCUMULATE_COUNT;
+    }
+}
+#endif
+
 bool adcIsEnabled(uint8_t channel)
 {
     return adcOperatingConfig[channel].enabled;
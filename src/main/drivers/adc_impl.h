@@ -95,6 +95,18 @@ extern const adcTagMap_t adcTagMap[ADC_TAG_MAP_COUNT];
 extern adcOperatingConfig_t adcOperatingConfig[ADC_CHANNEL_COUNT];
 extern volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
 
+// Regular channels are oversampled to reduce noise. The H7 and G4 ADCs average
+// ADC_OVERSAMPLE_RATIO conversions in hardware. Elsewhere the DMA fills a circular
+// buffer with the last ADC_ACCUMULATE_COUNT conversions of each channel which are
+// averaged when read, so the values always cover the most recent conversions.
+#if defined(STM32H7) || defined(STM32G4)
+#define ADC_OVERSAMPLE_RATIO    16
+#else
+#define ADC_ACCUMULATE_COUNT    8
+
+void adcAccumulateValues(const volatile uint16_t *buffer, int channelCount);
+#endif
+
 uint8_t adcChannelByTag(ioTag_t ioTag);
 ADCDevice adcDeviceByInstance(ADC_TypeDef *instance);
 bool adcVerifyPin(ioTag_t tag, ADCDevice device);
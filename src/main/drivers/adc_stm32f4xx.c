@@ -208,6 +208,9 @@ uint16_t adcInternalReadTempsensor(void)
 }
 #endif
 
+static volatile uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT * ADC_ACCUMULATE_COUNT];
+static uint8_t adcConversionChannels;
+
 void adcInit(const adcConfig_t *config)
 {
     uint8_t i;
@@ -291,6 +294,7 @@ void adcInit(const adcConfig_t *config)
 #endif
 
     adcInitDevice(adc.ADCx, configuredAdcChannels);
+    adcConversionChannels = configuredAdcChannels;
 
     uint8_t rank = 1;
     for (i = 0; i < ADC_CHANNEL_COUNT; i++) {
@@ -335,11 +339,11 @@ void adcInit(const adcConfig_t *config)
     DMA_InitStructure.DMA_Channel = adc.channel;
 #endif
 
-    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)adcValues;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)adcConversionBuffer;
     DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
-    DMA_InitStructure.DMA_BufferSize = configuredAdcChannels;
+    DMA_InitStructure.DMA_BufferSize = configuredAdcChannels * ADC_ACCUMULATE_COUNT;
     DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
-    DMA_InitStructure.DMA_MemoryInc = configuredAdcChannels > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
     DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
     DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
     DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
@@ -358,6 +362,6 @@ void adcInit(const adcConfig_t *config)
 
 void adcGetChannelValues(void)
 {
-    // Nothing to do
+    adcAccumulateValues(adcConversionBuffer, adcConversionChannels);
 }
 #endif
@@ -125,6 +125,9 @@ void adcInitDevice(adcDevice_t *adcdev, int channelCount)
 
 static adcDevice_t adc;
 
+static volatile FAST_DATA_ZERO_INIT uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT * ADC_ACCUMULATE_COUNT];
+static uint8_t adcConversionChannels;
+
 #ifdef USE_ADC_INTERNAL
 
 static adcDevice_t adcInternal;
@@ -258,6 +261,7 @@ void adcInit(const adcConfig_t *config)
     RCC_ClockCmd(adc.rccADC, ENABLE);
 
     adcInitDevice(&adc, configuredAdcChannels);
+    adcConversionChannels = configuredAdcChannels;
 
 #ifdef USE_ADC_INTERNAL
     // If device is not ADC1 or there's no active channel, then initialize ADC1  here.
@@ -309,7 +313,7 @@ void adcInit(const adcConfig_t *config)
 
     adc.DmaHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
     adc.DmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
-    adc.DmaHandle.Init.MemInc = configuredAdcChannels > 1 ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
+    adc.DmaHandle.Init.MemInc = DMA_MINC_ENABLE;
     adc.DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.Mode = DMA_CIRCULAR;
@@ -327,9 +331,7 @@ void adcInit(const adcConfig_t *config)
 
     __HAL_LINKDMA(&adc.ADCHandle, DMA_Handle, adc.DmaHandle);
 
-    //HAL_CLEANINVALIDATECACHE((uint32_t*)&adcValues, configuredAdcChannels);
-
-    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, configuredAdcChannels) != HAL_OK)
+    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcConversionBuffer, configuredAdcChannels * ADC_ACCUMULATE_COUNT) != HAL_OK)
     {
         /* Start Conversion Error */
     }
@@ -337,6 +339,6 @@ void adcInit(const adcConfig_t *config)
 
 void adcGetChannelValues(void)
 {
-    // Nothing to do
+    adcAccumulateValues(adcConversionBuffer, adcConversionChannels);
 }
 #endif
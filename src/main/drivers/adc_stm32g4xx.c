@@ -221,7 +221,13 @@ void adcInitDevice(adcDevice_t *adcdev, int channelCount)
     hadc->Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
     hadc->Init.DMAContinuousRequests = ENABLE;
     hadc->Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
-    hadc->Init.OversamplingMode = DISABLE;
+
+    // Average ADC_OVERSAMPLE_RATIO conversions, shifting the sum back to 12 bits
+    hadc->Init.OversamplingMode = ENABLE;
+    hadc->Init.Oversampling.Ratio = ADC_OVERSAMPLING_RATIO_16;
+    hadc->Init.Oversampling.RightBitShift = ADC_RIGHTBITSHIFT_4;
+    hadc->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    hadc->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
 
     if (HAL_ADC_Init(hadc) != HAL_OK) {
         handleError();
@@ -225,7 +225,20 @@ void adcInitDevice(adcDevice_t *adcdev, int channelCount)
 #endif
 
     hadc->Init.Overrun                  = ADC_OVR_DATA_OVERWRITTEN;
-    hadc->Init.OversamplingMode         = DISABLE;
+
+    // Average ADC_OVERSAMPLE_RATIO conversions, shifting the sum back to 12 bits
+    hadc->Init.OversamplingMode         = ENABLE;
+#if defined(ADC_VER_V5_V90)
+    if (adcdev->ADCx == ADC3) {
+        hadc->Init.Oversampling.Ratio   = ADC3_OVERSAMPLING_RATIO_16;
+    } else
+#endif
+    {
+        hadc->Init.Oversampling.Ratio   = ADC_OVERSAMPLE_RATIO;
+    }
+    hadc->Init.Oversampling.RightBitShift = ADC_RIGHTBITSHIFT_4;
+    hadc->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    hadc->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
 
     // Initialize this ADC peripheral
 
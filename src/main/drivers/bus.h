@@ -42,6 +42,24 @@ typedef enum {
     BUS_ABORT
 } busStatus_e;
 
+// Transactions from higher priority devices are queued ahead of, and may preempt, lower priority ones
+typedef enum {
+    BUS_PRIORITY_LOW = 0,   // Bulk transfers such as flash and OSD
+    BUS_PRIORITY_NORMAL,
+    BUS_PRIORITY_HIGH,      // Time critical devices such as the gyro and SPI receivers
+} busPriority_e;
+
+typedef struct busStats_s {
+    uint64_t busyCycles;        // Time the bus was in use
+    uint64_t waitCycles;        // Total time queued transactions waited for the bus
+    uint32_t waitMaxCycles;     // Longest wait of a queued transaction
+    uint32_t busyStartCycles;
+    uint32_t transfers;
+    uint32_t queued;            // Transactions which had to wait for the bus
+    uint32_t preemptions;       // Transactions suspended at a segment boundary for a higher priority one
+    uint32_t resetTimeUs;
+} busStats_t;
+
 
 // Bus interface, independent of connected device
 typedef struct busDevice_s {
@@ -75,6 +93,7 @@ typedef struct busDevice_s {
 #endif // UNIT_TEST
     volatile struct busSegment_s* volatile curSegment;
     bool initSegment;
+    busStats_t stats;
 } busDevice_t;
 
 // External device has an associated bus and bus dependent address
@@ -88,6 +107,8 @@ typedef struct extDevice_s {
         } spi;
         struct extI2C_s {
             uint8_t address;
+            // Set if the device's last transaction failed
+            volatile bool error;
         } i2c;
         struct extMpuSlave_s {
             uint8_t address;
@@ -105,6 +126,10 @@ typedef struct extDevice_s {
 #endif // UNIT_TEST
     // Support disabling DMA on a per device basis
     bool useDMA;
+    // Scheduling priority of this device's transactions on a shared bus
+    busPriority_e priority;
+    // Time at which a transaction was queued behind another device
+    uint32_t queuedCycles;
     // Per device buffer reference if needed
     uint8_t *txBuf, *rxBuf;
     // Connected devices on the same bus may support different speeds
@@ -116,6 +141,8 @@ typedef struct extDevice_s {
  *
  * If there are more than one segments, or a single segment with negateCS negated then DMA will be used irrespective of length
  *
+ * When using DMA, a transaction may be suspended after a segment which negates CS so that a queued transaction from a
+ * higher priority device can use the bus. The remaining segments are resumed once that transaction completes.
  */
 typedef struct busSegment_s {
     union {
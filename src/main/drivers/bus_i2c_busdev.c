@@ -26,53 +26,379 @@
 
 #if defined(USE_I2C)
 
+#include "build/atomic.h"
+
 #include "drivers/bus.h"
 #include "drivers/bus_i2c.h"
+#include "drivers/bus_i2c_busdev.h"
+#include "drivers/bus_i2c_impl.h"
+#include "drivers/nvic.h"
+#include "drivers/system.h"
+#include "drivers/time.h"
+
+// Number of non-blocking register accesses which may be queued at once across all buses
+#define I2C_START_SLOT_COUNT 4
+
+// Storage for the segment lists of the non-blocking register access routines
+typedef struct i2cStartSlot_s {
+    // Device owning the slot, NULL when the slot is free
+    const extDevice_t * volatile dev;
+    uint8_t txData[2];
+    busSegment_t segments[2];
+} i2cStartSlot_t;
 
 static uint8_t i2cRegisteredDeviceCount = 0;
 
+// I2C bus structures to associate with external devices
+static busDevice_t i2cBus[I2CDEV_COUNT];
+
+// Device whose segment is in progress on each bus
+static const extDevice_t *i2cBusCurrentDev[I2CDEV_COUNT];
+static volatile timeUs_t i2cBusSegmentStartUs[I2CDEV_COUNT];
+
+static i2cStartSlot_t i2cStartSlot[I2C_START_SLOT_COUNT];
+
+// Record the outcome of a device's transaction, which is reported to that device only
+static void i2cSetDeviceError(const extDevice_t *dev, bool error)
+{
+    ((extDevice_t *)dev)->busType_u.i2c.error = error;
+}
+
+// Free the start slot, if any, whose segment list ends with the given segment
+static void i2cReleaseSegments(const busSegment_t *endSegment)
+{
+    for (int i = 0; i < I2C_START_SLOT_COUNT; i++) {
+        if (endSegment == &i2cStartSlot[i].segments[1]) {
+            i2cStartSlot[i].dev = NULL;
+        }
+    }
+}
+
+// Start the transfer of the bus's current segment
+static bool i2cSegmentStart(const extDevice_t *dev)
+{
+    busDevice_t *bus = dev->bus;
+    const I2CDevice device = bus->busType_u.i2c.device;
+    // OK to discard the volatile qualifier as the segment isn't in progress
+    busSegment_t *segment = (busSegment_t *)bus->curSegment;
+    uint8_t *txData = segment->u.buffers.txData;
+
+    i2cBusCurrentDev[device] = dev;
+    i2cBusSegmentStartUs[device] = microsISR();
+
+    if (segment->u.buffers.rxData) {
+        return i2cReadBuffer(device, dev->busType_u.i2c.address, txData[0], segment->len, segment->u.buffers.rxData);
+    } else {
+        return i2cWriteBuffer(device, dev->busType_u.i2c.address, txData[0], segment->len, &txData[1]);
+    }
+}
+
+// Step past the current segment, returning the device whose segment is to be started next or NULL if the bus is free
+static const extDevice_t *i2cSequenceNext(const extDevice_t *dev, bool error)
+{
+    busDevice_t *bus = dev->bus;
+    busSegment_t *segment = (busSegment_t *)bus->curSegment;
+    bool abort = error;
+
+    if (error) {
+        i2cSetDeviceError(dev, true);
+    } else if (segment->callback) {
+        switch (segment->callback(dev->callbackArg)) {
+        case BUS_BUSY:
+            // Repeat the segment
+            return dev;
+
+        case BUS_ABORT:
+            abort = true;
+            break;
+
+        case BUS_READY:
+        default:
+            break;
+        }
+    }
+
+    if (abort) {
+        // Skip the remainder of this transaction
+        while (segment->len) {
+            segment++;
+        }
+    } else {
+        segment++;
+    }
+
+    if (segment->len == 0) {
+        // The end of the segment list has been reached, so start any linked transaction
+        const extDevice_t *nextDev = segment->u.link.dev;
+        busSegment_t *nextSegments = (busSegment_t *)segment->u.link.segments;
+
+        segment->u.link.dev = NULL;
+        segment->u.link.segments = NULL;
+        i2cReleaseSegments(segment);
+
+        bus->curSegment = nextSegments;
+
+        return nextDev;
+    }
+
+    bus->curSegment = segment;
+
+    return dev;
+}
+
+// Work through the segments until one is successfully started or the bus is free
+static void i2cSequenceContinue(const extDevice_t *dev, bool error)
+{
+    while ((dev = i2cSequenceNext(dev, error))) {
+        if (i2cSegmentStart(dev)) {
+            return;
+        }
+        error = true;
+    }
+}
+
+// Called by the I2C drivers, usually in interrupt context, when a transfer completes
+void i2cTransferComplete(I2CDevice device, bool error)
+{
+    if (device != I2CINVALID && i2cBus[device].curSegment) {
+        i2cSequenceContinue(i2cBusCurrentDev[device], error);
+    }
+}
+
+// Abandon all queued transactions if the current one has failed to complete in time
+static void i2cSequenceTimeout(busDevice_t *bus)
+{
+    const I2CDevice device = bus->busType_u.i2c.device;
+    busSegment_t *segment = NULL;
+    const extDevice_t *dev = NULL;
+
+    // Only detach the queue atomically, the reset may take milliseconds to unstick the bus
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (bus->curSegment && cmpTimeUs(microsISR(), i2cBusSegmentStartUs[device]) >= I2C_TIMEOUT_US) {
+            segment = (busSegment_t *)bus->curSegment;
+            dev = i2cBusCurrentDev[device];
+            bus->curSegment = NULL;
+        }
+    }
+
+    if (!segment) {
+        return;
+    }
+
+    // Stop the peripheral before the buffers it is transferring are released
+    i2cReset(device);
+
+    while (segment) {
+        i2cSetDeviceError(dev, true);
+
+        while (segment->len) {
+            segment++;
+        }
+
+        busSegment_t *nextSegments = (busSegment_t *)segment->u.link.segments;
+        dev = segment->u.link.dev;
+
+        segment->u.link.dev = NULL;
+        segment->u.link.segments = NULL;
+        i2cReleaseSegments(segment);
+
+        segment = nextSegments;
+    }
+}
+
+// Return true if a transaction is in progress on the device's bus
+bool i2cIsBusy(const extDevice_t *dev)
+{
+    return (dev->bus->curSegment != NULL);
+}
+
+// Wait for the device's bus to become free, returning false if the last transaction failed
+static bool i2cWaitBus(const extDevice_t *dev)
+{
+    while (i2cIsBusy(dev)) {
+        i2cSequenceTimeout(dev->bus);
+    }
+
+    return !dev->busType_u.i2c.error;
+}
+
+// Queue a list of segments for transfer, starting it immediately if the bus is free
+void i2cSequence(const extDevice_t *dev, busSegment_t *segments)
+{
+    busDevice_t *bus = dev->bus;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        bus->stats.transfers++;
+
+        i2cSetDeviceError(dev, false);
+
+        if (i2cIsBusy(dev)) {
+            busSegment_t *endSegment;
+            busSegment_t *insertSegment = NULL;
+
+            // Defer this transfer to be triggered upon completion of the current transfer
+
+            // Find the last segment of the new transfer
+            for (endSegment = segments; endSegment->len; endSegment++);
+
+            // Safe to discard the volatile qualifier as we're in an atomic block
+            busSegment_t *endCmpSegment = (busSegment_t *)bus->curSegment;
+
+            while (true) {
+                // Find the last segment of the current transfer
+                for (; endCmpSegment->len; endCmpSegment++);
+
+                if (endCmpSegment == endSegment) {
+                    // Attempt to use the new segment list twice in the same queue. Abort.
+                    return;
+                }
+
+                const extDevice_t *linkDev = endCmpSegment->u.link.dev;
+
+                // Queue ahead of the first transaction of lower priority
+                if (!insertSegment && (!linkDev || linkDev->priority < dev->priority)) {
+                    insertSegment = endCmpSegment;
+                }
+
+                if (linkDev == NULL) {
+                    // End of the segment list queue reached
+                    break;
+                } else {
+                    // Follow the link to the next queued segment list
+                    endCmpSegment = (busSegment_t *)endCmpSegment->u.link.segments;
+                }
+            }
+
+            // Link the new transfer in ahead of any lower priority ones
+            endSegment->u.link.dev = insertSegment->u.link.dev;
+            endSegment->u.link.segments = insertSegment->u.link.segments;
+
+            insertSegment->u.link.dev = dev;
+            insertSegment->u.link.segments = segments;
+
+            bus->stats.queued++;
+            ((extDevice_t *)dev)->queuedCycles = getCycleCounter() | 1;
+
+            return;
+        } else {
+            // Claim the bus with this list of segments
+            bus->curSegment = segments;
+        }
+    }
+
+    if (!i2cSegmentStart(dev)) {
+        i2cSequenceContinue(dev, true);
+    }
+}
+
+// Claim a free start slot for a non-blocking access
+static i2cStartSlot_t *i2cClaimStartSlot(const extDevice_t *dev)
+{
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        for (int i = 0; i < I2C_START_SLOT_COUNT; i++) {
+            if (i2cStartSlot[i].dev == NULL) {
+                i2cStartSlot[i].dev = dev;
+                return &i2cStartSlot[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
 bool i2cBusWriteRegister(const extDevice_t *dev, uint8_t reg, uint8_t data)
 {
-    return i2cWrite(dev->bus->busType_u.i2c.device, dev->busType_u.i2c.address, reg, data);
+    // This routine blocks so no need to use static data
+    uint8_t txData[2] = { reg, data };
+    busSegment_t segments[] = {
+            {.u.buffers = {txData, NULL}, sizeof(data), true, NULL},
+            {.u.link = {NULL, NULL}, 0, true, NULL},
+    };
+
+    i2cWaitBus(dev);
+    i2cSequence(dev, &segments[0]);
+
+    return i2cWaitBus(dev);
 }
 
 bool i2cBusWriteRegisterStart(const extDevice_t *dev, uint8_t reg, uint8_t data)
 {
-    // Need a static value, not on the stack
-    static uint8_t byte;
+    i2cStartSlot_t *slot = i2cClaimStartSlot(dev);
+
+    if (!slot) {
+        return false;
+    }
+
+    slot->txData[0] = reg;
+    slot->txData[1] = data;
+
+    slot->segments[0] = (busSegment_t){.u.buffers = {slot->txData, NULL}, sizeof(data), true, NULL};
+    slot->segments[1] = (busSegment_t){.u.link = {NULL, NULL}, 0, true, NULL};
 
-    byte = data;
+    i2cSequence(dev, &slot->segments[0]);
 
-    return i2cWriteBuffer(dev->bus->busType_u.i2c.device, dev->busType_u.i2c.address, reg, sizeof(byte), &byte);
+    return true;
 }
 
 bool i2cBusReadRegisterBuffer(const extDevice_t *dev, uint8_t reg, uint8_t *data, uint8_t length)
 {
-    return i2cRead(dev->bus->busType_u.i2c.device, dev->busType_u.i2c.address, reg, length, data);
+    // This routine blocks so no need to use static data
+    busSegment_t segments[] = {
+            {.u.buffers = {&reg, data}, length, true, NULL},
+            {.u.link = {NULL, NULL}, 0, true, NULL},
+    };
+
+    i2cWaitBus(dev);
+    i2cSequence(dev, &segments[0]);
+
+    return i2cWaitBus(dev);
 }
 
 uint8_t i2cBusReadRegister(const extDevice_t *dev, uint8_t reg)
 {
     uint8_t data;
-    i2cRead(dev->bus->busType_u.i2c.device, dev->busType_u.i2c.address, reg, 1, &data);
+    i2cBusReadRegisterBuffer(dev, reg, &data, 1);
     return data;
 }
 
 bool i2cBusReadRegisterBufferStart(const extDevice_t *dev, uint8_t reg, uint8_t *data, uint8_t length)
 {
-    return i2cReadBuffer(dev->bus->busType_u.i2c.device, dev->busType_u.i2c.address, reg, length, data);
+    i2cStartSlot_t *slot = i2cClaimStartSlot(dev);
+
+    if (!slot) {
+        return false;
+    }
+
+    slot->txData[0] = reg;
+
+    slot->segments[0] = (busSegment_t){.u.buffers = {slot->txData, data}, length, true, NULL};
+    slot->segments[1] = (busSegment_t){.u.link = {NULL, NULL}, 0, true, NULL};
+
+    i2cSequence(dev, &slot->segments[0]);
+
+    return true;
 }
 
+// Return true while a non-blocking access started by this device is queued or in progress
 bool i2cBusBusy(const extDevice_t *dev, bool *error)
 {
-    return i2cBusy(dev->bus->busType_u.i2c.device, error);
+    i2cSequenceTimeout(dev->bus);
+
+    if (error) {
+        *error = dev->busType_u.i2c.error;
+    }
+
+    for (int i = 0; i < I2C_START_SLOT_COUNT; i++) {
+        if (i2cStartSlot[i].dev == dev) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 bool i2cBusSetInstance(extDevice_t *dev, uint32_t device)
 {
-    // I2C bus structures to associate with external devices
-    static busDevice_t i2cBus[I2CDEV_COUNT];
-
     if ((device < 1) || (device > I2CDEV_COUNT)) {
         return false;
     }
@@ -20,6 +20,17 @@
 
 #pragma once
 
+#include "drivers/bus.h"
+
+/* I2C transactions use the same segment lists as spiSequence(). Each segment is a
+ * register access: u.buffers.txData[0] holds the register, and len bytes are either
+ * read from it into u.buffers.rxData or, if that is NULL, written to it from
+ * u.buffers.txData[1] onwards. negateCS is ignored. Segment callbacks are called on
+ * completion of each segment, in interrupt context.
+ */
+void i2cSequence(const extDevice_t *dev, busSegment_t *segments);
+bool i2cIsBusy(const extDevice_t *dev);
+
 bool i2cBusWriteRegister(const extDevice_t *dev, uint8_t reg, uint8_t data);
 bool i2cBusWriteRegisterStart(const extDevice_t *dev, uint8_t reg, uint8_t data);
 bool i2cBusReadRegisterBuffer(const extDevice_t *dev, uint8_t reg, uint8_t *data, uint8_t length);
@@ -27,5 +38,5 @@ uint8_t i2cBusReadRegister(const extDevice_t *dev, uint8_t reg);
 bool i2cBusReadRegisterBufferStart(const extDevice_t *dev, uint8_t reg, uint8_t *data, uint8_t length);
 bool i2cBusBusy(const extDevice_t *dev, bool *error);
 // Associate a device with an I2C bus
-bool i2cBusSetInstance(const extDevice_t *dev, uint32_t device);
+bool i2cBusSetInstance(extDevice_t *dev, uint32_t device);
 void i2cBusDeviceRegister(const extDevice_t *dev);
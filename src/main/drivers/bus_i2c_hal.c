@@ -94,6 +94,27 @@ static bool i2cHandleHardwareFailure(I2CDevice device)
     return false;
 }
 
+// Abandon the transfer in progress and recover the bus, e.g. after a timeout
+void i2cReset(I2CDevice device)
+{
+    if (device == I2CINVALID || device >= I2CDEV_COUNT) {
+        return;
+    }
+
+    I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
+
+    if (!pHandle->Instance) {
+        return;
+    }
+
+    i2cErrorCount++;
+
+    // Disable the peripheral and its interrupts, then restore the configuration set by i2cInit()
+    HAL_I2C_DeInit(pHandle);
+    HAL_I2C_Init(pHandle);
+    HAL_I2CEx_ConfigAnalogFilter(pHandle, I2C_ANALOGFILTER_ENABLE);
+}
+
 uint16_t i2cGetErrorCounter(void)
 {
     return i2cErrorCount;
@@ -140,7 +161,10 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
 
     HAL_StatusTypeDef status;
 
-    status = HAL_I2C_Mem_Write_IT(pHandle ,addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT,data, len_);
+    if (reg_ == 0xFF)
+        status = HAL_I2C_Master_Transmit_IT(pHandle ,addr_ << 1, data, len_);
+    else
+        status = HAL_I2C_Mem_Write_IT(pHandle ,addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT,data, len_);
 
     if (status == HAL_BUSY) {
         return false;
@@ -196,7 +220,10 @@ bool i2cReadBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, u
 
     HAL_StatusTypeDef status;
 
-    status = HAL_I2C_Mem_Read_IT(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT,buf, len);
+    if (reg_ == 0xFF)
+        status = HAL_I2C_Master_Receive_IT(pHandle ,addr_ << 1, buf, len);
+    else
+        status = HAL_I2C_Mem_Read_IT(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT,buf, len);
 
     if (status == HAL_BUSY) {
         return false;
@@ -209,6 +236,44 @@ bool i2cReadBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, u
     return true;
 }
 
+static I2CDevice i2cDeviceByHandle(I2C_HandleTypeDef *pHandle)
+{
+    for (int device = 0; device < I2CDEV_COUNT; device++) {
+        if (&i2cDevice[device].handle == pHandle) {
+            return device;
+        }
+    }
+
+    return I2CINVALID;
+}
+
+// Completion callbacks of the non-blocking transfers, called from the I2C interrupt handlers
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferComplete(i2cDeviceByHandle(pHandle), false);
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferComplete(i2cDeviceByHandle(pHandle), false);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferComplete(i2cDeviceByHandle(pHandle), false);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferComplete(i2cDeviceByHandle(pHandle), false);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferComplete(i2cDeviceByHandle(pHandle), true);
+}
+
 bool i2cBusy(I2CDevice device, bool *error)
 {
     I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
@@ -315,6 +315,10 @@ static void i2c_er_handler(I2CDevice device) {
     }
     I2Cx->SR1 &= ~(I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR);     // reset all the error bits to clear the interrupt
     state->busy = 0;
+
+    if (SR1Register & (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF)) {             // the job was abandoned, so move on to the next queued one
+        i2cTransferComplete(device, true);
+    }
 }
 
 void i2c_ev_handler(I2CDevice device) {
@@ -429,37 +433,19 @@ void i2c_ev_handler(I2CDevice device) {
         if (final_stop)                                                 // If there is a final stop and no more jobs, bus is inactive, disable interrupts to prevent BTF
             I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, DISABLE);       // Disable EVT and ERR interrupts while bus inactive
         state->busy = 0;
+        i2cTransferComplete(device, state->error);                      // start the next queued job, if any
     }
 }
 
-void i2cInit(I2CDevice device)
+// Clock out any device holding the bus, then reset and configure the pins and the peripheral
+static void i2cHardwareReset(i2cDevice_t *pDev)
 {
-    if (device == I2CINVALID)
-        return;
-
-    i2cDevice_t *pDev = &i2cDevice[device];
-    const i2cHardware_t *hw = pDev->hardware;
+    I2C_TypeDef *I2Cx = pDev->hardware->reg;
     const IO_t scl = pDev->scl;
     const IO_t sda = pDev->sda;
-
-    if (!hw || IOGetOwner(scl) || IOGetOwner(sda)) {
-        return;
-    }
-
-    I2C_TypeDef *I2Cx = hw->reg;
-
-    memset(&pDev->state, 0, sizeof(pDev->state));
-
-    NVIC_InitTypeDef nvic;
     I2C_InitTypeDef i2cInit;
 
-    IOInit(scl, OWNER_I2C_SCL, RESOURCE_INDEX(device));
-    IOInit(sda, OWNER_I2C_SDA, RESOURCE_INDEX(device));
-
-    // Enable RCC
-    RCC_ClockCmd(hw->rcc, ENABLE);
-
-    I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, DISABLE);
+    memset(&pDev->state, 0, sizeof(pDev->state));
 
     i2cUnstick(scl, sda);
 
@@ -487,6 +473,55 @@ void i2cInit(I2CDevice device)
     I2C_Init(I2Cx, &i2cInit);
 
     I2C_StretchClockCmd(I2Cx, ENABLE);
+}
+
+// Abandon the transfer in progress and recover the bus, e.g. after a timeout
+void i2cReset(I2CDevice device)
+{
+    if (device == I2CINVALID || device >= I2CDEV_COUNT) {
+        return;
+    }
+
+    i2cDevice_t *pDev = &i2cDevice[device];
+
+    if (!pDev->hardware) {
+        return;
+    }
+
+    I2C_ITConfig(pDev->hardware->reg, I2C_IT_EVT | I2C_IT_ERR | I2C_IT_BUF, DISABLE);
+
+    i2cErrorCount++;
+
+    i2cHardwareReset(pDev);
+}
+
+void i2cInit(I2CDevice device)
+{
+    if (device == I2CINVALID)
+        return;
+
+    i2cDevice_t *pDev = &i2cDevice[device];
+    const i2cHardware_t *hw = pDev->hardware;
+    const IO_t scl = pDev->scl;
+    const IO_t sda = pDev->sda;
+
+    if (!hw || IOGetOwner(scl) || IOGetOwner(sda)) {
+        return;
+    }
+
+    I2C_TypeDef *I2Cx = hw->reg;
+
+    NVIC_InitTypeDef nvic;
+
+    IOInit(scl, OWNER_I2C_SCL, RESOURCE_INDEX(device));
+    IOInit(sda, OWNER_I2C_SDA, RESOURCE_INDEX(device));
+
+    // Enable RCC
+    RCC_ClockCmd(hw->rcc, ENABLE);
+
+    I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, DISABLE);
+
+    i2cHardwareReset(pDev);
 
     // I2C ER Interrupt
     nvic.NVIC_IRQChannel = hw->er_irq;
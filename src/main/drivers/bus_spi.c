@@ -28,6 +28,9 @@
 
 #ifdef USE_SPI
 
+#include "common/maths.h"
+#include "common/time.h"
+
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
 #include "drivers/bus_spi_impl.h"
@@ -36,6 +39,8 @@
 #include "drivers/io.h"
 #include "drivers/motor.h"
 #include "drivers/rcc.h"
+#include "drivers/system.h"
+#include "drivers/time.h"
 #include "nvic.h"
 #include "pg/bus_spi.h"
 
@@ -377,11 +382,67 @@ uint32_t spiCalculateClock(uint16_t spiClkDivisor)
     return spiClk / spiClkDivisor;
 }
 
+// Mark the bus as free, accounting for the time it was in use
+void spiReleaseBus(busDevice_t *bus)
+{
+    bus->stats.busyCycles += cmpTimeCycles(getCycleCounter(), bus->stats.busyStartCycles);
+    bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
+}
+
+// Called as each transaction is started to record how long it was queued
+void spiSequenceStats(const extDevice_t *dev)
+{
+    if (dev->queuedCycles) {
+        busStats_t *stats = &dev->bus->stats;
+        const uint32_t waitCycles = cmpTimeCycles(getCycleCounter(), dev->queuedCycles);
+
+        stats->waitCycles += waitCycles;
+        stats->waitMaxCycles = MAX(stats->waitMaxCycles, waitCycles);
+
+        ((extDevice_t *)dev)->queuedCycles = 0;
+    }
+}
+
+// Start a higher priority transaction queued after the current one, if there is one, leaving the remaining
+// segments of the current transaction to be resumed after it
+static bool spiPreempt(const extDevice_t *dev, busSegment_t *nextSegment)
+{
+    busDevice_t *bus = dev->bus;
+    busSegment_t *endSegment;
+
+    for (endSegment = nextSegment; endSegment->len; endSegment++);
+
+    const extDevice_t *nextDev = endSegment->u.link.dev;
+
+    if (!nextDev || nextDev->priority <= dev->priority) {
+        return false;
+    }
+
+    busSegment_t *nextSegments = (busSegment_t *)endSegment->u.link.segments;
+    busSegment_t *nextEndSegment;
+
+    for (nextEndSegment = nextSegments; nextEndSegment->len; nextEndSegment++);
+
+    // Queue the remainder of this transaction directly after the preempting one
+    endSegment->u.link.dev = nextEndSegment->u.link.dev;
+    endSegment->u.link.segments = nextEndSegment->u.link.segments;
+    nextEndSegment->u.link.dev = dev;
+    nextEndSegment->u.link.segments = nextSegment;
+
+    bus->stats.preemptions++;
+    bus->curSegment = nextSegments;
+    spiSequenceStart(nextDev);
+
+    return true;
+}
+
 // Interrupt handler for SPI receive DMA completion
 static void spiIrqHandler(const extDevice_t *dev)
 {
     busDevice_t *bus = dev->bus;
     busSegment_t *nextSegment;
+    // Chip select is released at this segment boundary, so another device may use the bus
+    const bool csReleased = bus->curSegment->negateCS;
 
     if (bus->curSegment->callback) {
         switch(bus->curSegment->callback(dev->callbackArg)) {
@@ -393,7 +454,7 @@ static void spiIrqHandler(const extDevice_t *dev)
             break;
 
         case BUS_ABORT:
-            bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
+            spiReleaseBus(bus);
             return;
 
         case BUS_READY:
@@ -418,8 +479,11 @@ static void spiIrqHandler(const extDevice_t *dev)
             spiSequenceStart(nextDev);
         } else {
             // The end of the segment list has been reached, so mark transactions as complete
-            bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
+            spiReleaseBus(bus);
         }
+    } else if (csReleased && spiPreempt(dev, nextSegment)) {
+        // A higher priority transaction has been started
+        return;
     } else {
         // Do as much processing as possible before asserting CS to avoid violating minimum high time
         bool negateCS = bus->curSegment->negateCS;
@@ -515,6 +579,7 @@ bool spiSetBusInstance(extDevice_t *dev, uint32_t device)
 
     // By default each device should use SPI DMA if the bus supports it
     dev->useDMA = true;
+    dev->priority = BUS_PRIORITY_NORMAL;
 
     if (dev->bus->busType == BUS_TYPE_SPI) {
         // This bus has already been initialised
@@ -694,6 +759,32 @@ bool spiUseMOSI_DMA(const extDevice_t *dev)
     return dev->bus->useDMA && dev->useDMA;
 }
 
+void spiSetPriority(const extDevice_t *dev, busPriority_e priority)
+{
+    ((extDevice_t *)dev)->priority = priority;
+}
+
+const busStats_t *spiGetBusStats(SPIDevice device)
+{
+    const busDevice_t *bus = &spiBusDevice[device];
+
+    return (bus->busType == BUS_TYPE_SPI) ? &bus->stats : NULL;
+}
+
+void spiResetBusStats(void)
+{
+    for (int device = 0; device < SPIDEV_COUNT; device++) {
+        busDevice_t *bus = &spiBusDevice[device];
+
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            memset(&bus->stats, 0, sizeof(bus->stats));
+            // Only account for the part of any transfer in progress after the reset
+            bus->stats.busyStartCycles = getCycleCounter();
+            bus->stats.resetTimeUs = micros();
+        }
+    }
+}
+
 void spiBusDeviceRegister(const extDevice_t *dev)
 {
     UNUSED(dev);
@@ -717,8 +808,11 @@ void spiSequence(const extDevice_t *dev, busSegment_t *segments)
     busDevice_t *bus = dev->bus;
 
     ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        bus->stats.transfers++;
+
         if (spiIsBusy(dev)) {
             busSegment_t *endSegment;
+            busSegment_t *insertSegment = NULL;
 
             // Defer this transfer to be triggered upon completion of the current transfer
 
@@ -741,7 +835,14 @@ void spiSequence(const extDevice_t *dev, busSegment_t *segments)
                         return;
                     }
 
-                    if (endCmpSegment->u.link.dev == NULL) {
+                    const extDevice_t *linkDev = endCmpSegment->u.link.dev;
+
+                    // Queue ahead of the first transaction of lower priority
+                    if (!insertSegment && (!linkDev || linkDev->priority < dev->priority)) {
+                        insertSegment = endCmpSegment;
+                    }
+
+                    if (linkDev == NULL) {
                         // End of the segment list queue reached
                         break;
                     } else {
@@ -751,14 +852,22 @@ void spiSequence(const extDevice_t *dev, busSegment_t *segments)
                 }
             }
 
+            // Link the new transfer in ahead of any lower priority ones
+            endSegment->u.link.dev = insertSegment->u.link.dev;
+            endSegment->u.link.segments = insertSegment->u.link.segments;
+
             // Record the dev and segments parameters in the terminating segment entry
-            endCmpSegment->u.link.dev = dev;
-            endCmpSegment->u.link.segments = segments;
+            insertSegment->u.link.dev = dev;
+            insertSegment->u.link.segments = segments;
+
+            bus->stats.queued++;
+            ((extDevice_t *)dev)->queuedCycles = getCycleCounter() | 1;
 
             return;
         } else {
             // Claim the bus with this list of segments
             bus->curSegment = segments;
+            bus->stats.busyStartCycles = getCycleCounter();
         }
     }
 
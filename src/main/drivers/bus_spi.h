@@ -162,6 +162,9 @@ struct spiPinConfig_s;
 void spiPinConfigure(const struct spiPinConfig_s *pConfig);
 bool spiUseDMA(const extDevice_t *dev);
 bool spiUseMOSI_DMA(const extDevice_t *dev);
+void spiSetPriority(const extDevice_t *dev, busPriority_e priority);
+const busStats_t *spiGetBusStats(SPIDevice device);
+void spiResetBusStats(void);
 void spiBusDeviceRegister(const extDevice_t *dev);
 uint8_t spiGetRegisteredDeviceCount(void);
 uint8_t spiGetExtDeviceCount(const extDevice_t *dev);
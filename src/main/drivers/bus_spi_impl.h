@@ -90,4 +90,6 @@ void spiInternalStopDMA (const extDevice_t *dev);
 void spiInternalResetStream(dmaChannelDescriptor_t *descriptor);
 void spiInternalResetDescriptors(busDevice_t *bus);
 void spiSequenceStart(const extDevice_t *dev);
+void spiSequenceStats(const extDevice_t *dev);
+void spiReleaseBus(busDevice_t *bus);
 
@@ -541,6 +541,8 @@ void spiSequenceStart(const extDevice_t *dev)
 
     bus->initSegment = true;
 
+    spiSequenceStats(dev);
+
     // Switch bus speed
 #if !defined(STM32H7)
     LL_SPI_Disable(instance);
@@ -673,7 +675,7 @@ void spiSequenceStart(const extDevice_t *dev)
                     break;
 
                 case BUS_ABORT:
-                    bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
+                    spiReleaseBus(bus);
                     segmentComplete = false;
                     return;
 
@@ -699,7 +701,7 @@ void spiSequenceStart(const extDevice_t *dev)
             spiSequenceStart(nextDev);
         } else {
             // The end of the segment list has been reached, so mark transactions as complete
-            bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
+            spiReleaseBus(bus);
         }
     }
 }
@@ -327,6 +327,8 @@ void spiSequenceStart(const extDevice_t *dev)
 
     dev->bus->initSegment = true;
 
+    spiSequenceStats(dev);
+
     SPI_Cmd(instance, DISABLE);
 
     // Switch bus speed
@@ -403,7 +405,7 @@ void spiSequenceStart(const extDevice_t *dev)
                     break;
 
                 case BUS_ABORT:
-                    bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
+                    spiReleaseBus(bus);
                     return;
 
                 case BUS_READY:
@@ -426,7 +428,7 @@ void spiSequenceStart(const extDevice_t *dev)
             spiSequenceStart(nextDev);
         } else {
             // The end of the segment list has been reached, so mark transactions as complete
-            bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
+            spiReleaseBus(bus);
         }
     }
 }
@@ -109,9 +109,14 @@ static bool lis3mdlRead(magDev_t * mag, int16_t *magData)
     extDevice_t *dev = &mag->dev;
 
     if (pendingRead) {
-        busReadRegisterBufferStart(dev, LIS3MDL_REG_OUT_X_L, buf, sizeof(buf));
+        if (busReadRegisterBufferStart(dev, LIS3MDL_REG_OUT_X_L, buf, sizeof(buf))) {
+            pendingRead = false;
+        }
+        return false;
+    }
 
-        pendingRead = false;
+    if (busBusy(dev, NULL)) {
+        // Read still in progress
         return false;
     }
 
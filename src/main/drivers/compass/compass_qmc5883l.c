@@ -104,21 +104,30 @@ static bool qmc5883lRead(magDev_t *magDev, int16_t *magData)
     switch (state) {
         default:
         case STATE_READ_STATUS:
-            busReadRegisterBufferStart(dev, QMC5883L_REG_STATUS, &status, sizeof(status));
-            state = STATE_WAIT_STATUS;
+            if (busReadRegisterBufferStart(dev, QMC5883L_REG_STATUS, &status, sizeof(status))) {
+                state = STATE_WAIT_STATUS;
+            }
             return false;
 
         case STATE_WAIT_STATUS:
+            if (busBusy(dev, NULL)) {
+                return false;
+            }
+
             if ((status & 0x04) == 0) {
                 state = STATE_READ_STATUS;
                 return false;
             }
 
-            busReadRegisterBufferStart(dev, QMC5883L_REG_DATA_OUTPUT_X, buf, sizeof(buf));
-            state = STATE_WAIT_READ;
+            if (busReadRegisterBufferStart(dev, QMC5883L_REG_DATA_OUTPUT_X, buf, sizeof(buf))) {
+                state = STATE_WAIT_READ;
+            }
             return false;
 
         case STATE_WAIT_READ:
+            if (busBusy(dev, NULL)) {
+                return false;
+            }
 
             magData[X] = (int16_t)(buf[1] << 8 | buf[0]);
             magData[Y] = (int16_t)(buf[3] << 8 | buf[2]);
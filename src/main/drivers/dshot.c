@@ -103,6 +103,11 @@ uint32_t getDshotTelemetry(uint8_t index)
     return dshotTelemetryState.motorState[index].telemetryValue * 100;
 }
 
+uint32_t getDshotTelemetryFrameCount(uint8_t index)
+{
+    return dshotTelemetryState.motorState[index].telemetryFrames;
+}
+
 #endif
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
@@ -69,6 +69,7 @@ extern bool useDshotTelemetry;
 typedef struct dshotTelemetryMotorState_s {
     uint16_t telemetryValue;
     bool telemetryActive;
+    uint32_t telemetryFrames;
 } dshotTelemetryMotorState_t;
 
 
@@ -91,4 +92,5 @@ bool isDshotMotorTelemetryActive(uint8_t motorIndex);
 bool isDshotTelemetryActive(void);
 
 uint32_t getDshotTelemetry(uint8_t index);
+uint32_t getDshotTelemetryFrameCount(uint8_t index);
 int16_t getDshotTelemetryMotorInvalidPercent(uint8_t motorIndex);
@@ -471,6 +471,8 @@ static bool bbMotorConfig(IO_t io, uint8_t motorIndex, motorPwmProtocolTypes_e p
     bbMotors[motorIndex].output = output;
     bbMotors[motorIndex].bbPort = bbPort;
 
+    bbPort->inputPinMask |= (1 << pinIndex);
+
     IOInit(io, OWNER_MOTOR, RESOURCE_INDEX(motorIndex));
 
     // Setup GPIO_MODER and GPIO_ODR register manipulation values
@@ -506,49 +508,46 @@ static bool bbUpdateStart(void)
             return false;
         }
 
-        for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
+        for (int portIndex = 0; portIndex < usedMotorPorts; portIndex++) {
+            bbPort_t *bbPort = &bbPorts[portIndex];
+            uint32_t values[16];
+
 #ifdef USE_DSHOT_CACHE_MGMT
-            // Only invalidate the buffer once. If all motors are on a common port they'll share a buffer.
-            bool invalidated = false;
-            for (int i = 0; i < motorIndex; i++) {
-                if (bbMotors[motorIndex].bbPort->portInputBuffer == bbMotors[i].bbPort->portInputBuffer) {
-                    invalidated = true;
-                }
-            }
-            if (!invalidated) {
-                SCB_InvalidateDCache_by_Addr((uint32_t *)bbMotors[motorIndex].bbPort->portInputBuffer,
-                                             DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_BYTES);
-            }
+            SCB_InvalidateDCache_by_Addr((uint32_t *)bbPort->portInputBuffer,
+                                         DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_BYTES);
 #endif
+            // Decode all motors on the port in one pass over the input buffer
+            decode_bb_port(bbPort->portInputBuffer,
+                           bbPort->portInputCount - bbDMA_Count(bbPort),
+                           bbPort->inputPinMask,
+                           values);
+
+            for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
+                if (bbMotors[motorIndex].bbPort != bbPort) {
+                    continue;
+                }
 
-#ifdef STM32F4
-            uint32_t value = decode_bb_bitband(
-                bbMotors[motorIndex].bbPort->portInputBuffer,
-                bbMotors[motorIndex].bbPort->portInputCount - bbDMA_Count(bbMotors[motorIndex].bbPort),
-                bbMotors[motorIndex].pinIndex);
-#else
-            uint32_t value = decode_bb(
-                bbMotors[motorIndex].bbPort->portInputBuffer,
-                bbMotors[motorIndex].bbPort->portInputCount - bbDMA_Count(bbMotors[motorIndex].bbPort),
-                bbMotors[motorIndex].pinIndex);
-#endif
-            if (value == BB_NOEDGE) {
-                continue;
-            }
-            dshotTelemetryState.readCount++;
+                const uint32_t value = values[bbMotors[motorIndex].pinIndex];
 
-            if (value != BB_INVALID) {
-                dshotTelemetryState.motorState[motorIndex].telemetryValue = value;
-                dshotTelemetryState.motorState[motorIndex].telemetryActive = true;
-                if (motorIndex < 4) {
-                    DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, value);
+                if (value == BB_NOEDGE) {
+                    continue;
+                }
+                dshotTelemetryState.readCount++;
+
+                if (value != BB_INVALID) {
+                    dshotTelemetryState.motorState[motorIndex].telemetryValue = value;
+                    dshotTelemetryState.motorState[motorIndex].telemetryActive = true;
+                    dshotTelemetryState.motorState[motorIndex].telemetryFrames++;
+                    if (motorIndex < 4) {
+                        DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, value);
+                    }
+                } else {
+                    dshotTelemetryState.invalidPacketCount++;
                 }
-            } else {
-                dshotTelemetryState.invalidPacketCount++;
-            }
 #ifdef USE_DSHOT_TELEMETRY_STATS
-            updateDshotTelemetryQuality(&dshotTelemetryQuality[motorIndex], value != BB_INVALID, currentTimeMs);
+                updateDshotTelemetryQuality(&dshotTelemetryQuality[motorIndex], value != BB_INVALID, currentTimeMs);
 #endif
+            }
         }
     }
 #endif
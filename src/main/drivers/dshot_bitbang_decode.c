@@ -20,20 +20,6 @@
 
 #ifdef DEBUG_BBDECODE
 uint16_t bbBuffer[134];
-#endif
-
-
-/* Bit band SRAM definitions */
-#define BITBAND_SRAM_REF   0x20000000
-#define BITBAND_SRAM_BASE  0x22000000
-#define BITBAND_SRAM(a,b) ((BITBAND_SRAM_BASE + (((a)-BITBAND_SRAM_REF)<<5) + ((b)<<2)))  // Convert SRAM address
-
-typedef struct bitBandWord_s {
-    uint32_t value;
-    uint32_t junk[15];
-} bitBandWord_t;
-
-#ifdef DEBUG_BBDECODE
 uint32_t sequence[MAX_GCR_EDGES];
 int sequenceIndex = 0;
 #endif
@@ -88,208 +74,113 @@ static uint32_t decode_bb_value(uint32_t value, uint16_t buffer[], uint32_t coun
 }
 
 
-uint32_t decode_bb_bitband( uint16_t buffer[], uint32_t count, uint32_t bit)
-{
-#ifdef DEBUG_BBDECODE
-    memset(sequence, 0, sizeof(sequence));
-    sequenceIndex = 0;
-#endif
-    uint32_t value = 0;
+// Decode the telemetry frames of all pins in pinMask with a single pass over
+// the port sample buffer. XOR of consecutive port samples gives the edges of
+// every pin at once, so samples without any edge cost a load and a compare
+// regardless of the number of motors on the port. Per pin work is only done
+// on an actual edge. The result for each pin is stored in values[pin]: the
+// eRPM / 100, BB_NOEDGE if no frame was found or BB_INVALID if the frame
+// did not decode.
 
-    bitBandWord_t* p = (bitBandWord_t*)BITBAND_SRAM((uint32_t)buffer, bit);
-    bitBandWord_t* b = p;
-    bitBandWord_t* endP = p + (count - MIN_VALID_BBSAMPLES);
+FAST_CODE void decode_bb_port(uint16_t buffer[], uint32_t count, uint32_t pinMask, uint32_t values[])
+{
+    uint32_t value[16];
+    uint32_t bits[16];
+    uint32_t lastEdge[16];
+    uint32_t windowEnd[16];
 
-    // Eliminate leading high signal level by looking for first zero bit in data stream.
-    // Manual loop unrolling and branch hinting to produce faster code.
-    while (p < endP) {
-        if (__builtin_expect((!(p++)->value), 0) ||
-            __builtin_expect((!(p++)->value), 0) ||
-            __builtin_expect((!(p++)->value), 0) ||
-            __builtin_expect((!(p++)->value), 0)) {
-            break;
-        }
+    for (int pin = 0; pin < 16; pin++) {
+        values[pin] = BB_NOEDGE;
     }
 
-    if (p >= endP) {
-        // not returning telemetry is ok if the esc cpu is
-        // overburdened.  in that case no edge will be found and
-        // BB_NOEDGE indicates the condition to caller
-        return BB_NOEDGE;
+    if (count <= MIN_VALID_BBSAMPLES) {
+        return;
     }
 
-    int remaining = MIN(count - (p - b), (unsigned int)MAX_VALID_BBSAMPLES);
+    // Pins still waiting for the falling edge of the start bit
+    uint32_t waiting = pinMask & 0xffff;
+    // Pins with a frame in progress
+    uint32_t active = 0;
+    // Pins with a start bit found
+    uint32_t started = 0;
 
-    bitBandWord_t* oldP = p;
-    uint32_t bits = 0;
-    endP = p + remaining;
+    // A frame has to start early enough to fit in the rest of the buffer
+    const uint32_t startLimit = count - MIN_VALID_BBSAMPLES;
 
-#ifdef DEBUG_BBDECODE
-    sequence[sequenceIndex++] = p - b;
-#endif
+    // The line idles high, so assume the previous level was high on every pin
+    uint32_t lastSample = 0xffff;
 
-    while (endP > p) {
-        do {
-            // Look for next positive edge. Manual loop unrolling and branch hinting to produce faster code.
-            if(__builtin_expect((p++)->value, 0) ||
-               __builtin_expect((p++)->value, 0) ||
-               __builtin_expect((p++)->value, 0) ||
-               __builtin_expect((p++)->value, 0)) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (i == startLimit) {
+            waiting = 0;
+            if (!active) {
                 break;
             }
-        } while (endP > p);
-
-        if (endP > p) {
-
-#ifdef DEBUG_BBDECODE
-            sequence[sequenceIndex++] = p - b;
-#endif
-            // A level of length n gets decoded to a sequence of bits of
-            // the form 1000 with a length of (n+1) / 3 to account for 3x
-            // oversampling.
-            const int len = MAX((p - oldP + 1) / 3, 1);
-            bits += len;
-            value <<= len;
-            value |= 1 << (len - 1);
-            oldP = p;
+        }
 
-            // Look for next zero edge. Manual loop unrolling and branch hinting to produce faster code.
-            do {
-                if (__builtin_expect(!(p++)->value, 0) ||
-                    __builtin_expect(!(p++)->value, 0) ||
-                    __builtin_expect(!(p++)->value, 0) ||
-                    __builtin_expect(!(p++)->value, 0)) {
-                    break;
-                }
-            } while (endP > p);
+        const uint32_t sample = buffer[i];
+        uint32_t edges = (sample ^ lastSample) & (waiting | active);
+        lastSample = sample;
 
-            if (endP > p) {
+        if (__builtin_expect(!edges, 1)) {
+            continue;
+        }
 
-#ifdef DEBUG_BBDECODE
-                sequence[sequenceIndex++] = p - b;
-#endif
+        do {
+            const int pin = __builtin_ctz(edges);
+            const uint32_t bit = 1 << pin;
+            edges &= ~bit;
+
+            if (waiting & bit) {
+                // First edge of a waiting pin is always the falling edge of the start bit
+                waiting &= ~bit;
+                active |= bit;
+                started |= bit;
+                value[pin] = 0;
+                bits[pin] = 0;
+                lastEdge[pin] = i;
+                windowEnd[pin] = i + MIN(count - i - 1, (uint32_t)MAX_VALID_BBSAMPLES);
+            } else if (i >= windowEnd[pin]) {
+                active &= ~bit;
+            } else {
                 // A level of length n gets decoded to a sequence of bits of
                 // the form 1000 with a length of (n+1) / 3 to account for 3x
                 // oversampling.
-                const int len = MAX((p - oldP + 1) / 3, 1);
-                bits += len;
-                value <<= len;
-                value |= 1 << (len - 1);
-                oldP = p;
+                const int len = MAX((int)(i - lastEdge[pin] + 1) / 3, 1);
+                bits[pin] += len;
+                value[pin] <<= len;
+                value[pin] |= 1 << (len - 1);
+                lastEdge[pin] = i;
             }
-        }
-    }
-
-    if (bits < 18) {
-        return BB_NOEDGE;
-    }
-
-    // length of last sequence has to be inferred since the last bit with inverted dshot is high
-    const int nlen = 21 - bits;
-    if (nlen < 0) {
-        value = BB_INVALID;
-    }
+        } while (edges);
 
-#ifdef DEBUG_BBDECODE
-    sequence[sequenceIndex] = sequence[sequenceIndex] + (nlen) * 3;
-    sequenceIndex++;
-#endif
-    if (nlen > 0) {
-        value <<= nlen;
-        value |= 1 << (nlen - 1);
-    }
-    return decode_bb_value(value, buffer, count, bit);
-}
-
-FAST_CODE uint32_t decode_bb( uint16_t buffer[], uint32_t count, uint32_t bit)
-{
-#ifdef DEBUG_BBDECODE
-    memset(sequence, 0, sizeof(sequence));
-    sequenceIndex = 0;
-#endif
-    uint32_t mask = 1 << bit;
-
-#ifdef DEBUG_BBDECODE
-    uint32_t sequence[MAX_GCR_EDGES];
-    memset(sequence, 0, sizeof(sequence));
-    int sequenceIndex = 0;
-#endif
-
-    uint16_t lastValue = 0;
-    uint32_t value = 0;
-
-    uint16_t* p = buffer;
-    uint16_t* endP = p + count - MIN_VALID_BBSAMPLES;
-    // Eliminate leading high signal level by looking for first zero bit in data stream.
-    // Manual loop unrolling and branch hinting to produce faster code.
-    while (p < endP) {
-        if (__builtin_expect(!(*p++ & mask), 0) ||
-            __builtin_expect(!(*p++ & mask), 0) ||
-            __builtin_expect(!(*p++ & mask), 0) ||
-            __builtin_expect(!(*p++ & mask), 0)) {
+        if (!(waiting | active)) {
             break;
         }
     }
 
-    if(*p & mask) {
-        // not returning telemetry is ok if the esc cpu is
-        // overburdened.  in that case no edge will be found and
-        // BB_NOEDGE indicates the condition to caller
-        return BB_NOEDGE;
-    }
-
-    int remaining = MIN(count - (p - buffer), (unsigned int)MAX_VALID_BBSAMPLES);
-
-    uint16_t* oldP = p;
-    uint32_t bits = 0;
-    endP = p + remaining;
-
-#ifdef DEBUG_BBDECODE
-    sequence[sequenceIndex++] = p - buffer;
-#endif
+    while (started) {
+        const int pin = __builtin_ctz(started);
+        started &= ~(1 << pin);
 
-    while (endP > p ) {
-        // Look for next edge. Manual loop unrolling and branch hinting to produce faster code.
-        if (__builtin_expect((*p++ & mask) != lastValue, 0) ||
-            __builtin_expect((*p++ & mask) != lastValue, 0) ||
-            __builtin_expect((*p++ & mask) != lastValue, 0) ||
-            __builtin_expect((*p++ & mask) != lastValue, 0)) {
-            if (endP > p) {
-#ifdef DEBUG_BBDECODE
-                sequence[sequenceIndex++] = p - buffer;
-#endif
-                // A level of length n gets decoded to a sequence of bits of
-                // the form 1000 with a length of (n+1) / 3 to account for 3x
-                // oversampling.
-                const int len = MAX((p - oldP + 1) / 3,1);
-                bits += len;
-                value <<= len;
-                value |= 1 << (len - 1);
-                oldP = p;
-                lastValue = *(p-1) & mask;
-            }
+        if (bits[pin] < 18) {
+            continue;
         }
-    }
 
-    // length of last sequence has to be inferred since the last bit with inverted dshot is high
-    if (bits < 18) {
-        return BB_NOEDGE;
-    }
-
-    const int nlen = 21 - bits;
-#ifdef DEBUG_BBDECODE
-    sequence[sequenceIndex] = sequence[sequenceIndex] + (nlen) * 3;
-    sequenceIndex++;
-#endif
+        // length of last sequence has to be inferred since the last bit with inverted dshot is high
+        const int nlen = 21 - bits[pin];
+        uint32_t pinValue = value[pin];
 
-    if (nlen < 0) {
-        value = BB_INVALID;
-    }
-    if (nlen > 0) {
-        value <<= nlen;
-        value |= 1 << (nlen - 1);
+        if (nlen < 0) {
+            values[pin] = BB_INVALID;
+            continue;
+        }
+        if (nlen > 0) {
+            pinValue <<= nlen;
+            pinValue |= 1 << (nlen - 1);
+        }
+        values[pin] = decode_bb_value(pinValue, buffer, count, pin);
     }
-    return decode_bb_value(value, buffer, count, bit);
 }
 
 #endif
@@ -23,7 +23,6 @@
 #define BB_NOEDGE 0xfffe
 #define BB_INVALID 0xffff
 
-uint32_t decode_bb(uint16_t buffer[], uint32_t count, uint32_t mask);
-uint32_t decode_bb_bitband( uint16_t buffer[], uint32_t count, uint32_t bit);
+void decode_bb_port(uint16_t buffer[], uint32_t count, uint32_t pinMask, uint32_t values[]);
 
 #endif
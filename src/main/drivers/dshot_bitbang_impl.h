@@ -166,6 +166,7 @@ typedef struct bbPort_s {
 #endif
     uint16_t *portInputBuffer;
     uint32_t portInputCount;
+    uint16_t inputPinMask;   // Pins of the motors on this port
     bool inputActive;
 
     // Misc
@@ -154,6 +154,9 @@ static bool flashSpiInit(const flashConfig_t *flashConfig)
     // Set the callback argument when calling back to this driver for DMA completion
     dev->callbackArg = (uint32_t)&flashDevice;
 
+    // Blackbox writes and busy polling give way to other devices on the bus
+    spiSetPriority(dev, BUS_PRIORITY_LOW);
+
     IOInit(dev->busType_u.spi.csnPin, OWNER_FLASH_CS, 0);
     IOConfigGPIO(dev->busType_u.spi.csnPin, SPI_IO_CS_CFG);
     IOHi(dev->busType_u.spi.csnPin);
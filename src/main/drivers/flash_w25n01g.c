@@ -22,6 +22,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -131,12 +132,25 @@
 #define W28N01G_STATUS_PAGE_ADDRESS_SIZE    16
 #define W28N01G_STATUS_COLUMN_ADDRESS_SIZE  16
 
+// Page currently held in the chip data buffer for reading
+static uint32_t currentPage = UINT32_MAX;
+
+// Linear address of the last program or erase, for the failure check when it completes
+static uint32_t operationAddress = 0;
+
+// Block that failed to erase and is still to be replaced
+#define W25N01G_NO_BLOCK UINT16_MAX
+static uint16_t failedBlock = W25N01G_NO_BLOCK;
+
 typedef struct bblut_s {
     uint16_t pba;
     uint16_t lba;
 } bblut_t;
 
 static bool w25n01g_waitForReady(flashDevice_t *fdevice);
+static bool w25n01g_drainPages(void);
+static void w25n01g_replaceFailedBlock(flashDevice_t *fdevice);
+void w25n01g_addError(uint32_t address, uint8_t code);
 
 static void w25n01g_setTimeout(flashDevice_t *fdevice, uint32_t timeoutMillis)
 {
@@ -282,16 +296,40 @@ static void w25n01g_deviceReset(flashDevice_t *fdevice)
     w25n01g_writeRegister(io, W25N01G_CONF_REG, W25N01G_CONFIG_ECC_ENABLE|W25N01G_CONFIG_BUFFER_READ_MODE);
 }
 
-bool w25n01g_isReady(flashDevice_t *fdevice)
+static bool w25n01g_isChipReady(flashDevice_t *fdevice)
 {
+    // If we're waiting on DMA completion, then SPI is busy
+    if (fdevice->io.mode == FLASHIO_SPI && fdevice->io.handle.dev->bus->useDMA && spiIsBusy(fdevice->io.handle.dev)) {
+        return false;
+    }
+
     uint8_t status = w25n01g_readRegister(&fdevice->io, W25N01G_STAT_REG);
 
-    return ((status & W25N01G_STATUS_FLAG_BUSY) == 0);
+    if (status & W25N01G_STATUS_FLAG_BUSY) {
+        return false;
+    }
+
+    if (fdevice->couldBeBusy) {
+        // A program or erase has just completed, check how it went
+        fdevice->couldBeBusy = false;
+
+        if (status & W25N01G_STATUS_PROGRAM_FAIL) {
+            w25n01g_addError(operationAddress, W25N01G_STATUS_PROGRAM_FAIL);
+        }
+
+        // The block is replaced later from the top level, as this can be called while pages are serviced
+        if (status & W25N01G_STATUS_ERASE_FAIL) {
+            w25n01g_addError(operationAddress, W25N01G_STATUS_ERASE_FAIL);
+            failedBlock = W25N01G_LINEAR_TO_BLOCK(operationAddress);
+        }
+    }
+
+    return true;
 }
 
 static bool w25n01g_waitForReady(flashDevice_t *fdevice)
 {
-    while (!w25n01g_isReady(fdevice)) {
+    while (!w25n01g_isChipReady(fdevice)) {
         uint32_t now = millis();
         if (cmp32(now, fdevice->timeoutAt) >= 0) {
             return false;
@@ -380,9 +418,17 @@ bool w25n01g_detect(flashDevice_t *fdevice, uint32_t chipID)
  */
 void w25n01g_eraseSector(flashDevice_t *fdevice, uint32_t address)
 {
+    w25n01g_drainPages();
 
     w25n01g_waitForReady(fdevice);
 
+    w25n01g_replaceFailedBlock(fdevice);
+
+    // Remembered for the erase failure check
+    operationAddress = address;
+
+    currentPage = UINT32_MAX;
+
     w25n01g_writeEnable(fdevice);
 
     w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_BLOCK_ERASE, W25N01G_LINEAR_TO_PAGE(address));
@@ -432,105 +478,212 @@ static void w25n01g_programDataLoad(flashDevice_t *fdevice, uint16_t columnAddre
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
 }
 
-static void w25n01g_randomProgramDataLoad(flashDevice_t *fdevice, uint16_t columnAddress, const uint8_t *data, int length)
+static void w25n01g_programExecute(flashDevice_t *fdevice, uint32_t pageAddress)
 {
-    uint8_t cmd[] = { W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD, columnAddress >> 8, columnAddress & 0xff };
-
     w25n01g_waitForReady(fdevice);
 
+    w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, pageAddress);
+
+    w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
+}
+
+//
+// Writes are done in three steps:
+// (1) Load internal data buffer with data to write
+//     - We use "Load Program Data", which resets unused data bytes in the buffer to 0xff, so bytes of a
+//       partially written page that were programmed before are left unchanged.
+// (2) Enable write
+// (3) Issue "Execute Program"
+//
+// The chip has a single data buffer, which stays busy for the whole program execution (tPP up to 700us).
+// Rather than loading data into it piecemeal and stalling flashfs during every program execution, writes
+// are gathered in RAM page buffers. A page is loaded and programmed in one go once it is complete (or
+// flushed), while the next page fills up in the other buffer.
+//
+// Pages in a block must be programmed in order, so buffers are always programmed oldest first.
+//
+
+typedef enum {
+    W25N01G_PAGE_FREE = 0,          // Empty or filling up
+    W25N01G_PAGE_PENDING,           // Waiting for the chip to become ready
+    W25N01G_PAGE_PROGRAMMING,       // Loaded into the chip and being programmed
+} w25n01gPageState_e;
+
+typedef struct w25n01gPageBuffer_s {
+    flashDevice_t *fdevice;
+    uint32_t address;               // Linear address of the first buffered byte
+    uint16_t length;
+    w25n01gPageState_e state;
+} w25n01gPageBuffer_t;
+
+#define W25N01G_PAGE_BUFFERS 2
+
+static DMA_DATA_ZERO_INIT uint8_t pageData[W25N01G_PAGE_BUFFERS][W25N01G_PAGE_SIZE];
+static w25n01gPageBuffer_t pageBuffer[W25N01G_PAGE_BUFFERS];
+static uint8_t fillIndex = 0;
+
+static void w25n01g_programPage(w25n01gPageBuffer_t *page, const uint8_t *data)
+{
+    flashDevice_t *fdevice = page->fdevice;
+    const uint16_t columnAddress = W25N01G_LINEAR_TO_COLUMN(page->address);
+    const uint32_t pageAddress = W25N01G_LINEAR_TO_PAGE(page->address);
+
+    // The chip data buffer is overwritten, so whatever page was read into it is gone
+    currentPage = UINT32_MAX;
+
     if (fdevice->io.mode == FLASHIO_SPI) {
         extDevice_t *dev = fdevice->io.handle.dev;
 
-        busSegment_t segments[] = {
-                {.u.buffers = {cmd, NULL}, sizeof(cmd), false, NULL},
-                {.u.buffers = {(uint8_t *)data, NULL}, length, true, NULL},
+        // The segment list cannot be in automatic storage as this routine is non-blocking
+        STATIC_DMA_DATA_AUTO uint8_t writeEnable[] = { W25N01G_INSTRUCTION_WRITE_ENABLE };
+        STATIC_DMA_DATA_AUTO uint8_t programLoad[3] = { W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD };
+        STATIC_DMA_DATA_AUTO uint8_t programExecute[4] = { W25N01G_INSTRUCTION_PROGRAM_EXECUTE };
+
+        static busSegment_t segments[] = {
+                {.u.buffers = {writeEnable, NULL}, sizeof(writeEnable), true, NULL},
+                {.u.buffers = {programLoad, NULL}, sizeof(programLoad), false, NULL},
+                {.u.buffers = {NULL, NULL}, 0, true, NULL},
+                {.u.buffers = {programExecute, NULL}, sizeof(programExecute), true, NULL},
                 {.u.link = {NULL, NULL}, 0, true, NULL},
         };
 
+        // Ensure any prior DMA has completed before continuing
+        spiWait(dev);
+
+        programLoad[1] = columnAddress >> 8;
+        programLoad[2] = columnAddress & 0xff;
+
+        segments[2].u.buffers.txData = (uint8_t *)data;
+        segments[2].len = page->length;
+
+        programExecute[2] = (pageAddress >> 8) & 0xff;
+        programExecute[3] = (pageAddress >> 0) & 0xff;
+
+        segments[4].u.link.dev = NULL;
+        segments[4].u.link.segments = NULL;
+
+        // Load and program the page in the background
         spiSequence(dev, &segments[0]);
 
-        // Block pending completion of SPI access
-        spiWait(dev);
+        fdevice->couldBeBusy = true;
     }
 #ifdef USE_QUADSPI
     else if (fdevice->io.mode == FLASHIO_QUADSPI) {
-        QUADSPI_TypeDef *quadSpi = fdevice->io.handle.quadSpi;
+        w25n01g_writeEnable(fdevice);
 
-        quadSpiTransmitWithAddress1LINE(quadSpi, W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD, 0, columnAddress, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, data, length);
-     }
+        w25n01g_programDataLoad(fdevice, columnAddress, data, page->length);
+
+        w25n01g_programExecute(fdevice, pageAddress);
+    }
 #endif
 
+    // Remembered for the program failure check
+    operationAddress = page->address;
+
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
 
+    page->state = W25N01G_PAGE_PROGRAMMING;
 }
 
-static void w25n01g_programExecute(flashDevice_t *fdevice, uint32_t pageAddress)
+/**
+ * Move the page buffers along: release buffers whose program has completed and start programming
+ * the oldest pending one if the chip is idle.
+ */
+static void w25n01g_servicePages(void)
 {
-    w25n01g_waitForReady(fdevice);
+    for (unsigned n = 1; n <= W25N01G_PAGE_BUFFERS; n++) {
+        const unsigned index = (fillIndex + n) % W25N01G_PAGE_BUFFERS;
+        w25n01gPageBuffer_t *page = &pageBuffer[index];
 
-    w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, pageAddress);
+        if (page->state == W25N01G_PAGE_FREE) {
+            continue;
+        }
 
-    w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
+        if (!w25n01g_isChipReady(page->fdevice)) {
+            return;
+        }
+
+        if (page->state == W25N01G_PAGE_PROGRAMMING) {
+            page->state = W25N01G_PAGE_FREE;
+            page->length = 0;
+        } else {
+            w25n01g_programPage(page, &pageData[index][W25N01G_LINEAR_TO_COLUMN(page->address)]);
+            return;
+        }
+    }
 }
 
-//
-// Writes are done in three steps:
-// (1) Load internal data buffer with data to write
-//     - We use "Random Load Program Data", as "Load Program Data" resets unused data bytes in the buffer to 0xff.
-//     - Each "Random Load Program Data" instruction must be accompanied by at least a single data.
-//     - Each "Random Load Program Data" instruction terminates at the rising of CS.
-// (2) Enable write
-// (3) Issue "Execute Program"
-//
+/**
+ * Program all complete pages, waiting for the chip as needed. Data in the page being filled is kept.
+ */
+static bool w25n01g_drainPages(void)
+{
+    for (unsigned n = 1; n <= W25N01G_PAGE_BUFFERS; n++) {
+        const unsigned index = (fillIndex + n) % W25N01G_PAGE_BUFFERS;
+        w25n01gPageBuffer_t *page = &pageBuffer[index];
+
+        while (page->state != W25N01G_PAGE_FREE) {
+            if (!w25n01g_waitForReady(page->fdevice)) {
+                // Give up on the page rather than hanging
+                page->state = W25N01G_PAGE_FREE;
+                page->length = 0;
+                return false;
+            }
+            w25n01g_servicePages();
+        }
+    }
 
-/*
-flashfs page program behavior
-- Single program never crosses page boundary.
-- Except for this characteristic, it program arbitral size.
-- Write address is, naturally, not a page boundary.
-
-To cope with this behavior.
-
-pageProgramBegin:
-If buffer is dirty and programLoadAddress != address, then the last page is a partial write;
-issue PAGE_PROGRAM_EXECUTE to flash buffer contents, clear dirty and record the address as programLoadAddress and programStartAddress.
-Else do nothing.
-
-pageProgramContinue:
-Mark buffer as dirty.
-If programLoadAddress is on page boundary, then issue PROGRAM_LOAD_DATA, else issue RANDOM_PROGRAM_LOAD_DATA.
-Update programLoadAddress.
-Optionally observe the programLoadAddress, and if it's on page boundary, issue PAGE_PROGRAM_EXECUTE.
-
-pageProgramFinish:
-Observe programLoadAddress. If it's on page boundary, issue PAGE_PROGRAM_EXECUTE and clear dirty, else just return.
-If pageProgramContinue observes the page boundary, then do nothing(?).
-*/
-
-static uint32_t programStartAddress;
-static uint32_t programLoadAddress;
-bool bufferDirty = false;
-bool isProgramming = false;
+    return true;
+}
 
-void w25n01g_pageProgramBegin(flashDevice_t *fdevice, uint32_t address, void (*callback)(uint32_t length))
+/**
+ * Returns true if data can be accepted without blocking.
+ */
+bool w25n01g_isReady(flashDevice_t *fdevice)
 {
-    fdevice->callback = callback;
+    bool pagesBusy = false;
+    bool pageFree = false;
+
+    w25n01g_servicePages();
+
+    for (unsigned index = 0; index < W25N01G_PAGE_BUFFERS; index++) {
+        if (pageBuffer[index].state == W25N01G_PAGE_FREE) {
+            pageFree = true;
+        } else {
+            pagesBusy = true;
+        }
+    }
+
+    // While pages are being programmed, more data can be buffered. Otherwise the chip itself must be idle.
+    return pagesBusy ? pageFree : w25n01g_isChipReady(fdevice);
+}
 
-    if (bufferDirty) {
-        if (address != programLoadAddress) {
-            w25n01g_waitForReady(fdevice);
+static bool w25n01g_waitForPages(flashDevice_t *fdevice)
+{
+    if (!w25n01g_drainPages()) {
+        return false;
+    }
 
-            isProgramming = false;
+    if (!w25n01g_waitForReady(fdevice)) {
+        return false;
+    }
 
-            w25n01g_writeEnable(fdevice);
+    w25n01g_replaceFailedBlock(fdevice);
 
-            w25n01g_programExecute(fdevice, W25N01G_LINEAR_TO_PAGE(programStartAddress));
+    return true;
+}
 
-            bufferDirty = false;
-            isProgramming = true;
-        }
-    } else {
-        programStartAddress = programLoadAddress = address;
+void w25n01g_pageProgramBegin(flashDevice_t *fdevice, uint32_t address, void (*callback)(uint32_t length))
+{
+    w25n01gPageBuffer_t *page = &pageBuffer[fillIndex];
+
+    fdevice->callback = callback;
+    fdevice->currentWriteAddress = address;
+
+    if (page->state == W25N01G_PAGE_FREE && page->length &&
+        (page->fdevice != fdevice || page->address + page->length != address)) {
+        // Not a continuation of the buffered data, so program the partial page first
+        page->state = W25N01G_PAGE_PENDING;
     }
 }
 
@@ -541,45 +694,51 @@ uint32_t w25n01g_pageProgramContinue(flashDevice_t *fdevice, uint8_t const **buf
         return 0;
     }
 
-    w25n01g_waitForReady(fdevice);
+    w25n01gPageBuffer_t *page = &pageBuffer[fillIndex];
 
-    w25n01g_writeEnable(fdevice);
+    if (page->state != W25N01G_PAGE_FREE) {
+        fillIndex = (fillIndex + 1) % W25N01G_PAGE_BUFFERS;
+        page = &pageBuffer[fillIndex];
 
-    isProgramming = false;
+        // Only happens if the caller didn't check for readiness first
+        while (page->state != W25N01G_PAGE_FREE) {
+            w25n01g_waitForReady(page->fdevice);
+            w25n01g_servicePages();
+        }
+    }
 
-    if (!bufferDirty) {
-        w25n01g_programDataLoad(fdevice, W25N01G_LINEAR_TO_COLUMN(programLoadAddress), buffers[0], bufferSizes[0]);
-    } else {
-        w25n01g_randomProgramDataLoad(fdevice, W25N01G_LINEAR_TO_COLUMN(programLoadAddress), buffers[0], bufferSizes[0]);
+    if (page->length == 0) {
+        page->fdevice = fdevice;
+        page->address = fdevice->currentWriteAddress;
+    }
+
+    uint8_t *data = &pageData[fillIndex][W25N01G_LINEAR_TO_COLUMN(page->address)];
+    uint32_t written = 0;
+
+    for (uint32_t i = 0; i < bufferCount; i++) {
+        memcpy(data + page->length, buffers[i], bufferSizes[i]);
+        page->length += bufferSizes[i];
+        written += bufferSizes[i];
     }
 
-    // XXX Test if write enable is reset after each data loading.
+    fdevice->currentWriteAddress += written;
 
-    bufferDirty = true;
-    programLoadAddress += bufferSizes[0];
+    if (W25N01G_LINEAR_TO_COLUMN(page->address + page->length) == 0) {
+        page->state = W25N01G_PAGE_PENDING;
+    }
 
     if (fdevice->callback) {
-        fdevice->callback(bufferSizes[0]);
+        fdevice->callback(written);
     }
 
-    return bufferSizes[0];
+    return written;
 }
 
-static uint32_t currentPage = UINT32_MAX;
-
 void w25n01g_pageProgramFinish(flashDevice_t *fdevice)
 {
-    if (bufferDirty && W25N01G_LINEAR_TO_COLUMN(programLoadAddress) == 0) {
-
-        currentPage = W25N01G_LINEAR_TO_PAGE(programStartAddress); // reset page to the page being written
-
-        w25n01g_programExecute(fdevice, W25N01G_LINEAR_TO_PAGE(programStartAddress));
+    UNUSED(fdevice);
 
-        bufferDirty = false;
-        isProgramming = true;
-
-        programStartAddress = programLoadAddress;
-    }
+    w25n01g_servicePages();
 }
 
 /**
@@ -589,10 +748,7 @@ void w25n01g_pageProgramFinish(flashDevice_t *fdevice)
  *
  * Length must be smaller than the page size.
  *
- * This will wait for the flash to become ready before writing begins.
- *
- * Datasheet indicates typical programming time is 0.8ms for 256 bytes, 0.2ms for 64 bytes, 0.05ms for 16 bytes.
- * (Although the maximum possible write time is noted as 5ms).
+ * The data is buffered, call w25n01g_flush() to make sure it gets programmed.
  *
  * If you want to write multiple buffers (whose sum of sizes is still not more than the page size) then you can
  * break this operation up into one beginProgram call, one or more continueProgram calls, and one finishProgram call.
@@ -607,15 +763,26 @@ void w25n01g_pageProgram(flashDevice_t *fdevice, uint32_t address, const uint8_t
 
 void w25n01g_flush(flashDevice_t *fdevice)
 {
-    if (bufferDirty) {
-        currentPage = W25N01G_LINEAR_TO_PAGE(programStartAddress); // reset page to the page being written
+    w25n01gPageBuffer_t *page = &pageBuffer[fillIndex];
 
-        w25n01g_programExecute(fdevice, W25N01G_LINEAR_TO_PAGE(programStartAddress));
+    UNUSED(fdevice);
 
-        bufferDirty = false;
-        isProgramming = true;
-    } else {
-        isProgramming = false;
+    if (page->state == W25N01G_PAGE_FREE && page->length) {
+        page->state = W25N01G_PAGE_PENDING;
+    }
+
+    // Start programming everything, the last program is left to complete in the background
+    for (unsigned n = 1; n <= W25N01G_PAGE_BUFFERS; n++) {
+        const unsigned index = (fillIndex + n) % W25N01G_PAGE_BUFFERS;
+
+        while (pageBuffer[index].state == W25N01G_PAGE_PENDING) {
+            if (!w25n01g_waitForReady(pageBuffer[index].fdevice)) {
+                pageBuffer[index].state = W25N01G_PAGE_FREE;
+                pageBuffer[index].length = 0;
+                break;
+            }
+            w25n01g_servicePages();
+        }
     }
 }
 
@@ -649,6 +816,9 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
 {
     uint32_t targetPage = W25N01G_LINEAR_TO_PAGE(address);
 
+    // Buffered pages must reach the array first
+    w25n01g_drainPages();
+
     if (currentPage != targetPage) {
         if (!w25n01g_waitForReady(fdevice)) {
             return 0;
@@ -686,7 +856,7 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
 
         busSegment_t segments[] = {
                 {.u.buffers = {cmd, NULL}, sizeof(cmd), false, NULL},
-                {.u.buffers = {NULL, buffer}, length, true, NULL},
+                {.u.buffers = {NULL, buffer}, transferLength, true, NULL},
                 {.u.link = {NULL, NULL}, 0, true, NULL},
         };
 
@@ -699,8 +869,8 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
     else if (fdevice->io.mode == FLASHIO_QUADSPI) {
         QUADSPI_TypeDef *quadSpi = fdevice->io.handle.quadSpi;
 
-        //quadSpiReceiveWithAddress1LINE(quadSpi, W25N01G_INSTRUCTION_READ_DATA, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, length);
-        quadSpiReceiveWithAddress4LINES(quadSpi, W25N01G_INSTRUCTION_FAST_READ_QUAD_OUTPUT, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, length);
+        //quadSpiReceiveWithAddress1LINE(quadSpi, W25N01G_INSTRUCTION_READ_DATA, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, transferLength);
+        quadSpiReceiveWithAddress4LINES(quadSpi, W25N01G_INSTRUCTION_FAST_READ_QUAD_OUTPUT, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, transferLength);
     }
 #endif
 
@@ -719,6 +889,8 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
     case 0: // Successful read, no ECC correction
         break;
     case 1: // Successful read with ECC correction
+        w25n01g_addError(address, eccCode);
+        break;
     case 2: // Uncorrectable ECC in a single page
     case 3: // Uncorrectable ECC in multiple pages
         w25n01g_addError(address, eccCode);
@@ -736,8 +908,15 @@ int w25n01g_readExtensionBytes(flashDevice_t *fdevice, uint32_t address, uint8_t
         return 0;
     }
 
+    currentPage = UINT32_MAX;
+
     w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PAGE_DATA_READ, W25N01G_LINEAR_TO_PAGE(address));
 
+    w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_READ_MS);
+    if (!w25n01g_waitForReady(fdevice)) {
+        return 0;
+    }
+
     uint32_t column = 2048;
 
     if (fdevice->io.mode == FLASHIO_SPI) {
@@ -789,7 +968,7 @@ const flashGeometry_t* w25n01g_getGeometry(flashDevice_t *fdevice)
 
 const flashVTable_t w25n01g_vTable = {
     .isReady = w25n01g_isReady,
-    .waitForReady = w25n01g_waitForReady,
+    .waitForReady = w25n01g_waitForPages,
     .eraseSector = w25n01g_eraseSector,
     .eraseCompletely = w25n01g_eraseCompletely,
     .pageProgramBegin = w25n01g_pageProgramBegin,
@@ -817,8 +996,8 @@ busStatus_e w25n01g_readBBLUTCallback(uint32_t arg)
     uint8_t *rxData = fdevice->io.handle.dev->bus->curSegment->u.buffers.rxData;
 
 
-    cb_context->bblut->pba = (rxData[0] << 16)|rxData[1];
-    cb_context->bblut->lba = (rxData[2] << 16)|rxData[3];
+    cb_context->bblut->pba = (rxData[0] << 8)|rxData[1];
+    cb_context->bblut->lba = (rxData[2] << 8)|rxData[3];
 
     if (++cb_context->lutindex < cb_context->lutsize) {
         cb_context->bblut++;
@@ -872,8 +1051,8 @@ void w25n01g_readBBLUT(flashDevice_t *fdevice, bblut_t *bblut, int lutsize)
 
         for (int i = 0, offset = 0 ; i < lutsize ; i++, offset += 4) {
             if (i < W25N01G_BBLUT_TABLE_ENTRY_COUNT) {
-                bblut[i].pba = (in[offset + 0] << 16)|in[offset + 1];
-                bblut[i].lba = (in[offset + 2] << 16)|in[offset + 3];
+                bblut[i].pba = (bblutBuffer[offset + 0] << 8)|bblutBuffer[offset + 1];
+                bblut[i].lba = (bblutBuffer[offset + 2] << 8)|bblutBuffer[offset + 3];
             }
         }
     }
@@ -914,6 +1093,73 @@ void w25n01g_writeBBLUT(flashDevice_t *fdevice, uint16_t lba, uint16_t pba)
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
 }
 
+/**
+ * Link a block that failed to erase to a good block in the replacement area, through the BB LUT.
+ * The chip then redirects all accesses to the block transparently.
+ */
+static void w25n01g_replaceBlock(flashDevice_t *fdevice, uint16_t block)
+{
+    bblut_t bblut[W25N01G_BBLUT_TABLE_ENTRY_COUNT];
+    uint8_t badBlockMarker;
+
+    if (block >= W25N01G_BB_MANAGEMENT_START_BLOCK) {
+        return;
+    }
+
+    if (w25n01g_readRegister(&fdevice->io, W25N01G_STAT_REG) & W25N01G_STATUS_BBM_LUT_FULL) {
+        return;
+    }
+
+    w25n01g_readBBLUT(fdevice, bblut, W25N01G_BBLUT_TABLE_ENTRY_COUNT);
+
+    for (uint16_t pba = W25N01G_BB_REPLACEMENT_START_BLOCK; pba < W25N01G_BLOCKS_PER_DIE; pba++) {
+        bool inUse = false;
+
+        for (int i = 0; i < W25N01G_BBLUT_TABLE_ENTRY_COUNT; i++) {
+            if ((bblut[i].lba & W25N01G_BBLUT_STATUS_ENABLED) && (bblut[i].pba & ~W25N01G_BBLUT_STATUS_MASK) == pba) {
+                inUse = true;
+                break;
+            }
+        }
+
+        if (inUse) {
+            continue;
+        }
+
+        // Skip blocks marked bad in the factory
+        if (w25n01g_readExtensionBytes(fdevice, W25N01G_BLOCK_TO_LINEAR(pba), &badBlockMarker, 1) != 1 || badBlockMarker != 0xFF) {
+            continue;
+        }
+
+        w25n01g_writeEnable(fdevice);
+        w25n01g_writeBBLUT(fdevice, block, pba);
+        w25n01g_waitForReady(fdevice);
+
+        // The block now maps to the replacement, which must be erased before use
+        operationAddress = W25N01G_BLOCK_TO_LINEAR(block);
+        currentPage = UINT32_MAX;
+        w25n01g_writeEnable(fdevice);
+        w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_BLOCK_ERASE, W25N01G_BLOCK_TO_PAGE(block));
+        w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS);
+        w25n01g_waitForReady(fdevice);
+
+        return;
+    }
+}
+
+/**
+ * Replace a block whose erase has failed. Only called from the top level with the page buffers drained
+ * and the chip idle, never from the ready check.
+ */
+static void w25n01g_replaceFailedBlock(flashDevice_t *fdevice)
+{
+    if (failedBlock != W25N01G_NO_BLOCK) {
+        const uint16_t block = failedBlock;
+        failedBlock = W25N01G_NO_BLOCK;
+        w25n01g_replaceBlock(fdevice, block);
+    }
+}
+
 static void w25n01g_deviceInit(flashDevice_t *flashdev)
 {
     // Adjust the SPI bus clock frequency
@@ -39,6 +39,7 @@
 
 #include "common/color.h"
 #include "common/colorconversion.h"
+#include "common/utils.h"
 
 #include "drivers/dma.h"
 #include "drivers/io.h"
@@ -79,10 +80,37 @@ uint32_t ledsWithInvertedLedFormat = 0;
 
 static hsvColor_t ledColorBuffer[WS2811_DATA_BUFFER_SIZE];
 
+// LEDs whose colour has changed since the last frame was built
+STATIC_ASSERT(WS2811_DATA_BUFFER_SIZE <= 32, ledsDirty_too_small);
+#define ALL_LEDS_DIRTY 0xFFFFFFFF
+static uint32_t ledsDirty = ALL_LEDS_DIRTY;
+
+static ledStripFormatRGB_e ledStripFormat;
+static uint8_t ledStripBrightness;
+
+// Colour bytes of the frame in wire order, streamed into the DMA buffer half by half
+static uint8_t ledStripFrame[WS2811_FRAME_BUFFER_SIZE];
+static unsigned ledStripFrameLength;
+static unsigned ledStripFramePosition;
+static bool ledStripHalfHasData[2];
+
+// Timer compare values for the four bits of each nibble, MSB first
+static uint32_t ws2811NibbleLUT[16][4];
+
+static void ledSetHsv(unsigned index, const hsvColor_t *color)
+{
+    hsvColor_t *led = &ledColorBuffer[index];
+
+    if (led->h != color->h || led->s != color->s || led->v != color->v) {
+        *led = *color;
+        ledsDirty |= (1U << index);
+    }
+}
+
 #if !defined(USE_WS2811_SINGLE_COLOUR)
 void setLedHsv(uint16_t index, const hsvColor_t *color)
 {
-    ledColorBuffer[index] = *color;
+    ledSetHsv(index, color);
 }
 
 void getLedHsv(uint16_t index, hsvColor_t *color)
@@ -92,32 +120,39 @@ void getLedHsv(uint16_t index, hsvColor_t *color)
 
 void setLedValue(uint16_t index, const uint8_t value)
 {
-    ledColorBuffer[index].v = value;
+    hsvColor_t color = ledColorBuffer[index];
+    color.v = value;
+    ledSetHsv(index, &color);
 }
 
 void scaleLedValue(uint16_t index, const uint8_t scalePercent)
 {
-    ledColorBuffer[index].v = ((uint16_t)ledColorBuffer[index].v * scalePercent / 100);
+    hsvColor_t color = ledColorBuffer[index];
+    color.v = ((uint16_t)color.v * scalePercent / 100);
+    ledSetHsv(index, &color);
 }
 
 void setLedsWithInvertedLedFormat(uint32_t leds)
 {
     // Adds support for RGB and GRB leds on the same strip.
-    ledsWithInvertedLedFormat = leds;
+    if (ledsWithInvertedLedFormat != leds) {
+        ledsWithInvertedLedFormat = leds;
+        ledsDirty = ALL_LEDS_DIRTY;
+    }
 }
 #endif
 
 void setStripColor(const hsvColor_t *color)
 {
     for (unsigned index = 0; index < usedLedCount; index++) {
-        ledColorBuffer[index] = *color;
+        ledSetHsv(index, color);
     }
 }
 
 void setStripColors(const hsvColor_t *colors)
 {
     for (unsigned index = 0; index < usedLedCount; index++) {
-        setLedHsv(index, colors++);
+        ledSetHsv(index, colors++);
     }
 }
 
@@ -130,6 +165,15 @@ void setUsedLedCount(unsigned ledCount)
     needsFullRefresh = true;
 }
 
+STATIC_UNIT_TESTED void ws2811BuildLUT(void)
+{
+    for (unsigned nibble = 0; nibble < 16; nibble++) {
+        for (unsigned bit = 0; bit < 4; bit++) {
+            ws2811NibbleLUT[nibble][bit] = (nibble & (0x08 >> bit)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+        }
+    }
+}
+
 void ws2811LedStripInit(ioTag_t ioTag)
 {
     memset(ledStripDMABuffer, 0, sizeof(ledStripDMABuffer));
@@ -144,6 +188,8 @@ void ws2811LedStripEnable(void)
             return;
         }
 
+        ws2811BuildLUT();
+
         const hsvColor_t hsv_black = { 0, 0, 0 };
         setStripColor(&hsv_black);
         // RGB or GRB ordering doesn't matter for black, use 4-channel LED configuraton to make sure all channels are zero
@@ -158,42 +204,93 @@ bool isWS2811LedStripReady(void)
     return ws2811Initialised && !ws2811LedDataTransferInProgress;
 }
 
-STATIC_UNIT_TESTED void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex)
+static unsigned ws2811BytesPerLed(ledStripFormatRGB_e ledFormat)
+{
+    return (ledFormat == LED_GRBW) ? 4 : 3;
+}
+
+STATIC_UNIT_TESTED void updateLEDFrameBuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex)
 {
-    uint32_t bits_per_led;
-    uint32_t packed_colour;
+    uint8_t *frame = &ledStripFrame[ledIndex * ws2811BytesPerLed(ledFormat)];
 
     switch (ledFormat) {
         case LED_RGB: // WS2811 drivers use RGB format
-            packed_colour = (color->rgb.r << 16) | (color->rgb.g << 8) | (color->rgb.b);
-            bits_per_led = 24;
+            frame[0] = color->rgb.r;
+            frame[1] = color->rgb.g;
+            frame[2] = color->rgb.b;
             break;
 
         case LED_GRBW: // SK6812 drivers use this
-        {
+            frame[0] = color->rgb.g;
+            frame[1] = color->rgb.r;
+            frame[2] = color->rgb.b;
             /* reconstruct white channel from RGB, making the intensity a bit nonlinear, but thats fine for this use case */
-            uint8_t white = MIN(MIN(color->rgb.r, color->rgb.g), color->rgb.b);
-            packed_colour = (color->rgb.g << 24) | (color->rgb.r << 16) | (color->rgb.b << 8) | (white);
-            bits_per_led = 32;
+            frame[3] = MIN(MIN(color->rgb.r, color->rgb.g), color->rgb.b);
             break;
-        }
 
         case LED_GRB: // WS2812 drivers use GRB format
         default:
-            packed_colour = (color->rgb.g << 16) | (color->rgb.r << 8) | (color->rgb.b);
-            bits_per_led = 24;
-        break;
+            frame[0] = color->rgb.g;
+            frame[1] = color->rgb.r;
+            frame[2] = color->rgb.b;
+            break;
+    }
+}
+
+static FAST_CODE void ws2811FillDMABuffer(unsigned half)
+{
+    uint32_t *buffer = &ledStripDMABuffer[half * WS2811_DMA_HALF_SIZE];
+    unsigned count = 0;
+
+    while (count < WS2811_DMA_HALF_BYTES && ledStripFramePosition < ledStripFrameLength) {
+        const uint8_t byte = ledStripFrame[ledStripFramePosition++];
+        memcpy(&buffer[count * 8 + 0], ws2811NibbleLUT[byte >> 4], sizeof(ws2811NibbleLUT[0]));
+        memcpy(&buffer[count * 8 + 4], ws2811NibbleLUT[byte & 0x0F], sizeof(ws2811NibbleLUT[0]));
+        count++;
     }
 
-    unsigned dmaBufferOffset = 0;
-    for (int index = bits_per_led-1; index >= 0; index--) {
-        ledStripDMABuffer[ledIndex * bits_per_led + dmaBufferOffset++] = (packed_colour & (1 << index)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+    // Hold the line low after the frame to latch the colours
+    if (count < WS2811_DMA_HALF_BYTES) {
+        memset(&buffer[count * 8], 0, (WS2811_DMA_HALF_BYTES - count) * 8 * sizeof(uint32_t));
     }
+
+    ledStripHalfHasData[half] = (count > 0);
+
+#ifdef USE_LEDSTRIP_CACHE_MGMT
+    SCB_CleanDCache_by_Addr(buffer, WS2811_DMA_HALF_SIZE * sizeof(uint32_t));
+#endif
+}
+
+STATIC_UNIT_TESTED void ws2811PrepareDMABuffer(unsigned frameLength)
+{
+    ledStripFrameLength = frameLength;
+    ledStripFramePosition = 0;
+
+    ws2811FillDMABuffer(0);
+    ws2811FillDMABuffer(1);
+}
+
+/*
+ * Called from the DMA interrupt when one half of the circular buffer has been sent.
+ * The half is refilled with the next part of the frame while the other half is
+ * being sent. Returns false once a half with no colour data has gone out, as the
+ * reset period is complete and the DMA can be stopped.
+ */
+FAST_CODE bool ws2811UpdateDMABuffer(unsigned half)
+{
+    if (!ledStripHalfHasData[half]) {
+        return false;
+    }
+
+    ws2811FillDMABuffer(half);
+
+    return true;
 }
 
 /*
  * This method is non-blocking unless an existing LED update is in progress.
  * it does not wait until all the LEDs have been updated, that happens in the background.
+ * Only the LEDs that have changed are converted, and nothing is sent if none have.
  */
 void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat, uint8_t brightness)
 {
@@ -203,26 +300,44 @@ void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat, uint8_t brightness)
         return;
     }
 
-    unsigned ledIndex = 0;              // reset led index
+    if (ledFormat != ledStripFormat || brightness != ledStripBrightness || needsFullRefresh) {
+        ledStripFormat = ledFormat;
+        ledStripBrightness = brightness;
+        ledsDirty = ALL_LEDS_DIRTY;
+    }
+
+    // LEDs latch their colour, so an unchanged strip needs no update
+    if (!ledsDirty) {
+        return;
+    }
 
-    // fill transmit buffer with correct compare values to achieve
-    // correct pulse widths according to color values
+    // convert the changed LEDs to colour bytes in the frame buffer
     const unsigned ledUpdateCount = needsFullRefresh ? WS2811_DATA_BUFFER_SIZE : usedLedCount;
     const hsvColor_t hsvBlack = { 0, 0, 0 };
-    while (ledIndex < ledUpdateCount) {
-        hsvColor_t scaledLed = ledIndex < usedLedCount ? ledColorBuffer[ledIndex] : hsvBlack;
-        // Scale the LED brightness
-        scaledLed.v = scaledLed.v * brightness / 100;
+    for (unsigned ledIndex = 0; ledIndex < ledUpdateCount; ledIndex++) {
+        if (ledsDirty & (1U << ledIndex)) {
+            hsvColor_t scaledLed = ledIndex < usedLedCount ? ledColorBuffer[ledIndex] : hsvBlack;
+            // Scale the LED brightness
+            scaledLed.v = scaledLed.v * brightness / 100;
 
-        rgbColor24bpp_t *rgb24 = hsvToRgb24(&scaledLed);
+            rgbColor24bpp_t *rgb24 = hsvToRgb24(&scaledLed);
 
-        updateLEDDMABuffer(ledFormat ^ ((ledsWithInvertedLedFormat >> ledIndex) & 1), rgb24, ledIndex);
-        ++ledIndex;
+            updateLEDFrameBuffer(ledFormat ^ ((ledsWithInvertedLedFormat >> ledIndex) & 1), rgb24, ledIndex);
+        }
     }
+    ledsDirty = 0;
     needsFullRefresh = false;
 
-#ifdef USE_LEDSTRIP_CACHE_MGMT
-    SCB_CleanDCache_by_Addr(ledStripDMABuffer, WS2811_DMA_BUF_CACHE_ALIGN_BYTES);
+    const unsigned bytesPerLed = ws2811BytesPerLed(ledFormat);
+
+#if defined(USE_WS2811_SINGLE_COLOUR)
+    // Repeat the single colour along the whole strip
+    for (unsigned ledIndex = 1; ledIndex < WS2811_LED_STRIP_LENGTH; ledIndex++) {
+        memcpy(&ledStripFrame[ledIndex * bytesPerLed], ledStripFrame, bytesPerLed);
+    }
+    ws2811PrepareDMABuffer(WS2811_LED_STRIP_LENGTH * bytesPerLed);
+#else
+    ws2811PrepareDMABuffer(ledUpdateCount * bytesPerLed);
 #endif
 
     ws2811LedDataTransferInProgress = true;
@@ -30,17 +30,19 @@
 
 #if defined(USE_WS2811_SINGLE_COLOUR)
 #define WS2811_DATA_BUFFER_SIZE    1
-#define WS2811_DMA_BUFFER_SIZE     (WS2811_DATA_BUFFER_SIZE * WS2811_BITS_PER_LED_MAX)
-// Do 2 extra iterations of the DMA transfer with the output set to low to generate the > 50us delay.
-#define WS2811_DELAY_ITERATIONS    2
 #else
 #define WS2811_DATA_BUFFER_SIZE    WS2811_LED_STRIP_LENGTH
-// for 50us delay
-#define WS2811_DELAY_BUFFER_LENGTH 42
-// number of bytes needed is #LEDs * 24 bytes + 42 trailing bytes)
-#define WS2811_DMA_BUFFER_SIZE     (WS2811_DATA_BUFFER_SIZE * WS2811_BITS_PER_LED_MAX + WS2811_DELAY_BUFFER_LENGTH)
 #endif
 
+// colour bytes for the whole strip, in the order they are sent
+#define WS2811_FRAME_BUFFER_SIZE   (WS2811_LED_STRIP_LENGTH * WS2811_BITS_PER_LED_MAX / 8)
+
+// The frame is streamed through a circular DMA buffer of two halves, each
+// holding the timer compare values for WS2811_DMA_HALF_BYTES colour bytes.
+#define WS2811_DMA_HALF_BYTES      16
+#define WS2811_DMA_HALF_SIZE       (WS2811_DMA_HALF_BYTES * 8)
+#define WS2811_DMA_BUFFER_SIZE     (WS2811_DMA_HALF_SIZE * 2)
+
 #ifdef USE_LEDSTRIP_CACHE_MGMT
 // WS2811_DMA_BUFFER_SIZE is multiples of uint32_t
 // Number of bytes required for buffer
@@ -69,6 +71,7 @@ void ws2811LedStripEnable(void);
 
 bool ws2811LedStripHardwareInit(ioTag_t ioTag);
 void ws2811LedStripDMAEnable(void);
+bool ws2811UpdateDMABuffer(unsigned half);
 
 void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat, uint8_t brightness);
 
@@ -41,14 +41,35 @@ static IO_t ws2811IO = IO_NONE;
 
 static TIM_HandleTypeDef TimHandle;
 static uint16_t timerChannel = 0;
+static uint16_t dmaIndex = 0;
 
-FAST_IRQ_HANDLER void WS2811_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
+static void ws2811StopDMA(DMA_HandleTypeDef *hdma)
 {
-    HAL_DMA_IRQHandler(TimHandle.hdma[descriptor->userParam]);
     TIM_DMACmd(&TimHandle, timerChannel, DISABLE);
+    HAL_DMA_Abort(hdma);
+    TimHandle.State = HAL_TIM_STATE_READY;
     ws2811LedDataTransferInProgress = false;
 }
 
+static void ws2811DMAHalfComplete(DMA_HandleTypeDef *hdma)
+{
+    if (!ws2811UpdateDMABuffer(0)) {
+        ws2811StopDMA(hdma);
+    }
+}
+
+static void ws2811DMAComplete(DMA_HandleTypeDef *hdma)
+{
+    if (!ws2811UpdateDMABuffer(1)) {
+        ws2811StopDMA(hdma);
+    }
+}
+
+FAST_IRQ_HANDLER void WS2811_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
+{
+    HAL_DMA_IRQHandler(TimHandle.hdma[descriptor->userParam]);
+}
+
 bool ws2811LedStripHardwareInit(ioTag_t ioTag)
 {
     if (!ioTag) {
@@ -121,7 +142,7 @@ bool ws2811LedStripHardwareInit(ioTag_t ioTag)
     hdma_tim.Init.MemInc = DMA_MINC_ENABLE;
     hdma_tim.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
     hdma_tim.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
-    hdma_tim.Init.Mode = DMA_NORMAL;
+    hdma_tim.Init.Mode = DMA_CIRCULAR;
     hdma_tim.Init.Priority = DMA_PRIORITY_HIGH;
 #if !defined(STM32G4)
     hdma_tim.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
@@ -133,7 +154,7 @@ bool ws2811LedStripHardwareInit(ioTag_t ioTag)
     /* Set hdma_tim instance */
     hdma_tim.Instance = (DMA_ARCH_TYPE *)dmaRef;
 
-    uint16_t dmaIndex = timerDmaIndex(timerChannel);
+    dmaIndex = timerDmaIndex(timerChannel);
 
     /* Link hdma_tim to hdma[x] (channelx) */
     __HAL_LINKDMA(&TimHandle, hdma[dmaIndex], hdma_tim);
@@ -147,6 +168,9 @@ bool ws2811LedStripHardwareInit(ioTag_t ioTag)
         return false;
     }
 
+    // Setting the half transfer callback enables its interrupt in HAL_DMA_Start_IT()
+    hdma_tim.XferHalfCpltCallback = ws2811DMAHalfComplete;
+
     TIM_OC_InitTypeDef TIM_OCInitStructure;
 
     /* PWM1 Mode configuration: Channel1 */
@@ -183,6 +207,8 @@ void ws2811LedStripDMAEnable(void)
         ws2811LedDataTransferInProgress = false;
         return;
     }
+    /* Refill the second half on completion instead of ending the PWM pulse */
+    TimHandle.hdma[dmaIndex]->XferCpltCallback = ws2811DMAComplete;
     /* Reset timer counter */
     __HAL_TIM_SET_COUNTER(&TimHandle,0);
     /* Enable channel DMA requests */
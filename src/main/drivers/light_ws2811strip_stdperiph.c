@@ -20,7 +20,6 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <string.h>
 
 #include "platform.h"
 
@@ -47,29 +46,27 @@ static dmaResource_t *dmaRef = NULL;
 #endif
 static TIM_TypeDef *timer = NULL;
 
-static void WS2811_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor)
+static void ws2811StopDMA(dmaChannelDescriptor_t *descriptor)
 {
-#if defined(USE_WS2811_SINGLE_COLOUR)
-    static uint32_t counter = 0;
-#endif
+    xDMA_Cmd(descriptor->ref, DISABLE);
+    ws2811LedDataTransferInProgress = false;
+}
 
-    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
-#if defined(USE_WS2811_SINGLE_COLOUR)
-        counter++;
-        if (counter == WS2811_LED_STRIP_LENGTH) {
-            // Output low for 50us delay
-            memset(ledStripDMABuffer, 0, sizeof(ledStripDMABuffer));
-        } else if (counter == (WS2811_LED_STRIP_LENGTH + WS2811_DELAY_ITERATIONS)) {
-            counter = 0;
-            ws2811LedDataTransferInProgress = false;
-            xDMA_Cmd(descriptor->ref, DISABLE);
+// Disabling the stream also sets TCIF, which must not be taken as a buffer event
+static void WS2811_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor)
+{
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF);
+        if (ws2811LedDataTransferInProgress && !ws2811UpdateDMABuffer(0)) {
+            ws2811StopDMA(descriptor);
         }
-#else
-        ws2811LedDataTransferInProgress = false;
-        xDMA_Cmd(descriptor->ref, DISABLE);
-#endif
+    }
 
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        if (ws2811LedDataTransferInProgress && !ws2811UpdateDMABuffer(1)) {
+            ws2811StopDMA(descriptor);
+        }
     }
 }
 
@@ -190,15 +187,11 @@ bool ws2811LedStripHardwareInit(ioTag_t ioTag)
     DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
 #endif
 
-#if defined(USE_WS2811_SINGLE_COLOUR)
     DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
-#else
-    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
-#endif
 
     xDMA_Init(dmaRef, &DMA_InitStructure);
     TIM_DMACmd(timer, timerDmaSource(timerHardware->channel), ENABLE);
-    xDMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+    xDMA_ITConfig(dmaRef, DMA_IT_HT | DMA_IT_TC, ENABLE);
 
     return true;
 }
@@ -28,6 +28,8 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
+
 #include "pg/max7456.h"
 #include "pg/vcd.h"
 
@@ -203,10 +205,20 @@ uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 
 static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
 
+// Rows of the active layer which may differ from shadowBuffer. Rows not flagged
+// here are skipped by max7456DrawScreen() without comparing their characters.
+
+#define ALL_ROWS_DIRTY ((1 << VIDEO_LINES_PAL) - 1)
+
+static uint32_t dirtyRows = ALL_ROWS_DIRTY;
+
 //Max bytes to update in one call to max7456DrawScreen()
 
 #define MAX_BYTES2SEND          250
 #define MAX_BYTES2SEND_POLLED   12
+// Screen updates are split into chunks with CS negated between them so that higher priority
+// devices on the bus can preempt the transfer. Must be even as each register write is two bytes.
+#define MAX_BYTES_PER_CHUNK     64
 #define MAX_ENCODE_US           20
 #define MAX_ENCODE_US_POLLED    10
 
@@ -273,12 +285,27 @@ uint8_t max7456GetRowsCount(void)
 static void max7456ClearShadowBuffer(void)
 {
     memset(shadowBuffer, 0, maxScreenSize);
+    dirtyRows = ALL_ROWS_DIRTY;
+}
+
+// Flag the rows of a bulk updated layer which no longer match the shadowBuffer
+static void max7456MarkDirtyRows(const uint8_t *buffer)
+{
+    for (int row = 0; row < VIDEO_LINES_PAL; row++) {
+        const int offset = row * CHARS_PER_LINE;
+        if (memcmp(&buffer[offset], &shadowBuffer[offset], CHARS_PER_LINE)) {
+            dirtyRows |= (1 << row);
+        }
+    }
 }
 
 // Buffer is filled with the whitespace character (0x20)
 static void max7456ClearLayer(displayPortLayer_e layer)
 {
-    memset(getLayerBuffer(layer), 0x20, VIDEO_BUFFER_CHARS_PAL);
+    uint8_t *buffer = getLayerBuffer(layer);
+
+    memset(buffer, 0x20, VIDEO_BUFFER_CHARS_PAL);
+    max7456MarkDirtyRows(buffer);
 }
 
 void max7456ReInit(void)
@@ -360,6 +387,9 @@ max7456InitStatus_e max7456Init(const max7456Config_t *max7456Config, const vcdP
         return MAX7456_INIT_NOT_CONFIGURED;
     }
 
+    // Screen updates give way to other devices on the bus
+    spiSetPriority(dev, BUS_PRIORITY_LOW);
+
     IOInit(dev->busType_u.spi.csnPin, OWNER_OSD_CS, 0);
     IOConfigGPIO(dev->busType_u.spi.csnPin, SPI_IO_CS_CFG);
     IOHi(dev->busType_u.spi.csnPin);
@@ -494,7 +524,11 @@ void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c)
 {
     uint8_t *buffer = getActiveLayerBuffer();
     if (x < CHARS_PER_LINE && y < VIDEO_LINES_PAL) {
-        buffer[y * CHARS_PER_LINE + x] = c;
+        const int pos = y * CHARS_PER_LINE + x;
+        if (c != shadowBuffer[pos]) {
+            dirtyRows |= (1 << y);
+        }
+        buffer[pos] = c;
     }
 }
 
@@ -503,7 +537,11 @@ void max7456Write(uint8_t x, uint8_t y, const char *buff)
     if (y < VIDEO_LINES_PAL) {
         uint8_t *buffer = getActiveLayerBuffer();
         for (int i = 0; buff[i] && x + i < CHARS_PER_LINE; i++) {
-            buffer[y * CHARS_PER_LINE + x + i] = buff[i];
+            const int pos = y * CHARS_PER_LINE + x + i;
+            if ((uint8_t)buff[i] != shadowBuffer[pos]) {
+                dirtyRows |= (1 << y);
+            }
+            buffer[pos] = buff[i];
         }
     }
 }
@@ -520,6 +558,9 @@ bool max7456LayerSupported(displayPortLayer_e layer)
 bool max7456LayerSelect(displayPortLayer_e layer)
 {
     if (max7456LayerSupported(layer)) {
+        if (layer != activeLayer) {
+            dirtyRows = ALL_ROWS_DIRTY;
+        }
         activeLayer = layer;
         return true;
     } else {
@@ -531,6 +572,7 @@ bool max7456LayerCopy(displayPortLayer_e destLayer, displayPortLayer_e sourceLay
 {
     if ((sourceLayer != destLayer) && max7456LayerSupported(sourceLayer) && max7456LayerSupported(destLayer)) {
         memcpy(getLayerBuffer(destLayer), getLayerBuffer(sourceLayer), VIDEO_BUFFER_CHARS_PAL);
+        max7456MarkDirtyRows(getLayerBuffer(destLayer));
         return true;
     } else {
         return false;
@@ -615,10 +657,7 @@ bool max7456DrawScreen(void)
 {
     static uint16_t pos = 0;
     // This routine doesn't block so need to use static data
-    static busSegment_t segments[] = {
-            {.u.link = {NULL, NULL}, 0, true, NULL},
-            {.u.link = {NULL, NULL}, 0, true, NULL},
-    };
+    static busSegment_t segments[(MAX_BYTES2SEND + MAX_BYTES_PER_CHUNK - 1) / MAX_BYTES_PER_CHUNK + 1];
 
     if (!fontIsLoading) {
         uint8_t *buffer = getActiveLayerBuffer();
@@ -645,6 +684,31 @@ bool max7456DrawScreen(void)
 
         // Initialise the transfer buffer
         while ((spiBufIndex < maxSpiBufStartIndex) && (pos < posLimit) && (cmpTimeUs(micros(), startTime) < maxEncodeTime)) {
+            if ((pos % CHARS_PER_LINE) == 0) {
+                const uint32_t rowMask = 1 << (pos / CHARS_PER_LINE);
+
+                if (!(dirtyRows & rowMask)) {
+                    // Nothing changed on this row, so skip it entirely
+                    if (!setAddress) {
+                        setAddress = true;
+                        if (autoInc) {
+                            spiBuf[spiBufIndex++] = MAX7456ADD_DMDI;
+                            spiBuf[spiBufIndex++] = END_STRING;
+                        }
+                    }
+
+                    pos += CHARS_PER_LINE;
+                    if (pos >= maxScreenSize) {
+                        pos = 0;
+                        break;
+                    }
+                    continue;
+                }
+
+                // Clear before scanning so that later writes flag the row again
+                dirtyRows &= ~rowMask;
+            }
+
             if (buffer[pos] != shadowBuffer[pos]) {
                 if (buffer[pos] == 0xff) {
                     buffer[pos] = ' ';
@@ -702,8 +766,23 @@ bool max7456DrawScreen(void)
         }
 
         if (spiBufIndex) {
-            segments[0].u.buffers.txData = spiBuf;
-            segments[0].len = spiBufIndex;
+            busSegment_t *segment = &segments[0];
+
+            for (int offset = 0; offset < spiBufIndex; offset += MAX_BYTES_PER_CHUNK) {
+                segment->u.buffers.txData = &spiBuf[offset];
+                segment->u.buffers.rxData = NULL;
+                segment->len = MIN(spiBufIndex - offset, MAX_BYTES_PER_CHUNK);
+                segment->negateCS = true;
+                segment->callback = NULL;
+                segment++;
+            }
+
+            // Terminate the segment list
+            segment->u.link.dev = NULL;
+            segment->u.link.segments = NULL;
+            segment->len = 0;
+            segment->negateCS = true;
+            segment->callback = NULL;
 
             spiSequence(dev, &segments[0]);
 
@@ -38,6 +38,7 @@ typedef enum {
     PERSISTENT_OBJECT_RTC_HIGH,           // high 32 bits of rtcTime_t
     PERSISTENT_OBJECT_RTC_LOW,            // low 32 bits of rtcTime_t
     PERSISTENT_OBJECT_SERIALRX_BAUD,      // serial rx baudrate
+    PERSISTENT_OBJECT_SENSOR_PROBE,       // sensors missing on last boot
     PERSISTENT_OBJECT_COUNT,
 #ifdef USE_SPRACING_PERSISTENT_RTC_WORKAROUND
     // On SPRACING H7 firmware use this alternate location for all reset reasons interpreted by this firmware
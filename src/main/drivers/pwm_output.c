@@ -110,6 +110,16 @@ void pwmOutConfig(timerChannel_t *channel, const timerHardware_t *timerHardware,
     *channel->ccr = 0;
 }
 
+/*
+ * Wait until the timer's next update event is at least guard ticks away.
+ * The compare registers are preloaded, so channels written within that
+ * window all take effect together at the next update event.
+ */
+void pwmOutWaitUpdateClear(TIM_TypeDef *tim, uint32_t guard)
+{
+    while ((uint32_t)(tim->ARR - tim->CNT) < guard);
+}
+
 
 /* MOTORS */
 
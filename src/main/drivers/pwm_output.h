@@ -57,6 +57,7 @@ struct motorDevConfig_s;
 motorDevice_t *motorPwmDevInit(const struct motorDevConfig_s *motorDevConfig, uint8_t motorCount);
 
 void pwmOutConfig(timerChannel_t *channel, const timerHardware_t *timerHardware, uint32_t hz, uint16_t period, uint16_t value, uint8_t inversion);
+void pwmOutWaitUpdateClear(TIM_TypeDef *tim, uint32_t guard);
 
 pwmOutputPort_t *pwmGetMotors(void);
 bool pwmIsSynced(void);
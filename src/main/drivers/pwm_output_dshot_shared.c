@@ -224,6 +224,7 @@ FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(void)
                 if (value != 0xffff) {
                     dshotTelemetryState.motorState[i].telemetryValue = value;
                     dshotTelemetryState.motorState[i].telemetryActive = true;
+                    dshotTelemetryState.motorState[i].telemetryFrames++;
                     if (i < 4) {
                         DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i, value);
                     }
@@ -113,6 +113,9 @@ bool rxSpiDeviceInit(const rxSpiConfig_t *rxSpiConfig)
     IOConfigGPIO(rxCsPin, SPI_IO_CS_CFG);
     dev->busType_u.spi.csnPin = rxCsPin;
 
+    // Receiver packets must be read before the next one arrives
+    spiSetPriority(dev, BUS_PRIORITY_HIGH);
+
     // Set the clock phase/polarity
     spiSetClkPhasePolarity(dev, true);
     rxSpiNormalSpeed();
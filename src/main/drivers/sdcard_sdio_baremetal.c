@@ -44,8 +44,14 @@
 #include "drivers/sdmmc_sdio.h"
 
 // Use this to speed up writing to SDCARD... asyncfatfs has limited support for multiblock write
+#ifdef STM32H7
+#define FATFS_BLOCK_CACHE_SIZE 32
+#else
 #define FATFS_BLOCK_CACHE_SIZE 16
-uint8_t writeCache[512 * FATFS_BLOCK_CACHE_SIZE] __attribute__ ((aligned (4)));
+#endif
+// Written by DMA as a whole, so it must be in DMA accessible memory, word aligned
+// for the SDIO FIFO and cache line aligned on MCUs with a data cache
+static DMA_DATA_ZERO_INIT uint8_t writeCache[512 * FATFS_BLOCK_CACHE_SIZE] __attribute__ ((aligned (4)));
 uint32_t cacheCount = 0;
 
 void cache_write(uint8_t *buffer)
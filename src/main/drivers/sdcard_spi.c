@@ -540,6 +540,7 @@ static void sdcardSpi_init(const sdcardConfig_t *config, const spiPinConfig_t *s
     }
 
     spiSetBusInstance(&sdcard.dev, config->device);
+    spiSetPriority(&sdcard.dev, BUS_PRIORITY_LOW);
 
     IO_t chipSelectIO;
     if (config->chipSelectTag) {
@@ -107,6 +107,17 @@ void serialSetBaudRateCb(serialPort_t *serialPort, void (*cb)(serialPort_t *cont
     }
 }
 
+bool serialSetFrameCallback(serialPort_t *serialPort, serialFrameCallbackPtr cb)
+{
+    // Switch to frame reception if supported by the underlying driver,
+    // otherwise the port keeps delivering single bytes to rxCallback.
+    if (serialPort->vTable->setFrameCallback) {
+        return serialPort->vTable->setFrameCallback(serialPort, cb);
+    }
+
+    return false;
+}
+
 void serialWriteBufShim(void *instance, const uint8_t *data, int count)
 {
     serialWriteBuf((serialPort_t *)instance, data, count);
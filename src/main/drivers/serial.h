@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 #include "drivers/io.h"
 #include "drivers/io_types.h"
 #include "drivers/resource.h"
@@ -61,6 +63,9 @@ typedef enum {
 
 typedef void (*serialReceiveCallbackPtr)(uint16_t data, void *rxCallbackData);   // used by serial drivers to return frames to app
 typedef void (*serialIdleCallbackPtr)();
+// used by serial drivers to return everything received up to a line idle, frameTimeUs is the end of the last byte.
+// A frame wrapping around the receive buffer is returned in two calls with the same frameTimeUs.
+typedef void (*serialFrameCallbackPtr)(const uint8_t *data, uint16_t len, timeUs_t frameTimeUs, void *rxCallbackData);
 
 typedef struct serialPort_s {
 
@@ -85,6 +90,8 @@ typedef struct serialPort_s {
 
     serialIdleCallbackPtr idleCallback;
 
+    serialFrameCallbackPtr frameCallback;
+
     uint8_t identifier;
 } serialPort_t;
 
@@ -122,6 +129,8 @@ struct serialPortVTable {
     void (*setMode)(serialPort_t *instance, portMode_e mode);
     void (*setCtrlLineStateCb)(serialPort_t *instance, void (*cb)(void *instance, uint16_t ctrlLineState), void *context);
     void (*setBaudRateCb)(serialPort_t *instance, void (*cb)(serialPort_t *context, uint32_t baud), serialPort_t *context);
+    // Optional frame reception, replaces the per byte rxCallback.
+    bool (*setFrameCallback)(serialPort_t *instance, serialFrameCallbackPtr cb);
 
     void (*writeBuf)(serialPort_t *instance, const void *data, int count);
     // Optional functions used to buffer large writes.
@@ -138,6 +147,7 @@ void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate);
 void serialSetMode(serialPort_t *instance, portMode_e mode);
 void serialSetCtrlLineStateCb(serialPort_t *instance, void (*cb)(void *context, uint16_t ctrlLineState), void *context);
 void serialSetBaudRateCb(serialPort_t *instance, void (*cb)(serialPort_t *context, uint32_t baud), serialPort_t *context);
+bool serialSetFrameCallback(serialPort_t *instance, serialFrameCallbackPtr cb);
 bool isSerialTransmitBufferEmpty(const serialPort_t *instance);
 void serialPrint(serialPort_t *instance, const char *str);
 uint32_t serialGetBaudRate(serialPort_t *instance);
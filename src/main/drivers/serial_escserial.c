@@ -860,6 +860,7 @@ const struct serialPortVTable escSerialVTable[] = {
         .setMode = escSerialSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
+        .setFrameCallback = NULL,
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL
@@ -624,6 +624,7 @@ static const struct serialPortVTable softSerialVTable = {
     .setMode = softSerialSetMode,
     .setCtrlLineStateCb = NULL,
     .setBaudRateCb = NULL,
+    .setFrameCallback = NULL,
     .writeBuf = NULL,
     .beginWrite = NULL,
     .endWrite = NULL
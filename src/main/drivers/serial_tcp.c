@@ -268,6 +268,7 @@ static const struct serialPortVTable tcpVTable = {
         .setMode = NULL,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
+        .setFrameCallback = NULL,
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
@@ -32,16 +32,19 @@
 
 #ifdef USE_UART
 
+#include "build/atomic.h"
 #include "build/build_config.h"
 
 #include "common/utils.h"
 
 #include "drivers/dma.h"
 #include "drivers/dma_reqmap.h"
+#include "drivers/nvic.h"
 #include "drivers/rcc.h"
 #include "drivers/serial.h"
 #include "drivers/serial_uart.h"
 #include "drivers/serial_uart_impl.h"
+#include "drivers/time.h"
 
 #include "pg/serial_uart.h"
 
@@ -185,6 +188,86 @@ static uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
     }
 }
 
+static bool uartSetFrameCallback(serialPort_t *instance, serialFrameCallbackPtr cb)
+{
+    uartPort_t *uartPort = (uartPort_t *)instance;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        uartPort->port.rxCallback = NULL;
+        uartPort->port.frameCallback = cb;
+    }
+
+    uartReconfigure(uartPort);
+
+#ifdef USE_DMA
+    if (uartPort->rxDMAResource) {
+        // The UART interrupt is only used for the idle line in DMA mode
+        const uartHardware_t *hardware = ((uartDevice_t *)uartPort)->hardware;
+#if defined(STM32F7) || defined(STM32H7) || defined(STM32G4)
+        HAL_NVIC_SetPriority(hardware->rxIrq, NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
+        HAL_NVIC_EnableIRQ(hardware->rxIrq);
+#else
+        NVIC_InitTypeDef NVIC_InitStructure;
+
+        NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
+        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
+        NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
+        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+        NVIC_Init(&NVIC_InitStructure);
+#endif
+    }
+#endif
+
+    return true;
+}
+
+/*
+ * Called from the UART interrupt on line idle in frame mode.
+ * Hands everything received since the previous idle to the frame callback.
+ */
+void uartRxFrameIdle(uartPort_t *uartPort)
+{
+    serialPort_t *port = &uartPort->port;
+    const uint32_t size = port->rxBufferSize;
+    uint32_t head, tail;
+
+    // Idle is detected one character time after the last stop bit
+    const timeUs_t frameTimeUs = microsISR() - 10000000 / port->baudRate;
+
+#ifdef USE_DMA
+    if (uartPort->rxDMAResource) {
+#ifdef USE_HAL_DRIVER
+        const uint32_t rxDMAHead = __HAL_DMA_GET_COUNTER(uartPort->Handle.hdmarx);
+#else
+        const uint32_t rxDMAHead = xDMA_GetCurrDataCounter(uartPort->rxDMAResource);
+#endif
+        head = (size - rxDMAHead) % size;
+        tail = (size - uartPort->rxDMAPos) % size;
+    } else
+#endif
+    {
+        head = port->rxBufferHead;
+        tail = port->rxBufferTail;
+    }
+
+    if (head < tail) {
+        port->frameCallback((const uint8_t *)&port->rxBuffer[tail], size - tail, frameTimeUs, port->rxCallbackData);
+        tail = 0;
+    }
+    if (head > tail) {
+        port->frameCallback((const uint8_t *)&port->rxBuffer[tail], head - tail, frameTimeUs, port->rxCallbackData);
+    }
+
+#ifdef USE_DMA
+    if (uartPort->rxDMAResource) {
+        uartPort->rxDMAPos = size - head;
+    } else
+#endif
+    {
+        port->rxBufferTail = head;
+    }
+}
+
 static uint32_t uartTotalTxBytesFree(const serialPort_t *instance)
 {
     const uartPort_t *uartPort = (const uartPort_t*)instance;
@@ -300,6 +383,7 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
+        .setFrameCallback = uartSetFrameCallback,
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
@@ -171,6 +171,11 @@ void uartReconfigure(uartPort_t *uartPort)
             HAL_UART_Receive_DMA(&uartPort->Handle, (uint8_t*)uartPort->port.rxBuffer, uartPort->port.rxBufferSize);
 
             uartPort->rxDMAPos = __HAL_DMA_GET_COUNTER(&uartPort->rxDMAHandle);
+
+            if (uartPort->port.frameCallback) {
+                /* Frames are delimited by idle line detection */
+                SET_BIT(uartPort->USARTx->CR1, USART_CR1_IDLEIE);
+            }
         } else
 #endif
         {
@@ -305,7 +310,11 @@ FAST_IRQ_HANDLER void uartIrqHandler(uartPort_t *s)
 {
     UART_HandleTypeDef *huart = &s->Handle;
     /* UART in mode Receiver ---------------------------------------------------*/
-    if ((__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
+    if (
+#ifdef USE_DMA
+        !s->rxDMAResource &&
+#endif
+        (__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
         uint8_t rbyte = (uint8_t)(huart->Instance->RDR & (uint8_t) 0xff);
 
         if (s->port.rxCallback) {
@@ -380,6 +389,9 @@ FAST_IRQ_HANDLER void uartIrqHandler(uartPort_t *s)
     // UART reception idle detected
 
     if (__HAL_UART_GET_IT(huart, UART_IT_IDLE)) {
+        if (s->port.frameCallback) {
+            uartRxFrameIdle(s);
+        }
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
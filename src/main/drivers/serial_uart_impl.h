@@ -219,6 +219,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
 void uartIrqHandler(uartPort_t *s);
 
+void uartRxFrameIdle(uartPort_t *uartPort);
+
 void uartReconfigure(uartPort_t *uartPort);
 
 void uartConfigureDma(uartDevice_t *uartdev);
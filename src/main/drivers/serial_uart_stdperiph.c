@@ -132,6 +132,11 @@ void uartReconfigure(uartPort_t *uartPort)
             xDMA_Cmd(uartPort->rxDMAResource, ENABLE);
             USART_DMACmd(uartPort->USARTx, USART_DMAReq_Rx, ENABLE);
             uartPort->rxDMAPos = xDMA_GetCurrDataCounter(uartPort->rxDMAResource);
+
+            if (uartPort->port.frameCallback) {
+                // Frames are delimited by idle line detection
+                USART_ITConfig(uartPort->USARTx, USART_IT_IDLE, ENABLE);
+            }
         } else {
             USART_ClearITPendingBit(uartPort->USARTx, USART_IT_RXNE);
             USART_ITConfig(uartPort->USARTx, USART_IT_RXNE, ENABLE);
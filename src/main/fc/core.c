@@ -642,9 +642,7 @@ static void subTaskPosition(timeUs_t currentTimeUs)
 
 static void subTaskSetpoint(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
-
-    setpointUpdate();
+    setpointUpdate(currentTimeUs);
     rescueUpdate();
 }
 
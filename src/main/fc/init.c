@@ -179,6 +179,27 @@ void targetPreInit(void);
 
 uint8_t systemState = SYSTEM_STATE_INITIALISING;
 
+static timeUs_t bootStageTime[BOOT_STAGE_COUNT];
+
+static const char * const bootStageNames[BOOT_STAGE_COUNT] = {
+    "SYSTEM", "CONFIG", "HARDWARE", "SENSORS", "FLIGHT", "PERIPHERALS", "TASKS", "DEFERRED",
+};
+
+void bootStageMark(bootStage_e stage)
+{
+    bootStageTime[stage] = micros();
+}
+
+timeUs_t bootStageTimeUs(bootStage_e stage)
+{
+    return bootStageTime[stage];
+}
+
+const char *bootStageName(bootStage_e stage)
+{
+    return bootStageNames[stage];
+}
+
 #ifdef BUS_SWITCH_PIN
 void busSwitchInit(void)
 {
@@ -262,6 +283,8 @@ void init(void)
 
     systemInit();
 
+    bootStageMark(BOOT_STAGE_SYSTEM);
+
     // Initialize task data as soon as possible. Has to be done before tasksInit(),
     // and any init code that may try to modify task behaviour before tasksInit().
     tasksInitData();
@@ -391,6 +414,8 @@ void init(void)
 
     systemState |= SYSTEM_STATE_CONFIG_LOADED;
 
+    bootStageMark(BOOT_STAGE_CONFIG);
+
 #if defined(USE_BOARD_INFO)
     initBoardInformation();
 #endif
@@ -654,6 +679,8 @@ void init(void)
 
     initBoardAlignment(boardAlignment());
 
+    bootStageMark(BOOT_STAGE_HARDWARE);
+
     if (!sensorsAutodetect()) {
         // if gyro was not detected due to whatever reason, notify and don't arm.
         if (true
@@ -668,6 +695,8 @@ void init(void)
 
     systemState |= SYSTEM_STATE_SENSORS_READY;
 
+    bootStageMark(BOOT_STAGE_SENSORS);
+
     // Set the targetLooptime based on the detected gyro sampleRateHz and pid_process_denom
     gyroSetLooptime(pidConfig()->pid_process_denom, pidConfig()->filter_process_denom);
 
@@ -699,26 +728,12 @@ void init(void)
     pinioBoxInit(pinioBoxConfig());
 #endif
 
-    LED1_ON;
     LED0_OFF;
+    LED1_OFF;
     LED2_OFF;
 
-    for (int i = 0; i < 10; i++) {
-        LED1_TOGGLE;
-        LED0_TOGGLE;
-#if defined(USE_BEEPER)
-        delay(25);
-        if (!(beeperConfig()->beeper_off_flags & BEEPER_GET_FLAG(BEEPER_SYSTEM_INIT))) {
-            BEEP_ON;
-        }
-        delay(25);
-        BEEP_OFF;
-#else
-        delay(50);
-#endif
-    }
-    LED0_OFF;
-    LED1_OFF;
+    // Init beeps are played by the beeper task instead of blocking here
+    beeper(BEEPER_SYSTEM_INIT);
 
     imuInit();
 
@@ -784,9 +799,7 @@ void init(void)
         initFlags |= FLASH_INIT_ATTEMPTED;
     }
 #endif
-#ifdef USE_FLASHFS
-    flashfsInit();
-#endif
+    bootStageMark(BOOT_STAGE_FLIGHT);
 
 #ifdef USE_BLACKBOX
 #ifdef USE_SDCARD
@@ -983,7 +996,25 @@ void init(void)
 
     unusedPinsInit();
 
+    bootStageMark(BOOT_STAGE_PERIPHERALS);
+
     tasksInit();
 
     systemState |= SYSTEM_STATE_READY;
+
+    bootStageMark(BOOT_STAGE_TASKS);
+}
+
+/*
+ * Slow peripheral bring-up that is not needed by the flight path.
+ * Run once from the scheduler after init() has completed.
+ */
+void initDeferred(void)
+{
+#ifdef USE_FLASHFS
+    // Scanning for the start of free space can take a while on large chips
+    flashfsInit();
+#endif
+
+    bootStageMark(BOOT_STAGE_DEFERRED);
 }
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 typedef enum {
     SYSTEM_STATE_INITIALISING   = 0,
     SYSTEM_STATE_CONFIG_LOADED  = (1 << 0),
@@ -28,6 +30,23 @@ typedef enum {
     SYSTEM_STATE_READY          = (1 << 7)
 } systemState_e;
 
+typedef enum {
+    BOOT_STAGE_SYSTEM = 0,
+    BOOT_STAGE_CONFIG,
+    BOOT_STAGE_HARDWARE,
+    BOOT_STAGE_SENSORS,
+    BOOT_STAGE_FLIGHT,
+    BOOT_STAGE_PERIPHERALS,
+    BOOT_STAGE_TASKS,
+    BOOT_STAGE_DEFERRED,
+    BOOT_STAGE_COUNT
+} bootStage_e;
+
 extern uint8_t systemState;
 
 void init(void);
+void initDeferred(void);
+
+void bootStageMark(bootStage_e stage);
+timeUs_t bootStageTimeUs(bootStage_e stage);
+const char *bootStageName(bootStage_e stage);
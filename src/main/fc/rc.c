@@ -66,7 +66,9 @@ static FAST_DATA_ZERO_INIT float rcDeadband[4];
 
 static FAST_DATA_ZERO_INIT uint16_t currentRxRefreshRate;
 static FAST_DATA_ZERO_INIT float    averageRxRefreshRate;
+static FAST_DATA_ZERO_INIT float    averageRxJitter;
 static FAST_DATA_ZERO_INIT timeUs_t lastRxTimeUs;
+static FAST_DATA_ZERO_INIT timeUs_t lastRcFrameTimeUs;
 
 static FAST_DATA_ZERO_INIT uint32_t changeCount;
 static FAST_DATA_ZERO_INIT uint16_t repeatCount;
@@ -153,6 +155,12 @@ void updateRcRefreshRate(timeUs_t currentTimeUs)
 
     lastRxTimeUs = currentTimeUs;
 
+    // Frame arrival time, as accurately as the RX protocol can tell
+    lastRcFrameTimeUs = rxGetFrameTimeUs();
+    if (!lastRcFrameTimeUs) {
+        lastRcFrameTimeUs = currentTimeUs;
+    }
+
     DEBUG(RX_TIMING, 4, frameDeltaUs);
     DEBUG(RX_TIMING, 5, localDeltaUs);
     DEBUG(RX_TIMING, 6, frameAgeUs);
@@ -165,12 +173,14 @@ void updateRcRefreshRate(timeUs_t currentTimeUs)
 
     if (rxIsReceivingSignal() && currentRxRefreshRate > RX_REFRESH_RATE_MIN_US && currentRxRefreshRate < RX_REFRESH_RATE_MAX_US) {
         averageRxRefreshRate += (frameDeltaUs - averageRxRefreshRate) / RX_REFRESH_RATE_AVERAGING;
+        averageRxJitter += (fabsf(frameDeltaUs - averageRxRefreshRate) - averageRxJitter) / RX_REFRESH_RATE_AVERAGING;
         updateRcChange();
     }
 
     DEBUG(RX_TIMING, 0, averageRxRefreshRate);
     DEBUG(RX_TIMING, 1, averageRxRefreshRate * currentMult);
     DEBUG(RX_TIMING, 2, currentRxRefreshRate);
+    DEBUG(RX_TIMING, 3, averageRxJitter);
 }
 
 
@@ -212,6 +222,8 @@ void updateRcCommands(void)
     for (int axis = CONTROL_CHANNEL_COUNT; axis < MAX_SUPPORTED_RC_CHANNEL_COUNT; axis++) {
         rcCommand[axis] = rcInput[axis] - rcControlsConfig()->rc_center;
     }
+
+    setpointUpdateFrame(lastRcFrameTimeUs, averageRxJitter);
 }
 
 INIT_CODE void initRcProcessing(void)
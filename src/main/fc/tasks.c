@@ -46,9 +46,11 @@
 #include "drivers/vtx_common.h"
 
 #include "config/config.h"
+#include "config/config_eeprom.h"
 #include "fc/core.h"
 #include "fc/rc.h"
 #include "fc/dispatch.h"
+#include "fc/init.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 
@@ -148,7 +150,7 @@ static void taskHandleSerial(timeUs_t currentTimeUs)
     }
 #endif
     bool evaluateMspData = ARMING_FLAG(ARMED) ? MSP_SKIP_NON_MSP_DATA : MSP_EVALUATE_NON_MSP_DATA;
-    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply);
+    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessOutCommand, mspFcProcessReply);
 }
 
 #ifdef USE_ACC
@@ -303,6 +305,27 @@ static void taskCameraControl(uint32_t currentTime)
 }
 #endif
 
+#ifdef USE_CONFIG_JOURNAL_TASK
+// In-flight adjustments are saved in small steps; on the ground the disarm save handles it
+static void taskConfigJournal(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    if (ARMING_FLAG(ARMED) && isConfigDirty()) {
+        configJournalProcess();
+    }
+}
+#endif
+
+static void taskDeferredInit(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    initDeferred();
+
+    setTaskEnabled(TASK_DEFERRED_INIT, false);
+}
+
 #define DEFINE_TASK(taskNameParam, subTaskNameParam, checkFuncParam, taskFuncParam, desiredPeriodParam, staticPriorityParam) {  \
     .taskName = taskNameParam, \
     .subTaskName = subTaskNameParam, \
@@ -409,6 +432,12 @@ task_attribute_t task_attributes[TASK_COUNT] = {
 #ifdef USE_CRSF_V3
     [TASK_SPEED_NEGOTIATION] = DEFINE_TASK("SPEED_NEGOTIATION", NULL, NULL, speedNegotiationProcess, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
 #endif
+
+#ifdef USE_CONFIG_JOURNAL_TASK
+    [TASK_CONFIG_JOURNAL] = DEFINE_TASK("CONFIG_JOURNAL", NULL, NULL, taskConfigJournal, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOWEST),
+#endif
+
+    [TASK_DEFERRED_INIT] = DEFINE_TASK("DEFERRED_INIT", NULL, NULL, taskDeferredInit, TASK_PERIOD_HZ(10), TASK_PRIORITY_LOW),
 };
 
 task_t *getTask(unsigned taskId)
@@ -557,5 +586,11 @@ void tasksInit(void)
     const bool useCRSF = rxRuntimeState.serialrxProvider == SERIALRX_CRSF;
     setTaskEnabled(TASK_SPEED_NEGOTIATION, useCRSF);
 #endif
+
+#ifdef USE_CONFIG_JOURNAL_TASK
+    setTaskEnabled(TASK_CONFIG_JOURNAL, true);
+#endif
+
+    setTaskEnabled(TASK_DEFERRED_INIT, true);
 }
 
@@ -63,6 +63,33 @@ typedef enum {
     RPM_SRC_ESC_SENSOR,
 } rpmSource_e;
 
+typedef struct {
+    float       rpm;            // Estimated RPM at sampleUs
+    float       slope;          // Estimated RPM rate of change [RPM/s]
+    float       quality;        // Prediction quality 0..1
+    float       confidence;     // Published confidence 0..1
+    timeUs_t    sampleUs;       // Capture time of the newest sample used
+    timeUs_t    escSampleUs;    // Capture time of the last ESC sensor sample
+    timeUs_t    frameUs;        // Time the main source last delivered a valid frame
+    uint32_t    frameCount;     // Valid frame count of the main source at frameUs
+    bool        valid;
+} rpmEstimator_t;
+
+// Longest time an RPM estimate is extrapolated past its last sample
+#define RPM_EST_MAX_PREDICT_US      100000
+// Samples older than this are considered lost
+#define RPM_EST_TIMEOUT_US          500000
+// DShot telemetry without a valid frame for this long has dropped out
+#define RPM_EST_DROPOUT_US          10000
+// Slope smoothing for sources sampled on every PID cycle
+#define RPM_EST_SLOPE_GAIN_FAST     0.01f
+// Slope smoothing for slow serial telemetry sources
+#define RPM_EST_SLOPE_GAIN_SLOW     0.5f
+// Quality tracking gain
+#define RPM_EST_QUALITY_GAIN        0.05f
+// RPM below which the relative prediction error is not meaningful
+#define RPM_EST_MIN_RPM             100.0f
+
 
 static FAST_DATA_ZERO_INIT uint8_t        motorCount;
 
@@ -73,6 +100,8 @@ static FAST_DATA_ZERO_INIT float          motorRpm[MAX_SUPPORTED_MOTORS];
 static FAST_DATA_ZERO_INIT float          motorRpmRaw[MAX_SUPPORTED_MOTORS];
 static FAST_DATA_ZERO_INIT uint8_t        motorRpmDiv[MAX_SUPPORTED_MOTORS];
 static FAST_DATA_ZERO_INIT uint8_t        motorRpmSource[MAX_SUPPORTED_MOTORS];
+static FAST_DATA_ZERO_INIT uint8_t        motorRpmAuxSource[MAX_SUPPORTED_MOTORS];
+static FAST_DATA_ZERO_INIT rpmEstimator_t motorRpmEst[MAX_SUPPORTED_MOTORS];
 static FAST_DATA_ZERO_INIT filter_t       motorRpmFilter[MAX_SUPPORTED_MOTORS];
 
 static FAST_DATA_ZERO_INIT float          headSpeed;
@@ -152,6 +181,11 @@ float getMotorRawRPMf(uint8_t motor)
     return motorRpmRaw[motor];
 }
 
+float getMotorRPMConfidence(uint8_t motor)
+{
+    return motorRpmEst[motor].confidence;
+}
+
 int calcMotorRPM(uint8_t motor, int erpm)
 {
     return erpm / motorRpmDiv[motor];
@@ -208,6 +242,17 @@ INIT_CODE void rpmSourceInit(void)
 #endif
             motorRpmSource[i] = RPM_SRC_NONE;
 
+#ifdef USE_ESC_SENSOR
+        // Serial ESC telemetry covers for the fast sources if they drop out
+        if (motorRpmSource[i] != RPM_SRC_NONE && motorRpmSource[i] != RPM_SRC_ESC_SENSOR &&
+            featureIsEnabled(FEATURE_ESC_SENSOR) && isEscSensorActive())
+            motorRpmAuxSource[i] = RPM_SRC_ESC_SENSOR;
+        else
+#endif
+            motorRpmAuxSource[i] = RPM_SRC_NONE;
+
+        memset(&motorRpmEst[i], 0, sizeof(rpmEstimator_t));
+
         motorRpmDiv[i] = constrain(motorConfig()->motorPoleCount[i] / 2, 1, 100);
 
         motorRpmFactor[i] = 1.0f + motorConfig()->motorRpmFactor[i] / 100000.0f;
@@ -239,22 +284,22 @@ INIT_CODE void motorInit(void)
 
 /*** Runtime functions ***/
 
-static float getSensorRPMf(uint8_t motor)
+static float getSensorRPMf(uint8_t motor, uint8_t source)
 {
     float erpm;
 
 #ifdef USE_FREQ_SENSOR
-    if (motorRpmSource[motor] == RPM_SRC_FREQ_SENSOR)
+    if (source == RPM_SRC_FREQ_SENSOR)
         erpm = getFreqSensorFreq(motor) * 60;
     else
 #endif
 #ifdef USE_DSHOT_TELEMETRY
-    if (motorRpmSource[motor] == RPM_SRC_DSHOT_TELEM)
+    if (source == RPM_SRC_DSHOT_TELEM)
         erpm = getDshotTelemetry(motor);
     else
 #endif
 #ifdef USE_ESC_SENSOR
-    if (motorRpmSource[motor] == RPM_SRC_ESC_SENSOR)
+    if (source == RPM_SRC_ESC_SENSOR)
         erpm = getEscSensorRPM(motor);
     else
 #endif
@@ -263,8 +308,146 @@ static float getSensorRPMf(uint8_t motor)
     return motorRpmFactor[motor] * erpm / motorRpmDiv[motor];
 }
 
+/*
+ * RPM estimator
+ *
+ * Each RPM sample is stored with its capture time. The estimator tracks
+ * RPM and its rate of change (alpha-beta filter with alpha = 1), so the
+ * RPM can be predicted for the current PID cycle even if the last sample
+ * is several milliseconds old. Frequency sensor and DShot telemetry are
+ * sampled on every motor update, while serial ESC telemetry arrives at
+ * a much lower rate, and its frames are timestamped when received.
+ */
+
+static void rpmEstimatorReset(rpmEstimator_t *est, float rpm, timeUs_t sampleUs)
+{
+    est->rpm = rpm;
+    est->slope = 0;
+    est->quality = 0.5f;
+    est->sampleUs = sampleUs;
+    est->valid = true;
+}
+
+static void rpmEstimatorSample(rpmEstimator_t *est, float rpm, timeUs_t sampleUs, float slopeGain)
+{
+    const timeDelta_t deltaUs = cmpTimeUs(sampleUs, est->sampleUs);
+
+    if (!est->valid || deltaUs > RPM_EST_TIMEOUT_US || -deltaUs > RPM_EST_TIMEOUT_US) {
+        rpmEstimatorReset(est, rpm, sampleUs);
+        return;
+    }
+
+    const float dT = deltaUs * 1e-6f;
+    const float predicted = est->rpm + est->slope * dT;
+    const float residual = rpm - predicted;
+    const float error = fabsf(residual) / fmaxf(fabsf(predicted), RPM_EST_MIN_RPM);
+
+    est->quality += RPM_EST_QUALITY_GAIN * (fmaxf(1 - 10 * error, 0) - est->quality);
+
+    if (deltaUs > 0) {
+        est->slope += slopeGain * residual / dT;
+        est->rpm = rpm;
+        est->sampleUs = sampleUs;
+    }
+    else {
+        // Late sample, only shift the estimate by its residual
+        est->rpm += residual;
+    }
+}
+
+static float rpmEstimatorPredict(rpmEstimator_t *est, timeUs_t currentTimeUs)
+{
+    const timeDelta_t ageUs = cmpTimeUs(currentTimeUs, est->sampleUs);
+
+    if (!est->valid || ageUs > RPM_EST_TIMEOUT_US) {
+        est->valid = false;
+        est->confidence = 0;
+        return 0;
+    }
+
+    const float age = constrain(ageUs, 0, RPM_EST_MAX_PREDICT_US) * 1e-6f;
+
+    est->confidence = est->quality * (1.0f - (float)MAX(ageUs, 0) / RPM_EST_TIMEOUT_US);
+
+    return fmaxf(est->rpm + est->slope * age, 0);
+}
+
+#ifdef USE_ESC_SENSOR
+// Return true if the main RPM source has stopped delivering samples
+static bool rpmSourceDropout(uint8_t motor, uint8_t source, float rpm, timeUs_t currentTimeUs)
+{
+    rpmEstimator_t *est = &motorRpmEst[motor];
+
+#ifdef USE_DSHOT_TELEMETRY
+    if (source == RPM_SRC_DSHOT_TELEM) {
+        const uint32_t frameCount = getDshotTelemetryFrameCount(motor);
+
+        // The last value is held when frames are lost, so go by frame age
+        if (frameCount != est->frameCount) {
+            est->frameCount = frameCount;
+            est->frameUs = currentTimeUs;
+            return false;
+        }
+
+        return (est->frameCount == 0 || cmpTimeUs(currentTimeUs, est->frameUs) > RPM_EST_DROPOUT_US);
+    }
+#else
+    UNUSED(source);
+    UNUSED(currentTimeUs);
+#endif
+
+    // Frequency sensor reads zero when the input pulses stop
+    return (rpm == 0 && getSensorRPMf(motor, RPM_SRC_ESC_SENSOR) > 0);
+}
+#endif
+
+static float rpmEstimatorUpdate(uint8_t motor, timeUs_t currentTimeUs)
+{
+    rpmEstimator_t *est = &motorRpmEst[motor];
+    const uint8_t source = motorRpmSource[motor];
+
+#ifdef USE_ESC_SENSOR
+    if (source == RPM_SRC_ESC_SENSOR) {
+        const timeUs_t sampleUs = getEscSensorRPMTimestamp(motor);
+        const float rpm = getSensorRPMf(motor, source);
+
+        // Stale telemetry reads as zero RPM
+        if (rpm == 0)
+            rpmEstimatorReset(est, 0, currentTimeUs);
+        else if (sampleUs != est->escSampleUs)
+            rpmEstimatorSample(est, rpm, sampleUs, RPM_EST_SLOPE_GAIN_SLOW);
+
+        est->escSampleUs = sampleUs;
+    }
+    else
+#endif
+    if (source != RPM_SRC_NONE) {
+        const float rpm = getSensorRPMf(motor, source);
+
+#ifdef USE_ESC_SENSOR
+        if (motorRpmAuxSource[motor] == RPM_SRC_ESC_SENSOR) {
+            const timeUs_t sampleUs = getEscSensorRPMTimestamp(motor);
+            const bool auxSample = (sampleUs != est->escSampleUs);
+
+            est->escSampleUs = sampleUs;
+
+            // Main source dropout => continue on the ESC telemetry
+            if (rpmSourceDropout(motor, source, rpm, currentTimeUs)) {
+                if (auxSample)
+                    rpmEstimatorSample(est, getSensorRPMf(motor, RPM_SRC_ESC_SENSOR), sampleUs, RPM_EST_SLOPE_GAIN_SLOW);
+                return rpmEstimatorPredict(est, currentTimeUs);
+            }
+        }
+#endif
+        rpmEstimatorSample(est, rpm, currentTimeUs, RPM_EST_SLOPE_GAIN_FAST);
+    }
+
+    return rpmEstimatorPredict(est, currentTimeUs);
+}
+
 void motorUpdate(void)
 {
+    const timeUs_t currentTimeUs = micros();
     float output;
 
     for (int i = 0; i < motorCount; i++) {
@@ -279,9 +462,14 @@ void motorUpdate(void)
     motorWriteAll(motorOutput);
 
     for (int i = 0; i < motorCount; i++) {
-        motorRpmRaw[i] = getSensorRPMf(i);
+        motorRpmRaw[i] = rpmEstimatorUpdate(i, currentTimeUs);
         motorRpm[i] = fmaxf(filterApply(&motorRpmFilter[i], motorRpmRaw[i]), 0);
         DEBUG(RPM_SOURCE, i, motorRpmRaw[i]);
+        DEBUG_AXIS(RPM_ESTIMATOR, i, 0, motorRpmEst[i].rpm);
+        DEBUG_AXIS(RPM_ESTIMATOR, i, 1, motorRpmRaw[i]);
+        DEBUG_AXIS(RPM_ESTIMATOR, i, 2, motorRpmEst[i].slope);
+        DEBUG_AXIS(RPM_ESTIMATOR, i, 3, motorRpmEst[i].confidence * 1000);
+        DEBUG_AXIS(RPM_ESTIMATOR, i, 4, cmpTimeUs(currentTimeUs, motorRpmEst[i].sampleUs));
     }
 
     headSpeed = motorRpm[0] * mainGearRatio;
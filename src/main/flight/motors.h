@@ -50,6 +50,7 @@ int getMotorRPM(uint8_t motor);
 float getMotorRPMf(uint8_t motor);
 
 float getMotorRawRPMf(uint8_t motor);
+float getMotorRPMConfidence(uint8_t motor);
 
 int calcMotorRPM(uint8_t motor, int erpm);
 
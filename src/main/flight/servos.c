@@ -25,6 +25,7 @@
 
 #ifdef USE_SERVOS
 
+#include "build/atomic.h"
 #include "build/build_config.h"
 
 #include "common/maths.h"
@@ -32,6 +33,7 @@
 #include "config/config.h"
 #include "config/config_reset.h"
 
+#include "drivers/nvic.h"
 #include "drivers/time.h"
 #include "drivers/pwm_output.h"
 
@@ -46,6 +48,9 @@
 #include "pg/pg_ids.h"
 
 
+// Time the servo outputs take to write, kept clear of the timer update event
+#define SERVO_UPDATE_GUARD_US   5
+
 static FAST_DATA_ZERO_INIT uint8_t      servoCount;
 
 static FAST_DATA_ZERO_INIT float        servoInput[MAX_SUPPORTED_SERVOS];
@@ -55,6 +60,11 @@ static FAST_DATA_ZERO_INIT float        servoResolution[MAX_SUPPORTED_SERVOS];
 static FAST_DATA_ZERO_INIT int16_t      servoOverride[MAX_SUPPORTED_SERVOS];
 
 static FAST_DATA_ZERO_INIT timerChannel_t servoChannel[MAX_SUPPORTED_SERVOS];
+static FAST_DATA_ZERO_INIT uint16_t       servoPulse[MAX_SUPPORTED_SERVOS];
+
+static FAST_DATA_ZERO_INIT uint8_t        servoTimerCount;
+static FAST_DATA_ZERO_INIT TIM_TypeDef *  servoTimer[MAX_SUPPORTED_SERVOS];
+static FAST_DATA_ZERO_INIT uint16_t       servoTimerGuard[MAX_SUPPORTED_SERVOS];
 
 
 PG_REGISTER_WITH_RESET_FN(servoConfig_t, servoConfig, PG_SERVO_CONFIG, 0);
@@ -200,6 +210,26 @@ void servoInit(void)
 
         pwmOutConfig(&servoChannel[index], timer[index], timebase, timebase / update_rate, 0, 0);
     }
+
+    for (index = 0; index < servoCount; index++)
+    {
+        for (jndex = 0; jndex < servoTimerCount; jndex++) {
+            if (servoTimer[jndex] == timer[index]->tim)
+                break;
+        }
+        if (jndex == servoTimerCount)
+            servoTimer[servoTimerCount++] = timer[index]->tim;
+
+        const uint16_t guard = lrintf(SERVO_UPDATE_GUARD_US * servoResolution[index]);
+        servoTimerGuard[jndex] = MAX(servoTimerGuard[jndex], guard);
+    }
+
+    // Restart all servo timers together, so that servos running at
+    // the same rate have their update events in phase
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        for (index = 0; index < servoTimerCount; index++)
+            timerForceOverflow(servoTimer[index]);
+    }
 }
 
 void servoShutdown(void)
@@ -218,9 +248,24 @@ void servoShutdown(void)
 static inline void servoSetOutput(uint8_t index, float pos)
 {
     servoOutput[index] = pos;
+    servoPulse[index] = lrintf(pos * servoResolution[index]);
+}
 
-    if (servoChannel[index].ccr)
-        *servoChannel[index].ccr = lrintf(pos * servoResolution[index]);
+static void servoWriteOutputs(void)
+{
+    // The servos of a timer are written clear of its update event,
+    // so they all switch to the new pulses in the same PWM period
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        for (int t = 0; t < servoTimerCount; t++) {
+            pwmOutWaitUpdateClear(servoTimer[t], servoTimerGuard[t]);
+
+            for (int i = 0; i < servoCount; i++) {
+                if (servoChannel[i].ccr && servoChannel[i].tim == servoTimer[t]) {
+                    *servoChannel[i].ccr = servoPulse[i];
+                }
+            }
+        }
+    }
 }
 
 static inline float limitTravel(uint8_t servo, float pos, float min, float max)
@@ -317,6 +362,8 @@ void servoUpdate(void)
 
         servoSetOutput(i, pos);
     }
+
+    servoWriteOutputs();
 }
 
 #endif
@@ -25,6 +25,7 @@
 
 #include "common/axis.h"
 #include "common/maths.h"
+#include "common/time.h"
 
 #include "config/config.h"
 #include "config/feature.h"
@@ -46,6 +47,8 @@
 #define SP_MAX_UP_CUTOFF                   20.0f
 #define SP_MAX_DN_CUTOFF                    0.5f
 
+#define SP_LATENCY_AVERAGING                 16
+
 typedef struct
 {
     float deflection[4];
@@ -68,6 +71,21 @@ typedef struct
     uint16_t responseCutoff[4];
     uint16_t activeCutoff[4];
 
+    float filterDelay[4];
+
+    float predictGain;
+    float predictLead[4];
+    float predictSlope[4];
+    float predictBase[4];
+    timeUs_t predictBaseTime[4];
+
+    float frameJitter;
+    float framePeriod;
+    timeUs_t frameTimeUs;
+    bool frameUpdated;
+
+    float frameLatency;
+
 } setpointData_t;
 
 static FAST_DATA_ZERO_INIT setpointData_t sp;
@@ -104,13 +122,83 @@ void setpointUpdateTiming(float frameTimeUs)
         if (sp.activeCutoff[i] != cutoff) {
             filterUpdate(&sp.filter[i], cutoff, pidGetPidFrequency());
             sp.activeCutoff[i] = cutoff;
+            sp.filterDelay[i] = 3e6f / (M_2PIf * cutoff);
             DEBUG_AXIS(SETPOINT, i, 6, cutoff);
         }
     }
 
+    sp.framePeriod = frameTimeUs;
+
     DEBUG(SETPOINT, 7, frameTimeUs);
 }
 
+void setpointUpdateFrame(timeUs_t frameTimeUs, float frameJitter)
+{
+    sp.frameTimeUs = frameTimeUs;
+    sp.frameJitter = frameJitter;
+    sp.frameUpdated = true;
+}
+
+/*
+ * Extrapolate the stick position between RX frames.
+ *
+ * The slope is taken from the last two frames that changed the value,
+ * and it is applied from the frame arrival time up to the current PID
+ * tick, plus the group delay of the smoothing filter. The lead is limited
+ * to one update period (plus jitter), so a late frame only holds the
+ * position. A frame arriving with no change stops the extrapolation.
+ */
+static float setpointPredict(int axis, float deflection, timeUs_t currentTimeUs)
+{
+    if (sp.frameUpdated) {
+        const timeDelta_t baseAgeUs = cmpTimeUs(sp.frameTimeUs, sp.predictBaseTime[axis]);
+        if (deflection != sp.predictBase[axis]) {
+            const float deltaUs = constrainf(baseAgeUs, sp.framePeriod / 2, sp.framePeriod * 2);
+            sp.predictSlope[axis] = (deflection - sp.predictBase[axis]) / deltaUs;
+            sp.predictBase[axis] = deflection;
+            sp.predictBaseTime[axis] = sp.frameTimeUs;
+        }
+        else if (baseAgeUs > sp.framePeriod * 0.75f) {
+            sp.predictSlope[axis] = 0;
+        }
+    }
+
+    if (sp.predictSlope[axis] == 0 || sp.predictGain == 0) {
+        sp.predictLead[axis] = 0;
+        return deflection;
+    }
+
+    const float confidence = sp.framePeriod / (sp.framePeriod + 2 * sp.frameJitter);
+    const float frameAgeUs = constrainf(cmpTimeUs(currentTimeUs, sp.predictBaseTime[axis]),
+        0, sp.framePeriod + 2 * sp.frameJitter);
+
+    sp.predictLead[axis] = (frameAgeUs + sp.filterDelay[axis]) * sp.predictGain * confidence;
+
+    return constrainf(sp.predictBase[axis] + sp.predictSlope[axis] * sp.predictLead[axis], -1, 1);
+}
+
+static void setpointUpdateLatency(timeUs_t currentTimeUs)
+{
+    if (sp.frameUpdated) {
+        const timeDelta_t latencyUs = cmpTimeUs(currentTimeUs, sp.frameTimeUs);
+
+        if (latencyUs >= 0 && latencyUs < sp.framePeriod * 2) {
+            sp.frameLatency += (latencyUs - sp.frameLatency) / SP_LATENCY_AVERAGING;
+        }
+
+        DEBUG(RC_PREDICTION, 0, latencyUs);
+    }
+
+    DEBUG(RC_PREDICTION, 1, sp.frameLatency);
+    DEBUG(RC_PREDICTION, 2, sp.framePeriod);
+    DEBUG(RC_PREDICTION, 3, sp.frameJitter);
+}
+
+float setpointGetLatency(void)
+{
+    return sp.frameLatency;
+}
+
 INIT_CODE void setpointInitProfile(void)
 {
     sp.ringLimit = 1.0f / (1.4142135623f - currentControlRateProfile->cyclic_ring * 0.004142135623f);
@@ -127,6 +215,9 @@ INIT_CODE void setpointInit(void)
 {
     sp.smoothingFactor = 25e6f / constrain(rcControlsConfig()->rc_smoothness, 1, 250);
 
+    sp.predictGain = constrain(rcControlsConfig()->rc_prediction, 0, 100) / 100.0f;
+    sp.framePeriod = 10000;
+
     sp.maxGainUp = pt1FilterGain(SP_MAX_UP_CUTOFF, pidGetPidFrequency());
     sp.maxGainDown = pt1FilterGain(SP_MAX_DN_CUTOFF, pidGetPidFrequency());
 
@@ -135,16 +226,25 @@ INIT_CODE void setpointInit(void)
     for (int i = 0; i < 4; i++) {
         sp.movementThreshold[i] = sq(rcControlsConfig()->rc_threshold[i] / 1000.0f);
         sp.activeCutoff[i] = sp.responseCutoff[i];
+        sp.filterDelay[i] = 3e6f / (M_2PIf * sp.activeCutoff[i]);
         lowpassFilterInit(&sp.filter[i], LPF_PT3, sp.activeCutoff[i], pidGetPidFrequency(), 0);
     }
 }
 
-void setpointUpdate(void)
+void setpointUpdate(timeUs_t currentTimeUs)
 {
+    setpointUpdateLatency(currentTimeUs);
+
     for (int axis = 0; axis < 4; axis++) {
         float deflection, delta;
 
-        deflection = sp.deflection[axis] = getRcDeflection(axis);
+        deflection = getRcDeflection(axis);
+        DEBUG_AXIS(RC_PREDICTION, axis, 5, deflection * 1000);
+
+        deflection = sp.deflection[axis] = setpointPredict(axis, deflection, currentTimeUs);
+        DEBUG_AXIS(RC_PREDICTION, axis, 4, sp.predictLead[axis]);
+        DEBUG_AXIS(RC_PREDICTION, axis, 6, deflection * 1000);
+        DEBUG_AXIS(RC_PREDICTION, axis, 7, sp.frameLatency + sp.filterDelay[axis] - sp.predictLead[axis]);
         DEBUG_AXIS(SETPOINT, axis, 0, deflection * 1000);
 
         delta = sq(deflection)- sp.maximum[axis];
@@ -153,6 +253,8 @@ void setpointUpdate(void)
         DEBUG_AXIS(SETPOINT, axis, 5, sp.maximum[axis]);
     }
 
+    sp.frameUpdated = false;
+
     DEBUG(AIRBORNE, 0, sqrtf(sp.maximum[FD_ROLL]) * 1000);
     DEBUG(AIRBORNE, 1, sqrtf(sp.maximum[FD_PITCH]) * 1000);
     DEBUG(AIRBORNE, 2, sqrtf(sp.maximum[FD_YAW]) * 1000);
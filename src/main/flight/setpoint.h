@@ -21,6 +21,8 @@
 #include <stdint.h>
 #include <math.h>
 
+#include "common/time.h"
+
 #include "pg/rx.h"
 #include "pg/pid.h"
 
@@ -32,8 +34,11 @@ void setpointInit(void);
 void setpointInitProfile(void);
 
 void setpointUpdateTiming(float frameTimeUs);
+void setpointUpdateFrame(timeUs_t frameTimeUs, float frameJitter);
+
+void setpointUpdate(timeUs_t currentTimeUs);
 
-void setpointUpdate(void);
+float setpointGetLatency(void);
 
 bool isHandsOn(void);
 bool isAirborne(void);
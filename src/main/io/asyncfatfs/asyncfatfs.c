@@ -60,7 +60,16 @@
     #define ONLY_EXPOSE_FOR_TESTING static
 #endif
 
+/*
+ * The cache absorbs the write latency spikes of the card while logging, so targets with RAM to spare get more of it.
+ */
+#ifndef AFATFS_NUM_CACHE_SECTORS
+#if defined(STM32H7) || defined(STM32F7)
+#define AFATFS_NUM_CACHE_SECTORS 32
+#else
 #define AFATFS_NUM_CACHE_SECTORS 11
+#endif
+#endif
 
 // FAT filesystems are allowed to differ from these parameters, but we choose not to support those weird filesystems:
 #define AFATFS_SECTOR_SIZE  512
@@ -77,6 +86,12 @@
  */
 #define AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT 4
 
+/*
+ * How many consecutive sectors may be handed to the SDcard in one flush, as long as the card accepts each of them
+ * immediately (e.g. into the SDIO multi-block write cache).
+ */
+#define AFATFS_MAX_FLUSH_BURST_SECTORS AFATFS_NUM_CACHE_SECTORS
+
 #define AFATFS_FILES_PER_DIRECTORY_SECTOR (AFATFS_SECTOR_SIZE / sizeof(fatDirectoryEntry_t))
 
 #define AFATFS_FAT32_FAT_ENTRIES_PER_SECTOR  (AFATFS_SECTOR_SIZE / sizeof(uint32_t))
@@ -846,6 +861,30 @@ static int afatfs_allocateCacheSector(uint32_t sectorIndex)
     return allocateIndex;
 }
 
+/**
+ * Continue flushing the dirty sectors which follow the given just-flushed sector on disk, for as long as the card accepts
+ * them without delay. This lets a multi-block write stream out without waiting for the next poll for every sector.
+ */
+static void afatfs_cacheFlushFollowingSectors(int cacheIndex)
+{
+    for (int burst = 1; burst < AFATFS_MAX_FLUSH_BURST_SECTORS; burst++) {
+        if (afatfs.cacheDescriptor[cacheIndex].state != AFATFS_CACHE_STATE_IN_SYNC) {
+            // The card is still busy with the last sector
+            break;
+        }
+
+        afatfsCacheBlockDescriptor_t *next = afatfs_findCacheSector(afatfs.cacheDescriptor[cacheIndex].sectorIndex + 1);
+
+        if (!next || next->state != AFATFS_CACHE_STATE_DIRTY || next->locked) {
+            break;
+        }
+
+        cacheIndex = next - afatfs.cacheDescriptor;
+
+        afatfs_cacheFlushSector(cacheIndex);
+    }
+}
+
 /**
  * Attempt to flush dirty cache pages out to the sdcard, returning true if all flushable data has been flushed.
  */
@@ -867,6 +906,7 @@ bool afatfs_flush(void)
 
         if (earliestSectorIndex > -1) {
             afatfs_cacheFlushSector(earliestSectorIndex);
+            afatfs_cacheFlushFollowingSectors(earliestSectorIndex);
 
             // That flush will take time to complete so we may as well tell caller to come back later
             return false;
@@ -28,10 +28,18 @@
  * Note that bits can only be set to 0 when writing, not back to 1 from 0. You must erase sectors in order
  * to bring bits back to 1 again.
  *
+ * With flashfs_log_index enabled, the last two sectors of the partition hold a log index instead of data.
+ * Every log start and end is appended to the index as a small record, together with the position of the
+ * write head and the extent of the pre-erased space ahead of it. Mounting just replays the index, so no
+ * scan of the data area is needed. When the write head gets close to the end of the volume, it wraps back
+ * to the start and the oldest logs are recycled. Sectors for the next log are erased in the background
+ * while disarmed, so that a full erase is never needed.
+ *
  * In future, we can add support for multiple different flash chips by adding a flash device driver vtable
  * and make calls through that, at the moment flashfs just calls m25p16_* routines explicitly.
  */
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
@@ -39,12 +47,19 @@
 #include "platform.h"
 
 #include "build/debug.h"
+#include "common/crc.h"
+#include "common/maths.h"
 #include "common/printf.h"
+#include "common/utils.h"
 #include "drivers/flash.h"
 #include "drivers/light_led.h"
 
+#include "fc/runtime_config.h"
+
 #include "io/flashfs.h"
 
+#include "pg/flashfs.h"
+
 typedef enum {
     FLASHFS_IDLE,
     FLASHFS_ERASING,
@@ -95,6 +110,63 @@ uint32_t checkFlashErrors = 0;
 // The position of the buffer's tail in the overall flash address space:
 static uint32_t tailAddress = 0;
 
+// Logs always start on this boundary
+#define FLASHFS_LOG_ALIGN               2048
+
+#define FLASHFS_INDEX_SECTORS           2
+#define FLASHFS_INDEX_MIN_SECTORS       8
+#define FLASHFS_INDEX_MAX_LOGS          32
+#define FLASHFS_INDEX_MAGIC             0x4C46
+#define FLASHFS_INDEX_VERSION           1
+
+typedef enum {
+    FLASHFS_RECORD_STATE = 1,   // Volume state only
+    FLASHFS_RECORD_BEGIN,       // A log was started at the write head
+    FLASHFS_RECORD_END,         // A log was closed
+    FLASHFS_RECORD_COPY,        // A log entry copied during index compaction
+} flashfsRecordType_e;
+
+typedef struct flashfsIndexRecord_s {
+    uint16_t magic;
+    uint8_t  type;
+    uint8_t  version;
+    uint32_t sequence;
+    uint32_t logStart;
+    uint32_t logEnd;
+    uint32_t head;              // Write head
+    uint32_t frontier;          // End of the erased space ahead of the head
+    uint32_t target;            // End of the space being pre-erased
+    uint16_t logNumber;
+    uint16_t crc;
+} flashfsIndexRecord_t;
+
+STATIC_ASSERT(sizeof(flashfsIndexRecord_t) == 32, flashfsIndexRecord_size);
+
+static DMA_DATA_ZERO_INIT flashfsIndexRecord_t indexRecord;
+
+static uint16_t indexSlotSize = 0;
+static uint16_t indexSlotCount = 0;
+static uint16_t indexSlot = 0;
+static uint8_t  indexSector = 0;
+static uint32_t indexSequence = 0;
+static bool     indexFormatPending = false;
+
+static uint32_t volumeHead = 0;
+static uint32_t volumeFrontier = 0;
+static uint32_t volumeTarget = 0;
+static uint32_t volumeReserve = 0;
+static bool     volumeCommitPending = false;
+
+static bool     logActive = false;
+static uint16_t logNumber = 0;
+static uint16_t nextLogNumber = 0;
+static uint32_t logStartAddress = 0;
+
+static flashfsLog_t logTable[FLASHFS_INDEX_MAX_LOGS];
+static unsigned logCount = 0;
+
+static void flashfsIndexUpdate(void);
+
 static void flashfsClearBuffer(void)
 {
     bufferTail = bufferHead = 0;
@@ -127,6 +199,13 @@ void flashfsEraseCompletely(void)
     flashfsClearBuffer();
 
     flashfsSetTailAddress(0);
+
+    if (flashfsHasLogIndex()) {
+        // Write a fresh index once the erase has finished
+        logActive = false;
+        logCount = 0;
+        indexFormatPending = true;
+    }
 }
 
 /**
@@ -424,6 +503,8 @@ void flashfsEraseAsync(void)
                 LED1_OFF;
             }
         }
+    } else if (flashfsHasLogIndex()) {
+        flashfsIndexUpdate();
     }
 }
 
@@ -471,8 +552,6 @@ void flashfsWrite(const uint8_t *data, unsigned int len)
  */
 int flashfsReadAbs(uint32_t address, uint8_t *buffer, unsigned int len)
 {
-    int bytesRead;
-
     // Did caller try to read past the end of the volume?
     if (address + len > flashfsSize) {
         // Truncate their request
@@ -482,15 +561,24 @@ int flashfsReadAbs(uint32_t address, uint8_t *buffer, unsigned int len)
     // Since the read could overlap data in our dirty buffers, force a sync to clear those first
     flashfsFlushSync();
 
-    bytesRead = flashReadBytes(address, buffer, len);
+    // Devices may return less than requested at page boundaries
+    int bytesRead = 0;
+
+    while ((unsigned)bytesRead < len) {
+        const int chunk = flashReadBytes(address + bytesRead, buffer + bytesRead, len - bytesRead);
+        if (chunk <= 0) {
+            break;
+        }
+        bytesRead += chunk;
+    }
 
     return bytesRead;
 }
 
 /**
- * Find the offset of the start of the free space on the device (or the size of the device if it is full).
+ * Find the offset of the start of the free space in the range [start...end) (or end if the range is full).
  */
-int flashfsIdentifyStartOfFreeSpace(void)
+static uint32_t flashfsFindFreeSpace(uint32_t start, uint32_t end)
 {
     /* Find the start of the free space on the device by examining the beginning of blocks with a binary search,
      * looking for ones that appear to be erased. We can achieve this with good accuracy because an erased block
@@ -519,8 +607,8 @@ int flashfsIdentifyStartOfFreeSpace(void)
         uint32_t ints[FREE_BLOCK_TEST_SIZE_INTS];
     } testBuffer;
 
-    int left = 0; // Smallest block index in the search region
-    int right = flashfsSize / FREE_BLOCK_SIZE; // One past the largest block index in the search region
+    int left = start / FREE_BLOCK_SIZE; // Smallest block index in the search region
+    int right = end / FREE_BLOCK_SIZE; // One past the largest block index in the search region
     int mid;
     int result = right;
     int i;
@@ -558,16 +646,453 @@ int flashfsIdentifyStartOfFreeSpace(void)
     return result * FREE_BLOCK_SIZE;
 }
 
+/**
+ * Find the offset of the start of the free space on the device (or the size of the device if it is full).
+ */
+int flashfsIdentifyStartOfFreeSpace(void)
+{
+    return flashfsFindFreeSpace(0, flashfsSize);
+}
+
+static uint32_t flashfsAlignUp(uint32_t address, uint32_t align)
+{
+    return ((address + align - 1) / align) * align;
+}
+
+static uint32_t flashfsIndexSlotAddress(unsigned sector, unsigned slot)
+{
+    const flashSector_t indexStartSector = flashPartition->endSector + 1 - FLASHFS_INDEX_SECTORS;
+
+    return (indexStartSector + sector) * flashGeometry->sectorSize + slot * indexSlotSize;
+}
+
+static uint16_t flashfsIndexRecordCRC(void)
+{
+    return crc16_ccitt_update(0, &indexRecord, offsetof(flashfsIndexRecord_t, crc));
+}
+
+static bool flashfsIndexReadRecord(unsigned sector, unsigned slot)
+{
+    return flashReadBytes(flashfsIndexSlotAddress(sector, slot), (uint8_t *)&indexRecord, sizeof(indexRecord)) == sizeof(indexRecord);
+}
+
+static bool flashfsIndexRecordIsValid(void)
+{
+    return indexRecord.magic == FLASHFS_INDEX_MAGIC &&
+           indexRecord.version == FLASHFS_INDEX_VERSION &&
+           indexRecord.crc == flashfsIndexRecordCRC();
+}
+
+static bool flashfsIndexRecordIsErased(void)
+{
+    const uint8_t *bytes = (const uint8_t *)&indexRecord;
+
+    for (unsigned i = 0; i < sizeof(indexRecord); i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void flashfsAddLog(const flashfsLog_t *log)
+{
+    if (log->end <= log->start) {
+        return;
+    }
+
+    // Forget the oldest log if the table is full. It stays on the flash until overwritten.
+    if (logCount == FLASHFS_INDEX_MAX_LOGS) {
+        memmove(&logTable[0], &logTable[1], sizeof(flashfsLog_t) * (FLASHFS_INDEX_MAX_LOGS - 1));
+        logCount--;
+    }
+
+    logTable[logCount++] = *log;
+}
+
+/**
+ * Forget all logs that overlap the range [start...end), since that range is about to be erased.
+ */
+static void flashfsDropLogs(uint32_t start, uint32_t end)
+{
+    unsigned count = 0;
+
+    for (unsigned i = 0; i < logCount; i++) {
+        if (logTable[i].start >= end || logTable[i].end <= start) {
+            logTable[count++] = logTable[i];
+        }
+    }
+
+    logCount = count;
+}
+
+static void flashfsIndexWrite(flashfsRecordType_e type, const flashfsLog_t *log);
+
+/**
+ * Move the index to the other index sector, keeping only the current log table and volume state.
+ */
+static void flashfsIndexCompact(void)
+{
+    indexSector ^= 1;
+    indexSlot = 0;
+
+    flashWaitForReady();
+    flashEraseSector(flashfsIndexSlotAddress(indexSector, 0));
+
+    for (unsigned i = 0; i < logCount; i++) {
+        flashfsIndexWrite(FLASHFS_RECORD_COPY, &logTable[i]);
+    }
+
+    // The new sector only becomes valid once this record is written
+    flashfsIndexWrite(FLASHFS_RECORD_STATE, NULL);
+}
+
+static void flashfsIndexWrite(flashfsRecordType_e type, const flashfsLog_t *log)
+{
+    if (indexSlot >= indexSlotCount) {
+        flashfsIndexCompact();
+    }
+
+    indexRecord.magic = FLASHFS_INDEX_MAGIC;
+    indexRecord.type = type;
+    indexRecord.version = FLASHFS_INDEX_VERSION;
+    indexRecord.sequence = ++indexSequence;
+    indexRecord.logStart = log ? log->start : 0;
+    indexRecord.logEnd = log ? log->end : 0;
+    indexRecord.head = volumeHead;
+    indexRecord.frontier = volumeFrontier;
+    indexRecord.target = volumeTarget;
+    indexRecord.logNumber = log ? log->number : nextLogNumber;
+    indexRecord.crc = flashfsIndexRecordCRC();
+
+    flashWaitForReady();
+    flashPageProgram(flashfsIndexSlotAddress(indexSector, indexSlot), (const uint8_t *)&indexRecord, sizeof(indexRecord), NULL);
+    flashFlush();
+
+    indexSlot++;
+}
+
+/**
+ * Rebuild the log table and volume state from one index sector.
+ *
+ * Returns true if the sector holds at least one committed volume state.
+ */
+static bool flashfsIndexReplay(unsigned sector, bool *logOpen)
+{
+    bool committed = false;
+
+    logCount = 0;
+    nextLogNumber = 0;
+    volumeHead = volumeFrontier = volumeTarget = 0;
+    *logOpen = false;
+
+    indexSector = sector;
+    indexSequence = 0;
+
+    for (indexSlot = 0; indexSlot < indexSlotCount; indexSlot++) {
+        if (!flashfsIndexReadRecord(sector, indexSlot) || flashfsIndexRecordIsErased()) {
+            break;
+        }
+
+        if (!flashfsIndexRecordIsValid()) {
+            // Torn write. Move to a fresh sector on the next update.
+            indexSlot = indexSlotCount;
+            break;
+        }
+
+        const flashfsLog_t log = {
+            .number = indexRecord.logNumber,
+            .start = indexRecord.logStart,
+            .end = indexRecord.logEnd,
+        };
+
+        indexSequence = indexRecord.sequence;
+
+        if (indexRecord.type == FLASHFS_RECORD_COPY) {
+            flashfsAddLog(&log);
+            continue;
+        }
+
+        volumeHead = indexRecord.head;
+        volumeFrontier = indexRecord.frontier;
+        volumeTarget = indexRecord.target;
+
+        flashfsDropLogs(volumeHead, MAX(volumeFrontier, volumeTarget));
+
+        *logOpen = false;
+
+        switch (indexRecord.type) {
+            case FLASHFS_RECORD_BEGIN:
+                *logOpen = true;
+                logNumber = log.number;
+                logStartAddress = log.start;
+                nextLogNumber = log.number + 1;
+                break;
+            case FLASHFS_RECORD_END:
+                flashfsAddLog(&log);
+                nextLogNumber = log.number + 1;
+                break;
+            default:
+                nextLogNumber = log.number;
+                break;
+        }
+
+        committed = true;
+    }
+
+    return committed;
+}
+
+/**
+ * Move the write head back to the start of the volume if there is not enough room left for another log.
+ */
+static void flashfsIndexWrapHead(void)
+{
+    if (flashfsSize - volumeHead < volumeReserve) {
+        volumeHead = volumeFrontier = volumeTarget = 0;
+    }
+}
+
+/**
+ * Start a new index on a freshly erased volume.
+ */
+static void flashfsIndexFormat(void)
+{
+    indexFormatPending = false;
+
+    logCount = 0;
+    nextLogNumber = 0;
+    indexSector = 0;
+    indexSlot = 0;
+
+    volumeHead = 0;
+    volumeFrontier = volumeTarget = flashfsSize;
+    volumeCommitPending = false;
+
+    flashfsIndexWrite(FLASHFS_RECORD_STATE, NULL);
+
+    flashfsSetTailAddress(volumeHead);
+}
+
+/**
+ * Start an index on a volume that was written without one, keeping the existing data as the first log.
+ *
+ * Returns false if the existing data runs into the index sectors. Those are left alone and the volume
+ * is used without an index until it has been erased.
+ */
+static bool flashfsIndexAdopt(void)
+{
+    // The index sectors follow the data area
+    if (flashfsFindFreeSpace(0, flashfsSize + FLASHFS_INDEX_SECTORS * flashGeometry->sectorSize) > flashfsSize) {
+        return false;
+    }
+
+    const flashfsLog_t log = {
+        .number = 0,
+        .start = 0,
+        .end = flashfsIdentifyStartOfFreeSpace(),
+    };
+
+    // The index sectors lie past the used area, so anything left there is not log data
+    for (unsigned sector = 0; sector < FLASHFS_INDEX_SECTORS; sector++) {
+        flashWaitForReady();
+        flashEraseSector(flashfsIndexSlotAddress(sector, 0));
+    }
+
+    logCount = 0;
+    indexSector = 0;
+    indexSlot = 0;
+
+    flashfsAddLog(&log);
+    nextLogNumber = logCount;
+
+    volumeHead = flashfsAlignUp(log.end, FLASHFS_LOG_ALIGN);
+    volumeFrontier = volumeTarget = flashfsSize;
+    flashfsIndexWrapHead();
+
+    if (logCount) {
+        flashfsIndexWrite(FLASHFS_RECORD_COPY, &log);
+    }
+    flashfsIndexWrite(FLASHFS_RECORD_STATE, NULL);
+
+    return true;
+}
+
+/**
+ * Record the end of the active log and move the write head past it.
+ */
+static void flashfsIndexEndLog(uint32_t end)
+{
+    const flashfsLog_t log = {
+        .number = logNumber,
+        .start = logStartAddress,
+        .end = end,
+    };
+
+    logActive = false;
+
+    flashfsAddLog(&log);
+
+    volumeHead = MIN(flashfsAlignUp(end, FLASHFS_LOG_ALIGN), volumeFrontier);
+    flashfsIndexWrapHead();
+
+    flashfsIndexWrite(FLASHFS_RECORD_END, &log);
+
+    flashfsSetTailAddress(volumeHead);
+}
+
+static bool flashfsIndexMount(void)
+{
+    bool logOpen = false;
+    unsigned first = 0;
+
+    // Replay the sector with the newest records first, falling back to the other one
+    // if it was being compacted when power was lost.
+    uint32_t sequence[FLASHFS_INDEX_SECTORS];
+    for (unsigned sector = 0; sector < FLASHFS_INDEX_SECTORS; sector++) {
+        sequence[sector] = (flashfsIndexReadRecord(sector, 0) && flashfsIndexRecordIsValid()) ? indexRecord.sequence : 0;
+    }
+    if (sequence[1] > sequence[0]) {
+        first = 1;
+    }
+
+    if (!flashfsIndexReplay(first, &logOpen) && !flashfsIndexReplay(first ^ 1, &logOpen)) {
+        return flashfsIndexAdopt();
+    }
+
+    if (logOpen) {
+        // Power was lost while logging, so look for the end of the log in the flash itself
+        flashfsIndexEndLog(flashfsFindFreeSpace(logStartAddress, volumeFrontier));
+    }
+
+    return true;
+}
+
+/**
+ * Background index maintenance. Pre-erases the space for the next log one sector at a time while disarmed.
+ */
+static void flashfsIndexUpdate(void)
+{
+    if (!flashIsReady()) {
+        return;
+    }
+
+    if (indexFormatPending) {
+        flashfsIndexFormat();
+        return;
+    }
+
+    if (ARMING_FLAG(ARMED)) {
+        return;
+    }
+
+    if (logActive) {
+        // The log ran out of erased space and the writer gave up on it
+        if (flashfsIsEOF()) {
+            flashfsClose();
+        }
+        return;
+    }
+
+    if (volumeFrontier < volumeTarget) {
+        flashEraseSector(volumeFrontier);
+        volumeFrontier += flashGeometry->sectorSize;
+        volumeCommitPending = true;
+    } else if (volumeCommitPending) {
+        volumeCommitPending = false;
+        flashfsIndexWrite(FLASHFS_RECORD_STATE, NULL);
+    } else {
+        const uint32_t target = flashfsAlignUp(MIN(volumeHead + volumeReserve, flashfsSize), flashGeometry->sectorSize);
+
+        if (target > volumeFrontier) {
+            // Logs in the range are lost as soon as erasing starts, so record that first
+            volumeTarget = target;
+            flashfsDropLogs(volumeFrontier, volumeTarget);
+            flashfsIndexWrite(FLASHFS_RECORD_STATE, NULL);
+        }
+    }
+}
+
+/**
+ * Prepare the volume for a new log at the write head.
+ *
+ * Returns false if the log can't be started yet (call again later).
+ */
+bool flashfsBeginLog(void)
+{
+    if (!flashfsHasLogIndex()) {
+        return true;
+    }
+
+    if (indexFormatPending || !flashfsIsReady()) {
+        return false;
+    }
+
+    if (logActive) {
+        flashfsClose();
+    }
+
+    if (volumeFrontier <= volumeHead) {
+        return false;
+    }
+
+    // Stop pre-erasing. The log may use the erased space only.
+    volumeTarget = volumeFrontier;
+    volumeCommitPending = false;
+
+    logNumber = nextLogNumber++;
+    logStartAddress = volumeHead;
+    logActive = true;
+
+    const flashfsLog_t log = {
+        .number = logNumber,
+        .start = logStartAddress,
+        .end = logStartAddress,
+    };
+
+    flashfsIndexWrite(FLASHFS_RECORD_BEGIN, &log);
+
+    flashfsClearBuffer();
+    flashfsSetTailAddress(logStartAddress);
+
+    return true;
+}
+
+bool flashfsHasLogIndex(void)
+{
+    return indexSlotCount > 0;
+}
+
+unsigned flashfsGetLogCount(void)
+{
+    return logCount;
+}
+
+/**
+ * Get a log from the index, oldest first.
+ */
+const flashfsLog_t *flashfsGetLog(unsigned index)
+{
+    return (index < logCount) ? &logTable[index] : NULL;
+}
+
 /**
  * Returns true if the file pointer is at the end of the device.
  */
 bool flashfsIsEOF(void)
 {
+    if (flashfsHasLogIndex()) {
+        return tailAddress >= volumeFrontier;
+    }
+
     return tailAddress >= flashfsSize;
 }
 
 void flashfsClose(void)
 {
+    const uint32_t logEnd = tailAddress;
+
     switch(flashGeometry->flashType) {
         case FLASH_TYPE_NAND:
             flashFlush();
@@ -577,6 +1102,10 @@ void flashfsClose(void)
             flashfsSetTailAddress((tailAddress + 2047) & ~2047);
             break;
     }
+
+    if (logActive) {
+        flashfsIndexEndLog(logEnd);
+    }
 }
 
 /**
@@ -595,6 +1124,31 @@ void flashfsInit(void)
 
     flashfsSize = FLASH_PARTITION_SECTOR_COUNT(flashPartition) * flashGeometry->sectorSize;
 
+    indexSlotCount = 0;
+    indexFormatPending = false;
+    logActive = false;
+
+    if (flashfsConfig()->log_index && FLASH_PARTITION_SECTOR_COUNT(flashPartition) >= FLASHFS_INDEX_MIN_SECTORS) {
+        const uint32_t sectorSize = flashGeometry->sectorSize;
+
+        // The index lives in the last sectors of the partition. NAND pages can only be programmed once,
+        // so every index record takes up a full page there.
+        flashfsSize -= FLASHFS_INDEX_SECTORS * sectorSize;
+
+        indexSlotSize = (flashGeometry->flashType == FLASH_TYPE_NAND) ? flashGeometry->pageSize : sizeof(flashfsIndexRecord_t);
+        indexSlotCount = sectorSize / indexSlotSize;
+
+        volumeReserve = MAX(flashfsAlignUp((flashfsSize / 100) * flashfsConfig()->erase_ahead, sectorSize), sectorSize);
+
+        if (flashfsIndexMount()) {
+            flashfsSeekAbs(volumeHead);
+            return;
+        }
+
+        flashfsSize += FLASHFS_INDEX_SECTORS * sectorSize;
+        indexSlotCount = 0;
+    }
+
     // Start the file pointer off at the beginning of free space so caller can start writing immediately
     flashfsSeekAbs(flashfsIdentifyStartOfFreeSpace());
 }
@@ -23,6 +23,12 @@
 #define FLASHFS_WRITE_BUFFER_SIZE 256
 #define FLASHFS_WRITE_BUFFER_USABLE (FLASHFS_WRITE_BUFFER_SIZE - 1)
 
+typedef struct flashfsLog_s {
+    uint16_t number;
+    uint32_t start;
+    uint32_t end;
+} flashfsLog_t;
+
 void flashfsEraseCompletely(void);
 void flashfsEraseRange(uint32_t start, uint32_t end);
 
@@ -54,3 +60,8 @@ bool flashfsIsEOF(void);
 
 bool flashfsVerifyEntireFlash(void);
 
+bool flashfsBeginLog(void);
+bool flashfsHasLogIndex(void);
+unsigned flashfsGetLogCount(void);
+const flashfsLog_t *flashfsGetLog(unsigned index);
+
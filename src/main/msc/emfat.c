@@ -30,6 +30,7 @@
 
 #include "platform.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "emfat.h"
@@ -600,7 +601,9 @@ void fill_dir_sector(emfat_t *emfat, uint8_t *data, emfat_entry_t *entry, uint32
     }
 }
 
-void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
+// Reads up to num_sectors consecutive data sectors and returns the number read.
+// Sectors belonging to the same file are fetched with a single read callback.
+int read_data_sectors(emfat_t *emfat, uint8_t *data, uint32_t rel_sect, int num_sectors)
 {
     emfat_entry_t *le;
     uint32_t cluster;
@@ -614,32 +617,37 @@ void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
             int i;
             for (i = 0; i < SECT / 4; i++)
                 ((uint32_t *)data)[i] = 0xEFBEADDE;
-            return;
+            return 1;
         }
         emfat->priv.last_entry = le;
     }
 
     if (le->dir) {
         fill_dir_sector(emfat, data, le, rel_sect);
-        return;
+        return 1;
     }
 
+    // Clusters of a file are contiguous up to last_reserved
+    const uint32_t sectors_left = (le->priv.last_reserved - cluster + 1) * (CLUST / SECT) - rel_sect;
+    const int count = MIN((uint32_t)num_sectors, sectors_left);
+
     if (le->readcb == NULL) {
-        memset(data, 0, SECT);
+        memset(data, 0, count * SECT);
     } else {
         uint32_t offset = cluster - le->priv.first_clust;
         offset = offset * CLUST + rel_sect * SECT;
-        le->readcb(data, SECT, offset + le->offset, le);
+        le->readcb(data, count * SECT, offset + le->offset, le);
     }
 
-    return;
+    return count;
 }
 
 void emfat_read(emfat_t *emfat, uint8_t *data, uint32_t sector, int num_sectors)
 {
     while (num_sectors > 0) {
+        int count = 1;
         if (sector >= emfat->priv.root_lba) {
-            read_data_sector(emfat, data, sector - emfat->priv.root_lba);
+            count = read_data_sectors(emfat, data, sector - emfat->priv.root_lba, num_sectors);
         } else if (sector == 0) {
             read_mbr_sector(emfat, data);
         } else if (sector == emfat->priv.fsinfo_lba) {
@@ -653,9 +661,9 @@ void emfat_read(emfat_t *emfat, uint8_t *data, uint32_t sector, int num_sectors)
         } else {
             memset(data, 0, SECT);
         }
-        data += SECT;
-        num_sectors--;
-        sector++;
+        data += count * SECT;
+        num_sectors -= count;
+        sector += count;
     }
 }
 
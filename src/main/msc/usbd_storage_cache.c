@@ -0,0 +1,222 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_USB_MSC
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+
+#include "drivers/time.h"
+
+#include "msc/usbd_storage_cache.h"
+
+#ifndef MSC_CACHE_RUN_BLOCKS
+#if defined(STM32H7)
+#define MSC_CACHE_RUN_BLOCKS        32
+#else
+#define MSC_CACHE_RUN_BLOCKS        8
+#endif
+#endif
+
+#define MSC_CACHE_RUN_COUNT         2
+#define MSC_CACHE_RATE_PERIOD_US    1000000
+
+typedef enum {
+    MSC_RUN_EMPTY,
+    MSC_RUN_LOADING,
+    MSC_RUN_VALID,
+} mscCacheRunState_e;
+
+typedef struct mscCacheRun_s {
+    uint32_t startBlock;
+    uint16_t blockCount;
+    mscCacheRunState_e state;
+} mscCacheRun_t;
+
+static DMA_DATA_ZERO_INIT uint8_t mscCacheData[MSC_CACHE_RUN_COUNT][MSC_CACHE_RUN_BLOCKS * MSC_CACHE_BLOCK_SIZE] __attribute__ ((aligned(32)));
+
+static struct {
+    const mscCacheOps_t *ops;
+    uint32_t blockLimit;
+    uint32_t nextBlock;
+    mscCacheRun_t runs[MSC_CACHE_RUN_COUNT];
+    // Throughput accounting
+    timeUs_t periodStartUs;
+    uint32_t periodBytes;
+    uint16_t hits;
+    uint16_t misses;
+    timeDelta_t waitUs;
+} mscCache;
+
+static void mscCacheWaitForRead(void)
+{
+    for (int i = 0; i < MSC_CACHE_RUN_COUNT; i++) {
+        mscCacheRun_t *run = &mscCache.runs[i];
+        if (run->state == MSC_RUN_LOADING) {
+            const timeUs_t startUs = micros();
+            while (!mscCache.ops->readIsComplete());
+            mscCache.waitUs += cmpTimeUs(micros(), startUs);
+            run->state = MSC_RUN_VALID;
+        }
+    }
+}
+
+static mscCacheRun_t *mscCacheFindRun(uint32_t block)
+{
+    for (int i = 0; i < MSC_CACHE_RUN_COUNT; i++) {
+        mscCacheRun_t *run = &mscCache.runs[i];
+        if (run->state != MSC_RUN_EMPTY && block >= run->startBlock && block < run->startBlock + run->blockCount) {
+            return run;
+        }
+    }
+    return NULL;
+}
+
+static bool mscCacheLoadRun(mscCacheRun_t *run, uint32_t block)
+{
+    const uint32_t blockCount = MIN((uint32_t)MSC_CACHE_RUN_BLOCKS, mscCache.blockLimit - block);
+    uint8_t *data = mscCacheData[run - mscCache.runs];
+
+    run->state = MSC_RUN_EMPTY;
+
+    if (block >= mscCache.blockLimit || !mscCache.ops->readStart(block, data, blockCount)) {
+        return false;
+    }
+
+    run->startBlock = block;
+    run->blockCount = blockCount;
+    run->state = MSC_RUN_LOADING;
+
+    return true;
+}
+
+static void mscCacheUpdateRate(uint32_t bytes)
+{
+    const timeUs_t currentTimeUs = micros();
+    const timeDelta_t periodUs = cmpTimeUs(currentTimeUs, mscCache.periodStartUs);
+
+    mscCache.periodBytes += bytes;
+
+    if (periodUs >= MSC_CACHE_RATE_PERIOD_US) {
+        // kB/s and per-period cache statistics
+        DEBUG_SET(DEBUG_USB_MSC, 0, (uint64_t)mscCache.periodBytes * 1000 / 1024 / (periodUs / 1000));
+        DEBUG_SET(DEBUG_USB_MSC, 1, mscCache.hits);
+        DEBUG_SET(DEBUG_USB_MSC, 2, mscCache.misses);
+        DEBUG_SET(DEBUG_USB_MSC, 3, mscCache.waitUs / 1000);
+
+        mscCache.periodStartUs = currentTimeUs;
+        mscCache.periodBytes = 0;
+        mscCache.hits = 0;
+        mscCache.misses = 0;
+        mscCache.waitUs = 0;
+    }
+}
+
+void mscCacheInit(const mscCacheOps_t *ops, uint32_t blockCount)
+{
+    memset(&mscCache, 0, sizeof(mscCache));
+
+    mscCache.ops = ops;
+    mscCache.blockLimit = blockCount;
+    mscCache.nextBlock = UINT32_MAX;
+    mscCache.periodStartUs = micros();
+}
+
+void mscCacheInvalidate(void)
+{
+    if (mscCache.ops) {
+        mscCacheWaitForRead();
+    }
+
+    for (int i = 0; i < MSC_CACHE_RUN_COUNT; i++) {
+        mscCache.runs[i].state = MSC_RUN_EMPTY;
+    }
+
+    mscCache.nextBlock = UINT32_MAX;
+}
+
+bool mscCacheRead(uint8_t *buf, uint32_t blockAddr, uint16_t blockCount)
+{
+    if (blockCount == 0) {
+        return true;
+    }
+
+    const bool sequential = (blockAddr == mscCache.nextBlock);
+
+    if (!sequential && !mscCacheFindRun(blockAddr)) {
+        // Random access - bypass the cache
+        mscCache.misses++;
+        mscCacheWaitForRead();
+        if (!mscCache.ops->readStart(blockAddr, buf, blockCount)) {
+            return false;
+        }
+        while (!mscCache.ops->readIsComplete());
+    } else {
+        for (uint32_t block = blockAddr; block < blockAddr + blockCount; ) {
+            mscCacheRun_t *run = mscCacheFindRun(block);
+
+            if (run) {
+                mscCache.hits++;
+            } else {
+                mscCache.misses++;
+                mscCacheWaitForRead();
+                run = &mscCache.runs[0];
+                if (!mscCacheLoadRun(run, block)) {
+                    return false;
+                }
+            }
+
+            if (run->state == MSC_RUN_LOADING) {
+                mscCacheWaitForRead();
+            }
+
+            const uint32_t offset = block - run->startBlock;
+            const uint32_t count = MIN(run->blockCount - offset, blockAddr + blockCount - block);
+
+            memcpy(buf, mscCacheData[run - mscCache.runs] + offset * MSC_CACHE_BLOCK_SIZE, count * MSC_CACHE_BLOCK_SIZE);
+
+            buf += count * MSC_CACHE_BLOCK_SIZE;
+            block += count;
+        }
+
+        // Prefetch the run following the one being consumed
+        const mscCacheRun_t *current = mscCacheFindRun(blockAddr + blockCount - 1);
+        const uint32_t nextRunBlock = current->startBlock + current->blockCount;
+
+        if (!mscCacheFindRun(nextRunBlock)) {
+            mscCacheWaitForRead();
+            mscCacheRun_t *other = &mscCache.runs[current == &mscCache.runs[0] ? 1 : 0];
+            mscCacheLoadRun(other, nextRunBlock);
+        }
+    }
+
+    mscCache.nextBlock = blockAddr + blockCount;
+
+    mscCacheUpdateRate(blockCount * MSC_CACHE_BLOCK_SIZE);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MSC_CACHE_BLOCK_SIZE    512
+
+/*
+ * Read-ahead cache for the MSC storage backends.
+ *
+ * Sequential host reads are served from a pair of multi-block runs.
+ * While the host consumes one run the next one is being read into the
+ * other, so the storage bus and USB transfers overlap.
+ */
+
+typedef struct mscCacheOps_s {
+    // Start reading blockCount blocks into buf. May complete synchronously.
+    bool (*readStart)(uint32_t blockAddr, uint8_t *buf, uint16_t blockCount);
+    // Returns true once the last started read has completed.
+    bool (*readIsComplete)(void);
+} mscCacheOps_t;
+
+void mscCacheInit(const mscCacheOps_t *ops, uint32_t blockCount);
+bool mscCacheRead(uint8_t *buf, uint32_t blockAddr, uint16_t blockCount);
+void mscCacheInvalidate(void);
@@ -36,6 +36,7 @@
 #include "drivers/usb_msc.h"
 
 #include "msc/usbd_storage.h"
+#include "msc/usbd_storage_cache.h"
 #include "msc/usbd_storage_emfat.h"
 
 
@@ -56,12 +57,30 @@ static const uint8_t STORAGE_Inquirydata[] =
     ' ', ' ', ' ' ,' ',                     // Version      : 4 Bytes
 };
 
+static bool STORAGE_ReadStart(uint32_t blk_addr, uint8_t *buf, uint16_t blk_len)
+{
+    emfat_read(&emfat, buf, blk_addr, blk_len);
+    return true;
+}
+
+static bool STORAGE_ReadIsComplete(void)
+{
+    return true;
+}
+
+static const mscCacheOps_t STORAGE_CacheOps = {
+    .readStart = STORAGE_ReadStart,
+    .readIsComplete = STORAGE_ReadIsComplete,
+};
+
 static int8_t STORAGE_Init(uint8_t lun)
 {
     UNUSED(lun);
 
     LED0_OFF;
 
+    mscCacheInit(&STORAGE_CacheOps, emfat.disk_sectors);
+
     return 0;
 }
 
@@ -97,8 +116,7 @@ static int8_t STORAGE_Read(
 {
     UNUSED(lun);
     mscSetActive();
-    emfat_read(&emfat, buf, blk_addr, blk_len);
-    return 0;
+    return mscCacheRead(buf, blk_addr, blk_len) ? 0 : -1;
 }
 
 static int8_t STORAGE_Write(uint8_t lun,
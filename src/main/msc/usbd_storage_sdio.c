@@ -56,6 +56,7 @@
 #endif
 
 #include "usbd_storage.h"
+#include "usbd_storage_cache.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -149,6 +150,21 @@ USBD_STORAGE_cb_TypeDef USBD_MSC_MICRO_SDIO_fops =
 };
 #endif
 
+static bool STORAGE_ReadStart(uint32_t blk_addr, uint8_t *buf, uint16_t blk_len)
+{
+    return SD_ReadBlocks_DMA(blk_addr, (uint32_t*) buf, 512, blk_len) == SD_OK;
+}
+
+static bool STORAGE_ReadIsComplete(void)
+{
+    return SD_CheckRead() == 0 && SD_GetState() == true;
+}
+
+static const mscCacheOps_t STORAGE_CacheOps = {
+    .readStart = STORAGE_ReadStart,
+    .readIsComplete = STORAGE_ReadIsComplete,
+};
+
 /*******************************************************************************
 * Function Name  : Read_Memory
 * Description    : Handle the Read operation from the microSD card.
@@ -187,6 +203,9 @@ static int8_t STORAGE_Init (uint8_t lun)
         return 1;
     }
 
+    SD_GetCardInfo();
+    mscCacheInit(&STORAGE_CacheOps, SD_CardInfo.CardCapacity);
+
     mscSetActive();
 
     return 0;
@@ -263,9 +282,7 @@ static int8_t STORAGE_Read (uint8_t lun,
         return -1;
     }
     //buf should be 32bit aligned, but usually is so we don't do byte alignment
-    if (SD_ReadBlocks_DMA(blk_addr, (uint32_t*) buf, 512, blk_len) == 0) {
-        while (SD_CheckRead());
-        while(SD_GetState() == false);
+    if (mscCacheRead(buf, blk_addr, blk_len)) {
         mscSetActive();
         return 0;
     }
@@ -287,6 +304,7 @@ static int8_t STORAGE_Write (uint8_t lun,
     if (!sdcard_isInserted()) {
         return -1;
     }
+    mscCacheInvalidate();
     //buf should be 32bit aligned, but usually is so we don't do byte alignment
     if (SD_WriteBlocks_DMA(blk_addr, (uint32_t*) buf, 512, blk_len) == 0) {
         while (SD_CheckWrite());
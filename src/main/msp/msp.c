@@ -40,13 +40,16 @@
 #include "common/axis.h"
 #include "common/bitarray.h"
 #include "common/color.h"
+#include "common/crc.h"
 #include "common/huffman.h"
+#include "common/lz4.h"
 #include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 
 #include "config/config.h"
 #include "config/config_eeprom.h"
+#include "config/config_snapshot.h"
 #include "config/feature.h"
 
 #include "drivers/accgyro/accgyro.h"
@@ -207,6 +210,9 @@ typedef enum {
 static bool vtxTableNeedsInit = false;
 #endif
 
+// MSP_ADJUSTMENT_RANGES sends 14 bytes per range
+STATIC_ASSERT(MAX_ADJUSTMENT_RANGE_COUNT * 14 <= MSP_MAX_REPLY_SIZE, MSP_MAX_REPLY_SIZE_too_small);
+
 static int mspDescriptor = 0;
 
 mspDescriptor_t mspDescriptorAlloc(void)
@@ -507,7 +513,8 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
 #ifdef USE_FLASHFS
 enum compressionType_e {
     NO_COMPRESSION,
-    HUFFMAN
+    HUFFMAN,
+    LZ4,
 };
 
 static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression)
@@ -602,6 +609,74 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
 #endif
     }
 }
+
+#ifdef USE_LZ4
+static DMA_DATA_ZERO_INIT uint8_t dataflashBulkReadBuffer[MSP_PORT_DATAFLASH_BUFFER_SIZE] __attribute__ ((aligned(32)));
+static lz4State_t dataflashBulkLz4State;
+#endif
+
+/*
+ * Bulk read reply for MSP2_DATAFLASH_READ_BULK.
+ *
+ * The number of flash bytes consumed depends only on the request, the
+ * output buffer size and the end of the volume - never on compression -
+ * so the host can compute the next address itself and keep several
+ * requests in flight. Each chunk carries a CRC16 of the uncompressed
+ * data, so corruption is detected end-to-end after decompression.
+ */
+static void serializeDataflashBulkReadReply(sbuf_t *dst, uint32_t address, uint16_t size, bool allowCompression)
+{
+    uint16_t readLen = size;
+    const int bytesRemainingInBuf = sbufBytesRemaining(dst) - MSP_PORT_DATAFLASH_INFO_SIZE;
+    if (readLen > bytesRemainingInBuf) {
+        readLen = bytesRemainingInBuf;
+    }
+    const uint32_t flashfsSize = flashfsGetSize();
+    if (address >= flashfsSize) {
+        readLen = 0;
+    } else if (readLen > flashfsSize - address) {
+        readLen = flashfsSize - address;
+    }
+
+    sbufWriteU32(dst, address);
+    sbufWriteU16(dst, readLen);
+
+    uint8_t *compressionPtr = sbufPtr(dst);
+    sbufWriteU8(dst, NO_COMPRESSION);
+    uint16_t *payloadLenPtr = (uint16_t *)sbufPtr(dst);
+    sbufWriteU16(dst, 0);
+    uint16_t *crcPtr = (uint16_t *)sbufPtr(dst);
+    sbufWriteU16(dst, 0);
+
+    uint8_t *payload = sbufPtr(dst);
+    int payloadLen = readLen;
+
+#ifdef USE_LZ4
+    if (allowCompression && readLen <= sizeof(dataflashBulkReadBuffer)) {
+        const int bytesRead = flashfsReadAbs(address, dataflashBulkReadBuffer, readLen);
+        const int compressedLen = lz4CompressBlock(&dataflashBulkLz4State, payload, readLen, dataflashBulkReadBuffer, bytesRead);
+
+        if (compressedLen > 0) {
+            *compressionPtr = LZ4;
+            payloadLen = compressedLen;
+        } else {
+            // Incompressible - send as is
+            memcpy(payload, dataflashBulkReadBuffer, bytesRead);
+            payloadLen = bytesRead;
+        }
+        *crcPtr = crc16_ccitt_update(0, dataflashBulkReadBuffer, bytesRead);
+    } else
+#else
+    UNUSED(allowCompression);
+#endif
+    {
+        payloadLen = flashfsReadAbs(address, payload, readLen);
+        *crcPtr = crc16_ccitt_update(0, payload, payloadLen);
+    }
+
+    *payloadLenPtr = payloadLen;
+    sbufAdvance(dst, payloadLen);
+}
 #endif // USE_FLASHFS
 
 /*
@@ -1960,6 +2035,20 @@ static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
     return !unsupportedCommand;
 }
 
+// Run one command of a batch, encoding its reply in place after a header of headerSize bytes.
+// Commands are only run while the reply buffer can hold the largest reply of any command.
+static bool mspBatchProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, sbuf_t *dst, int headerSize, mspResult_e *result, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    if (sbufBytesRemaining(dst) < headerSize + MSP_MAX_REPLY_SIZE) {
+        return false;
+    }
+
+    sbufInit(&reply->buf, sbufPtr(dst) + headerSize, dst->end);
+    *result = mspFcProcessCommand(srcDesc, cmd, reply, mspPostProcessFn);
+
+    return true;
+}
+
 static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
 {
 
@@ -2017,36 +2106,123 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_
         break;
     case MSP_MULTIPLE_MSP:
         {
-            uint8_t maxMSPs = 0;
             if (sbufBytesRemaining(src) == 0) {
                 return MSP_RESULT_ERROR;
             }
-            int bytesRemaining = sbufBytesRemaining(dst) - 1; // need to keep one byte for checksum
             mspPacket_t packetIn, packetOut;
             sbufInit(&packetIn.buf, src->end, src->end);
-            uint8_t* resetInputPtr = src->ptr;
-            while (sbufBytesRemaining(src) && bytesRemaining > 0) {
-                uint8_t newMSP = sbufReadU8(src);
-                sbufInit(&packetOut.buf, dst->ptr, dst->end);
-                packetIn.cmd = newMSP;
-                mspFcProcessCommand(srcDesc, &packetIn, &packetOut, NULL);
-                uint8_t mspSize = sbufPtr(&packetOut.buf) - dst->ptr;
-                mspSize++; // need to add length information for each MSP
-                bytesRemaining -= mspSize;
-                if (bytesRemaining >= 0) {
-                    maxMSPs++;
+            // Each reply is prefixed by its size byte. The batch ends at the first reply that does not fit.
+            while (sbufBytesRemaining(src)) {
+                packetIn.cmd = sbufReadU8(src);
+                mspResult_e result;
+                if (packetIn.cmd == MSP_MULTIPLE_MSP ||
+                    !mspBatchProcessCommand(srcDesc, &packetIn, &packetOut, dst, 1, &result, NULL)) {
+                    break;
+                }
+                const int mspSize = sbufPtr(&packetOut.buf) - (sbufPtr(dst) + 1);
+                if (mspSize > 255) {
+                    break;
                 }
+                sbufWriteU8(dst, mspSize);
+                sbufAdvance(dst, mspSize);
             }
-            src->ptr = resetInputPtr;
-            sbufInit(&packetOut.buf, dst->ptr, dst->end);
-            for (int i = 0; i < maxMSPs; i++) {
-                uint8_t* sizePtr = sbufPtr(&packetOut.buf);
-                sbufWriteU8(&packetOut.buf, 0); // dummy
-                packetIn.cmd = sbufReadU8(src);
-                mspFcProcessCommand(srcDesc, &packetIn, &packetOut, NULL);
-                (*sizePtr) = sbufPtr(&packetOut.buf) - (sizePtr + 1);
+        }
+        break;
+
+    case MSP2_CONFIG_SNAPSHOT_READ:
+        {
+            if (sbufBytesRemaining(src) < 5) {
+                return MSP_RESULT_ERROR;
+            }
+
+            const uint8_t flags = sbufReadU8(src);
+            const uint32_t offset = sbufReadU32(src);
+            int length = sbufBytesRemaining(dst) - 7;
+            if (sbufBytesRemaining(src) >= 2) {
+                length = MIN(length, sbufReadU16(src));
+            }
+
+            sbufWriteU32(dst, offset);
+            uint8_t *lastPtr = sbufPtr(dst);
+            sbufWriteU8(dst, 0);
+            uint8_t *lengthPtr = sbufPtr(dst);
+            sbufWriteU16(dst, 0);
+
+            *lastPtr = configSnapshotRead(flags, offset, length, dst);
+
+            const uint16_t dataLength = sbufPtr(dst) - (lengthPtr + 2);
+            lengthPtr[0] = dataLength & 0xFF;
+            lengthPtr[1] = dataLength >> 8;
+        }
+        break;
+
+    case MSP2_CONFIG_SNAPSHOT_WRITE:
+        {
+            // The CLI uses the PG copies the write is staged in
+            if (ARMING_FLAG(ARMED) || cliMode || sbufBytesRemaining(src) < 4) {
+                return MSP_RESULT_ERROR;
+            }
+
+            const uint32_t offset = sbufReadU32(src);
+            const configSnapshotStatus_e status = configSnapshotWrite(offset, src);
+
+            sbufWriteU8(dst, status);
+            sbufWriteU8(dst, configSnapshotSkippedRecords());
+
+            if (status == CONFIG_SNAPSHOT_FAILED) {
+                return MSP_RESULT_ERROR;
+            }
+        }
+        break;
+
+    case MSP2_MULTIPLE_MSP:
+        {
+            if (sbufBytesRemaining(src) == 0) {
+                return MSP_RESULT_ERROR;
+            }
+            // Commands not answered for lack of space are left for the host to resend
+            while (sbufBytesRemaining(src) >= 4 && sbufBytesRemaining(dst) >= 5) {
+                const uint16_t batchCmd = sbufReadU16(src);
+                const uint16_t batchSize = sbufReadU16(src);
+                if (batchSize > sbufBytesRemaining(src)) {
+                    return MSP_RESULT_ERROR;
+                }
+
+                mspPacket_t packetIn = {
+                    .buf = { .ptr = sbufPtr(src), .end = sbufPtr(src) + batchSize, },
+                    .cmd = batchCmd,
+                    .direction = MSP_DIRECTION_REQUEST,
+                };
+                sbufAdvance(src, batchSize);
+
+                mspPacket_t packetOut = {
+                    .direction = MSP_DIRECTION_REPLY,
+                };
+
+                mspResult_e result = MSP_RESULT_ERROR;
+                mspPostProcessFnPtr batchPostProcessFn = NULL;
+                if (batchCmd != MSP_MULTIPLE_MSP && batchCmd != MSP2_MULTIPLE_MSP) {
+                    if (!mspBatchProcessCommand(srcDesc, &packetIn, &packetOut, dst, 5, &result, &batchPostProcessFn)) {
+                        break;
+                    }
+                }
+
+                const bool failed = (result == MSP_RESULT_ERROR || result == MSP_RESULT_CMD_UNKNOWN);
+                const int replySize = failed ? 0 : sbufPtr(&packetOut.buf) - (sbufPtr(dst) + 5);
+
+                sbufWriteU16(dst, batchCmd);
+                sbufWriteU8(dst, failed ? 1 : 0);
+                sbufWriteU16(dst, replySize);
+                sbufAdvance(dst, replySize);
+
+                // A post-process function (e.g. reboot) ends the batch
+                if (batchPostProcessFn) {
+                    if (mspPostProcessFn) {
+                        *mspPostProcessFn = batchPostProcessFn;
+                    }
+                    break;
+                }
             }
-            dst->ptr = packetOut.buf.ptr;
         }
         break;
 
@@ -2149,6 +2325,15 @@ static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
 
     serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
 }
+
+static void mspFcDataFlashBulkReadCommand(sbuf_t *dst, sbuf_t *src)
+{
+    const uint32_t readAddress = sbufReadU32(src);
+    const uint16_t readLength = sbufReadU16(src);
+    const uint8_t flags = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+
+    serializeDataflashBulkReadReply(dst, readAddress, readLength, flags & MSP_DATAFLASH_BULK_FLAG_COMPRESS);
+}
 #endif
 
 static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *src)
@@ -3501,6 +3686,9 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
     } else if (cmdMSP == MSP_DATAFLASH_READ) {
         mspFcDataFlashReadCommand(dst, src);
         ret = MSP_RESULT_ACK;
+    } else if (cmdMSP == MSP2_DATAFLASH_READ_BULK) {
+        mspFcDataFlashBulkReadCommand(dst, src);
+        ret = MSP_RESULT_ACK;
 #endif
     } else {
         ret = mspCommonProcessInCommand(srcDesc, cmdMSP, src, mspPostProcessFn);
@@ -3509,6 +3697,26 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
     return ret;
 }
 
+/*
+ * Runs only side effect free data queries. Used for subscriptions.
+ */
+mspResult_e mspFcProcessOutCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(srcDesc);
+    UNUSED(mspPostProcessFn);
+
+    int ret = MSP_RESULT_CMD_UNKNOWN;
+    sbuf_t *dst = &reply->buf;
+    const int16_t cmdMSP = cmd->cmd;
+    reply->cmd = cmd->cmd;
+
+    if (mspCommonProcessOutCommand(cmdMSP, dst, NULL) || mspProcessOutCommand(cmdMSP, dst)) {
+        ret = MSP_RESULT_ACK;
+    }
+    reply->result = ret;
+    return ret;
+}
+
 void mspFcProcessReply(mspPacket_t *reply)
 {
     //sbuf_t *src = &reply->buf;
@@ -17,3 +17,11 @@
  *
  * If not, see <http://www.gnu.org/licenses/>.
  */
+
+#define MSP2_DATAFLASH_READ_BULK            0x1100  // in: u32 address, u16 size, u8 flags; out: u32 address, u16 size, u8 compression, u16 payload size, u16 crc, payload
+#define MSP2_MULTIPLE_MSP                   0x1101  // in: {u16 cmd, u16 size, payload}[]; out: {u16 cmd, u8 result, u16 size, payload}[]
+#define MSP2_SUBSCRIBE                      0x1102  // in: {u16 cmd, u16 interval ms}[]; out: u8 subscription count
+#define MSP2_CONFIG_SNAPSHOT_READ           0x1103  // in: u8 flags, u32 offset, u16 max length; out: u32 offset, u8 last, u16 length, data
+#define MSP2_CONFIG_SNAPSHOT_WRITE          0x1104  // in: u32 offset, data; out: u8 status, u8 skipped records
+
+#define MSP_DATAFLASH_BULK_FLAG_COMPRESS    0x01
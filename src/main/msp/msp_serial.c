@@ -28,20 +28,26 @@
 
 #include "cli/cli.h"
 
+#include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 #include "common/crc.h"
 
 #include "drivers/system.h"
 
+#include "fc/runtime_config.h"
+
 #include "io/displayport_msp.h"
 
 #include "msp/msp.h"
+#include "msp/msp_protocol_v2_common.h"
 
 #include "msp_serial.h"
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
 
+static uint8_t mspSerialOutBuf[MSP_PORT_OUTBUF_SIZE];
+
 static void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort, bool sharedWithTelemetry)
 {
     memset(mspPortToReset, 0, sizeof(mspPort_t));
@@ -391,10 +397,99 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
     return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen);
 }
 
-static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+/*
+ * MSP2_SUBSCRIBE replaces the subscriptions of the port. Each entry is
+ * a command and its interval; an empty request cancels everything.
+ */
+static mspResult_e mspSerialSubscribe(mspPort_t *msp, sbuf_t *src, sbuf_t *dst)
+{
+    const timeMs_t currentTimeMs = millis();
+    uint8_t count = 0;
+
+    while (sbufBytesRemaining(src) >= 4 && count < MSP_SUBSCRIPTION_COUNT) {
+        const uint16_t cmd = sbufReadU16(src);
+        const uint16_t intervalMs = sbufReadU16(src);
+        if (intervalMs) {
+            mspSubscription_t *sub = &msp->subscriptions[count++];
+            sub->cmd = cmd;
+            sub->intervalMs = MAX(intervalMs, MSP_SUBSCRIPTION_INTERVAL_MIN_MS);
+            sub->nextMs = currentTimeMs + sub->intervalMs;
+        }
+    }
+
+    msp->subscriptionCount = count;
+    msp->subscriptionVersion = msp->mspVersion;
+
+    sbufWriteU8(dst, count);
+
+    return MSP_RESULT_ACK;
+}
+
+/*
+ * Push due subscriptions as regular replies. Pushes are skipped (not
+ * dropped) while the TX buffer is short of space.
+ */
+static void mspSerialProcessSubscriptions(mspPort_t *msp, mspProcessCommandFnPtr mspProcessSubscriptionFn)
 {
-    static uint8_t mspSerialOutBuf[MSP_PORT_OUTBUF_SIZE];
+    if (msp->subscriptionCount == 0) {
+        return;
+    }
+
+    const timeMs_t currentTimeMs = millis();
+
+    if (currentTimeMs - msp->lastActivityMs > MSP_SUBSCRIPTION_TIMEOUT_MS) {
+        msp->subscriptionCount = 0;
+        return;
+    }
+
+    const int pushMax = ARMING_FLAG(ARMED) ? 1 : MSP_MAX_COMMANDS_PER_CYCLE;
+    int pushCount = 0;
+
+    for (int i = 0; i < msp->subscriptionCount && pushCount < pushMax; i++) {
+        mspSubscription_t *sub = &msp->subscriptions[i];
+
+        if (cmp32(currentTimeMs, sub->nextMs) < 0) {
+            continue;
+        }
+
+        if (!isSerialTransmitBufferEmpty(msp->port) &&
+            serialTxBytesFree(msp->port) < MSP_MAX_REPLY_SIZE + MSP_MAX_FRAME_OVERHEAD) {
+            break;
+        }
 
+        mspPacket_t command = {
+            .buf = { .ptr = msp->inBuf, .end = msp->inBuf, },
+            .cmd = sub->cmd,
+            .direction = MSP_DIRECTION_REQUEST,
+        };
+        mspPacket_t reply = {
+            .buf = { .ptr = mspSerialOutBuf, .end = ARRAYEND(mspSerialOutBuf), },
+            .direction = MSP_DIRECTION_REPLY,
+        };
+
+        const mspResult_e status = mspProcessSubscriptionFn(msp->descriptor, &command, &reply, NULL);
+
+        if (status == MSP_RESULT_ACK) {
+            sub->nextMs += sub->intervalMs;
+            if (cmp32(currentTimeMs, sub->nextMs) >= 0) {
+                sub->nextMs = currentTimeMs + sub->intervalMs;
+            }
+        } else {
+            // Only data queries can be subscribed; report the error once and drop it
+            reply.buf.ptr = mspSerialOutBuf;
+            reply.result = MSP_RESULT_ERROR;
+            msp->subscriptions[i--] = msp->subscriptions[--msp->subscriptionCount];
+        }
+
+        sbufSwitchToReader(&reply.buf, mspSerialOutBuf);
+        mspSerialEncode(msp, &reply, msp->subscriptionVersion);
+
+        pushCount++;
+    }
+}
+
+static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+{
     mspPacket_t reply = {
         .buf = { .ptr = mspSerialOutBuf, .end = ARRAYEND(mspSerialOutBuf), },
         .cmd = -1,
@@ -413,7 +508,15 @@ static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspPr
     };
 
     mspPostProcessFnPtr mspPostProcessFn = NULL;
-    const mspResult_e status = mspProcessCommandFn(msp->descriptor, &command, &reply, &mspPostProcessFn);
+    mspResult_e status;
+
+    if (command.cmd == MSP2_SUBSCRIBE) {
+        status = mspSerialSubscribe(msp, &command.buf, &reply.buf);
+        reply.cmd = command.cmd;
+        reply.result = status;
+    } else {
+        status = mspProcessCommandFn(msp->descriptor, &command, &reply, &mspPostProcessFn);
+    }
 
     if (status != MSP_RESULT_NO_REPLY) {
         sbufSwitchToReader(&reply.buf, outBufHead); // change streambuf direction
@@ -483,12 +586,27 @@ static void mspSerialProcessReceivedReply(mspPort_t *msp, mspProcessReplyFnPtr m
     msp->c_state = MSP_IDLE;
 }
 
+/*
+ * A host may pipeline requests (e.g. windowed dataflash downloads). While
+ * disarmed, keep serving queued commands as long as a full size reply can
+ * be sent without being dropped by mspSerialSendFrame().
+ */
+static bool mspSerialCanProcessNextCommand(mspPort_t *mspPort, int commandsProcessed)
+{
+    if (ARMING_FLAG(ARMED) || commandsProcessed >= MSP_MAX_COMMANDS_PER_CYCLE) {
+        return false;
+    }
+
+    return isSerialTransmitBufferEmpty(mspPort->port) ||
+        serialTxBytesFree(mspPort->port) >= MSP_PORT_OUTBUF_SIZE + MSP_MAX_FRAME_OVERHEAD;
+}
+
 /*
  * Process MSP commands from serial ports configured as MSP ports.
  *
  * Called periodically by the scheduler.
  */
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn)
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessCommandFnPtr mspProcessSubscriptionFn, mspProcessReplyFnPtr mspProcessReplyFn)
 {
     for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
         mspPort_t * const mspPort = &mspPorts[portIndex];
@@ -503,6 +621,8 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
             mspPort->lastActivityMs = millis();
             mspPort->pendingRequest = MSP_PENDING_NONE;
 
+            int commandsProcessed = 0;
+
             while (serialRxBytesWaiting(mspPort->port)) {
                 const uint8_t c = serialRead(mspPort->port);
                 const bool consumed = mspSerialProcessReceivedData(mspPort, c);
@@ -519,17 +639,24 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
                     }
 
                     mspPort->c_state = MSP_IDLE;
-                    break; // process one command at a time so as not to block.
+
+                    // process a bounded number of commands so as not to block.
+                    if (mspPostProcessFn || !mspSerialCanProcessNextCommand(mspPort, ++commandsProcessed)) {
+                        break;
+                    }
                 }
             }
 
             if (mspPostProcessFn) {
                 waitForSerialPortToFinishTransmitting(mspPort->port);
                 mspPostProcessFn(mspPort->port);
+                continue;
             }
         } else {
             mspProcessPendingRequest(mspPort);
         }
+
+        mspSerialProcessSubscriptions(mspPort, mspProcessSubscriptionFn);
     }
 }
 
@@ -69,13 +69,26 @@ typedef enum {
 
 #define MSP_PORT_INBUF_SIZE 192
 #define MSP_PORT_OUTBUF_SIZE_MIN 320
+// Largest reply of a single command: MSP_ADJUSTMENT_RANGES generates 32 ranges of 14 bytes
+#define MSP_MAX_REPLY_SIZE 448
+
+// Maximum number of queued commands served per port in one scheduler cycle
+#define MSP_MAX_COMMANDS_PER_CYCLE 4
+// Largest header (V2 over V1 jumbo) plus checksums
+#define MSP_MAX_FRAME_OVERHEAD 18
+
+// Commands a host can have pushed periodically (MSP2_SUBSCRIBE)
+#define MSP_SUBSCRIPTION_COUNT 8
+#define MSP_SUBSCRIPTION_INTERVAL_MIN_MS 10
+// Subscriptions are dropped when the host has been silent this long
+#define MSP_SUBSCRIPTION_TIMEOUT_MS 5000
 
 #ifdef USE_FLASHFS
 #define MSP_PORT_DATAFLASH_BUFFER_SIZE 4096
 #define MSP_PORT_DATAFLASH_INFO_SIZE 16
 #define MSP_PORT_OUTBUF_SIZE (MSP_PORT_DATAFLASH_BUFFER_SIZE + MSP_PORT_DATAFLASH_INFO_SIZE)
 #else
-#define MSP_PORT_OUTBUF_SIZE MSP_PORT_OUTBUF_SIZE_MIN // As of 2021/08/10 MSP_BOXNAMES generates a 307 byte response for page 1.
+#define MSP_PORT_OUTBUF_SIZE 512 // Holds the largest reply, with room for a batch header
 #endif
 
 typedef struct __attribute__((packed)) {
@@ -95,6 +108,12 @@ typedef struct __attribute__((packed)) {
 
 #define MSP_MAX_HEADER_SIZE     9
 
+typedef struct mspSubscription_s {
+    uint16_t cmd;
+    uint16_t intervalMs;
+    timeMs_t nextMs;
+} mspSubscription_t;
+
 struct serialPort_s;
 typedef struct mspPort_s {
     struct serialPort_s *port; // null when port unused.
@@ -112,11 +131,14 @@ typedef struct mspPort_s {
     uint8_t checksum2;
     bool sharedWithTelemetry;
     mspDescriptor_t descriptor;
+    mspVersion_e subscriptionVersion;
+    uint8_t subscriptionCount;
+    mspSubscription_t subscriptions[MSP_SUBSCRIPTION_COUNT];
 } mspPort_t;
 
 void mspSerialInit(void);
 bool mspSerialWaiting(void);
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn);
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessCommandFnPtr mspProcessSubscriptionFn, mspProcessReplyFnPtr mspProcessReplyFn);
 void mspSerialAllocatePorts(void);
 void mspSerialReleasePortIfAllocated(struct serialPort_s *serialPort);
 void mspSerialReleaseSharedTelemetryPorts(void);
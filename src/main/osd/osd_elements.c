@@ -1621,10 +1621,180 @@ const osdElementDrawFn osdElementBackgroundFunction[OSD_ITEM_COUNT] = {
     [OSD_DISPLAY_NAME]            = osdBackgroundDisplayName,
 };
 
+// Element value signatures used by the render cache. Each function returns a
+// value that only changes when the rendered text of the element would change,
+// i.e. the inputs quantized to the element's display resolution. Elements
+// without a signature function are rendered on every frame.
+
+typedef uint32_t (*osdElementValueFn)(const osdElementParms_t *element);
+
+static uint32_t osdValueMainBatteryVoltage(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    const float batteryVoltage = getBatteryVoltage() / 100.0f;
+    const uint32_t symbol = (uint8_t)osdGetBatterySymbol(getBatteryAverageCellVoltage());
+
+    if (batteryVoltage >= 10) {
+        return lrintf(batteryVoltage * 10) | (1 << 16) | (symbol << 24);
+    } else {
+        return lrintf(batteryVoltage * 100) | (symbol << 24);
+    }
+}
+
+static uint32_t osdValueAverageCellVoltage(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    const int cellV = getBatteryAverageCellVoltage();
+
+    return (uint16_t)cellV | ((uint8_t)osdGetBatterySymbol(cellV) << 24);
+}
+
+static uint32_t osdValueCurrentDraw(const osdElementParms_t *element)
+{
+    UNUSED(element);
+    return getBatteryCurrent();
+}
+
+static uint32_t osdValueBatteryUsage(const osdElementParms_t *element)
+{
+    UNUSED(element);
+    return getBatteryCapacityUsed();
+}
+
+static uint32_t osdValueRssi(const osdElementParms_t *element)
+{
+    UNUSED(element);
+    return getRssi() * 100 / 1024;
+}
+
+static uint32_t osdValueThrottlePosition(const osdElementParms_t *element)
+{
+    UNUSED(element);
+    return getThrottlePercent();
+}
+
+static uint32_t osdValueTimer(const osdElementParms_t *element)
+{
+    const uint16_t timer = osdConfig()->timers[element->item - OSD_ITEM_TIMER_1];
+    const uint8_t src = OSD_TIMER_SRC(timer);
+    const timeUs_t value = osdGetTimerValue(src);
+    uint32_t count;
+
+    switch (OSD_TIMER_PRECISION(timer)) {
+    case OSD_TIMER_PREC_HUNDREDTHS:
+        count = value / 10000;
+        break;
+    case OSD_TIMER_PREC_TENTHS:
+        count = value / 100000;
+        break;
+    case OSD_TIMER_PREC_SECOND:
+    default:
+        count = value / 1000000;
+        break;
+    }
+
+    return (count << 8) | (uint8_t)osdGetTimerSymbol(src);
+}
+
+static uint32_t osdValuePidRateProfile(const osdElementParms_t *element)
+{
+    UNUSED(element);
+    return (getCurrentPidProfileIndex() << 8) | getCurrentControlRateProfileIndex();
+}
+
+#ifdef USE_ESC_SENSOR
+static uint32_t osdValueEscTemperature(const osdElementParms_t *element)
+{
+    UNUSED(element);
+    return featureIsEnabled(FEATURE_ESC_SENSOR) ? (uint32_t)osdEscDataCombined->temperature : UINT32_MAX;
+}
+#endif
+
+#ifdef USE_ADC_INTERNAL
+static uint32_t osdValueCoreTemperature(const osdElementParms_t *element)
+{
+    UNUSED(element);
+    return getCoreTemperatureCelsius();
+}
+#endif
+
+#ifdef USE_RX_LINK_QUALITY_INFO
+static uint32_t osdValueLinkQuality(const osdElementParms_t *element)
+{
+    UNUSED(element);
+    return rxGetLinkQuality() | (rxGetRfMode() << 16) | (linkQualitySource << 24);
+}
+#endif
+
+static const osdElementValueFn osdElementValueFunction[OSD_ITEM_COUNT] = {
+    [OSD_RSSI_VALUE]              = osdValueRssi,
+    [OSD_MAIN_BATT_VOLTAGE]       = osdValueMainBatteryVoltage,
+    [OSD_ITEM_TIMER_1]            = osdValueTimer,
+    [OSD_ITEM_TIMER_2]            = osdValueTimer,
+    [OSD_THROTTLE_POS]            = osdValueThrottlePosition,
+    [OSD_CURRENT_DRAW]            = osdValueCurrentDraw,
+    [OSD_MAH_DRAWN]               = osdValueBatteryUsage,
+    [OSD_PIDRATE_PROFILE]         = osdValuePidRateProfile,
+    [OSD_AVG_CELL_VOLTAGE]        = osdValueAverageCellVoltage,
+    [OSD_MAIN_BATT_USAGE]         = osdValueBatteryUsage,
+#ifdef USE_ESC_SENSOR
+    [OSD_ESC_TMP]                 = osdValueEscTemperature,
+#endif
+#ifdef USE_ADC_INTERNAL
+    [OSD_CORE_TEMPERATURE]        = osdValueCoreTemperature,
+#endif
+#ifdef USE_RX_LINK_QUALITY_INFO
+    [OSD_LINK_QUALITY]            = osdValueLinkQuality,
+#endif
+};
+
+// Rendered text of the elements with a value signature, so that unchanged
+// elements can be written to the display without being formatted again.
+
+#define OSD_ELEMENT_CACHE_SIZE  16
+#define OSD_ELEMENT_CACHE_NONE  0xff
+
+typedef struct osdElementCache_s {
+    uint32_t value;
+    uint8_t attr;
+    bool valid;
+    char buff[OSD_ELEMENT_BUFFER_LENGTH];
+} osdElementCache_t;
+
+static osdElementCache_t osdElementCache[OSD_ELEMENT_CACHE_SIZE];
+static uint8_t osdElementCacheSlot[OSD_ITEM_COUNT];
+static unsigned osdElementCacheCount;
+static unsigned osdElementCacheFrames;
+
+static void osdElementCacheInvalidate(void)
+{
+    for (unsigned i = 0; i < OSD_ELEMENT_CACHE_SIZE; i++) {
+        osdElementCache[i].valid = false;
+    }
+    osdElementCacheFrames = 0;
+}
+
+static void osdElementCacheReset(void)
+{
+    memset(osdElementCacheSlot, OSD_ELEMENT_CACHE_NONE, sizeof(osdElementCacheSlot));
+    osdElementCacheCount = 0;
+    osdElementCacheInvalidate();
+}
+
+static void osdElementCacheAssign(osd_items_e element)
+{
+    if (osdElementValueFunction[element] && osdElementCacheCount < OSD_ELEMENT_CACHE_SIZE) {
+        osdElementCacheSlot[element] = osdElementCacheCount++;
+    }
+}
+
 static void osdAddActiveElement(osd_items_e element)
 {
     if (VISIBLE(osdElementConfig()->item_pos[element])) {
         activeOsdElementArray[activeOsdElementCount++] = element;
+        osdElementCacheAssign(element);
     }
 }
 
@@ -1634,6 +1804,7 @@ static void osdAddActiveElement(osd_items_e element)
 void osdAddActiveElements(void)
 {
     activeOsdElementCount = 0;
+    osdElementCacheReset();
 
 #ifdef USE_ACC
     if (sensors(SENSOR_ACC)) {
@@ -1701,11 +1872,33 @@ static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
     element.drawElement = true;
     element.attr = DISPLAYPORT_ATTR_NONE;
 
+    // Reuse the previously rendered text if the displayed value hasn't changed
+    osdElementCache_t *cache = NULL;
+    uint32_t value = 0;
+
+    if (osdElementCacheSlot[item] != OSD_ELEMENT_CACHE_NONE) {
+        cache = &osdElementCache[osdElementCacheSlot[item]];
+        value = osdElementValueFunction[item](&element);
+
+        if (cache->valid && cache->value == value) {
+            osdDisplayWrite(&element, elemPosX, elemPosY, cache->attr, cache->buff);
+            return;
+        }
+    }
+
     // Call the element drawing function
     osdElementDrawFunction[item](&element);
     if (element.drawElement) {
         osdDisplayWrite(&element, elemPosX, elemPosY, element.attr, buff);
     }
+
+    if (cache) {
+        // Elements drawing themselves directly can't be replayed from the cache
+        cache->valid = element.drawElement;
+        cache->value = value;
+        cache->attr = element.attr;
+        memcpy(cache->buff, buff, sizeof(cache->buff));
+    }
 }
 
 static void osdDrawSingleElementBackground(displayPort_t *osdDisplayPort, uint8_t item)
@@ -1768,6 +1961,12 @@ bool osdDrawNextActiveElement(displayPort_t *osdDisplayPort, timeUs_t currentTim
     if (++activeElement >= activeOsdElementCount) {
         activeElement = 0;
         retval = false;
+
+        // Render everything afresh once a second to pick up changes in
+        // settings (units, alarms, element types) the signatures don't cover
+        if (++osdElementCacheFrames >= osdConfig()->framerate_hz) {
+            osdElementCacheInvalidate();
+        }
     }
 
     return retval;
@@ -1789,6 +1988,7 @@ void osdElementsInit(bool backgroundLayerFlag)
 {
     backgroundLayerSupported = backgroundLayerFlag;
     activeOsdElementCount = 0;
+    osdElementCacheReset();
     pt1FilterInit(&batteryEfficiencyFilt, EFFICIENCY_CUTOFF_HZ, osdConfig()->framerate_hz);
 }
 
@@ -79,6 +79,7 @@ PG_RESET_TEMPLATE(rcControlsConfig_t, rcControlsConfig,
     .rc_yaw_deadband = 2,
     .rc_smoothness = 50,
     .rc_threshold = { 25, 25, 25, 50 },
+    .rc_prediction = 0,
 );
 
 #endif
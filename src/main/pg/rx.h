@@ -63,6 +63,7 @@ typedef struct rcControlsConfig_s {
     uint8_t  rc_yaw_deadband;           // A deadband around the stick center for yaw axis
     uint8_t  rc_smoothness;             // Minimum RPYC smoothing level
     uint8_t  rc_threshold[4];           // Threshold for stick activity
+    uint8_t  rc_prediction;             // RPYC extrapolation between RX frames (percent)
 } rcControlsConfig_t;
 
 PG_DECLARE(rcControlsConfig_t, rcControlsConfig);
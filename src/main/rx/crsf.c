@@ -348,14 +348,28 @@ STATIC_UNIT_TESTED uint8_t crsfFrameCmdCRC(void)
 }
 
 // Receive ISR callback, called back from serial port
+static uint8_t crsfFramePosition = 0;
+#if defined(USE_CRSF_V3)
+static uint8_t crsfFrameErrorCnt = 0;
+#endif
+
+static void crsfFrameResync(void)
+{
+#if defined(USE_CRSF_V3)
+    if (crsfFramePosition > 0) {
+        // count an error if full valid frame not received within the allowed time.
+        crsfFrameErrorCnt++;
+    }
+#endif
+    crsfFramePosition = 0;
+}
+
+static void crsfProcessByte(rxRuntimeState_t *rxRuntimeState, uint8_t c, timeUs_t currentTimeUs);
+
 STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
 {
     rxRuntimeState_t *const rxRuntimeState = (rxRuntimeState_t *const)data;
 
-    static uint8_t crsfFramePosition = 0;
-#if defined(USE_CRSF_V3)
-    static uint8_t crsfFrameErrorCnt = 0;
-#endif
     const timeUs_t currentTimeUs = microsISR();
 
 #ifdef DEBUG_CRSF_PACKETS
@@ -365,18 +379,34 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     if (cmpTimeUs(currentTimeUs, crsfFrameStartAtUs) > CRSF_TIME_NEEDED_PER_FRAME_US) {
         // We've received a character after max time needed to complete a frame,
         // so this must be the start of a new frame.
-#if defined(USE_CRSF_V3)
-        if (crsfFramePosition > 0) {
-            // count an error if full valid frame not received within the allowed time.
-            crsfFrameErrorCnt++;
-        }
-#endif
-        crsfFramePosition = 0;
+        crsfFrameResync();
     }
 
     if (crsfFramePosition == 0) {
         crsfFrameStartAtUs = currentTimeUs;
     }
+
+    crsfProcessByte(rxRuntimeState, c, currentTimeUs);
+}
+
+// Receives everything up to a line idle, timestamped with the end of the last byte
+static void crsfFrameReceive(const uint8_t *data, uint16_t len, timeUs_t frameTimeUs, void *callbackData)
+{
+    rxRuntimeState_t *const rxRuntimeState = (rxRuntimeState_t *const)callbackData;
+
+    // A new idle period always starts a new frame; a buffer wrap continues the current one
+    if (frameTimeUs != crsfFrameStartAtUs) {
+        crsfFrameResync();
+        crsfFrameStartAtUs = frameTimeUs;
+    }
+
+    while (len--) {
+        crsfProcessByte(rxRuntimeState, *data++, frameTimeUs);
+    }
+}
+
+static void crsfProcessByte(rxRuntimeState_t *rxRuntimeState, uint8_t c, timeUs_t currentTimeUs)
+{
     // assume frame is 5 bytes long until we have received the frame length
     // full frame length includes the length of the address and framelength fields
     // sometimes we can receive some garbage data. So, we need to check max size for preventing buffer overrun.
@@ -652,6 +682,11 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
         CRSF_PORT_OPTIONS | (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0)
         );
 
+    if (serialPort) {
+        // Use DMA/idle line frame reception where the port supports it
+        serialSetFrameCallback(serialPort, crsfFrameReceive);
+    }
+
     if (rssiSource == RSSI_SOURCE_NONE) {
         rssiSource = RSSI_SOURCE_RX_PROTOCOL_CRSF;
     }
@@ -84,6 +84,43 @@ static volatile DMA_DATA uint8_t telemetryPacket[ELRS_RX_TX_BUFF_SIZE];
 static volatile rx_spi_received_e rfPacketStatus = RX_SPI_RECEIVED_NONE;
 static volatile uint8_t *payload;
 
+/*
+ * ISR execution time histogram. Bucket n counts the ISR runs that took
+ * less than 4 << n us, the last bucket counts all the longer ones.
+ */
+#define ELRS_ISR_HISTOGRAM_BUCKETS 6
+
+static volatile uint32_t isrHistogram[ELRS_ISR_HISTOGRAM_BUCKETS];
+static volatile uint32_t isrTimeLastUs = 0;
+static volatile uint32_t isrTimeMaxUs = 0;
+
+static void isrTimingRecord(uint32_t startCycles)
+{
+    const uint32_t timeUs = clockCyclesToMicros(getCycleCounter() - startCycles);
+
+    unsigned bucket = 0;
+    while (bucket < ELRS_ISR_HISTOGRAM_BUCKETS - 1 && timeUs >= (4U << bucket)) {
+        bucket++;
+    }
+
+    isrHistogram[bucket]++;
+    isrTimeLastUs = timeUs;
+
+    if (timeUs > isrTimeMaxUs) {
+        isrTimeMaxUs = timeUs;
+    }
+}
+
+static void isrTimingDebug(void)
+{
+    DEBUG_SET(DEBUG_RX_EXPRESSLRS_ISR, 0, isrTimeLastUs);
+    DEBUG_SET(DEBUG_RX_EXPRESSLRS_ISR, 1, isrTimeMaxUs);
+
+    for (unsigned i = 0; i < ELRS_ISR_HISTOGRAM_BUCKETS; i++) {
+        DEBUG_SET(DEBUG_RX_EXPRESSLRS_ISR, i + 2, isrHistogram[i]);
+    }
+}
+
 static void rssiFilterReset(void)
 {
     simpleLPFilterInit(&rssiFilter, 2, 5);
@@ -470,6 +507,8 @@ static void updatePhaseLock(void)
 //hwTimerCallbackTick
 void expressLrsOnTimerTickISR(void) // this is 180 out of phase with the other callback, occurs mid-packet reception
 {
+    const uint32_t startCycles = getCycleCounter();
+
     updatePhaseLock();
     receiver.nonceRX += 1;
 
@@ -484,16 +523,22 @@ void expressLrsOnTimerTickISR(void) // this is 180 out of phase with the other c
     receiver.alreadyFhss = false;
 
     receiver.rxHandleFromTick();
+
+    isrTimingRecord(startCycles);
 }
 
 //hwTimerCallbackTock
 void expressLrsOnTimerTockISR(void)
 {
+    const uint32_t startCycles = getCycleCounter();
+
     uint32_t currentTimeUs = micros();
 
     phaseLockEprEvent(EPR_INTERNAL, currentTimeUs);
 
     receiver.rxHandleFromTock();
+
+    isrTimingRecord(startCycles);
 }
 
 static uint16_t lostConnectionCounter = 0;
@@ -606,7 +651,7 @@ static void unpackBindPacket(volatile uint8_t *packet)
 }
 
 /**
- * Process the assembled MSP packet in mspBuffer[]
+ * Collect an RF MSP packet into mspBuffer[]
  **/
 static void processRFMspPacket(volatile uint8_t *packet)
 {
@@ -629,6 +674,16 @@ static void processRFMspPacket(volatile uint8_t *packet)
     if (currentMspConfirmValue != getCurrentMspConfirm()) {
         nextTelemetryType = ELRS_TELEMETRY_TYPE_LINK;
     }
+#endif
+}
+
+/**
+ * Handle a completed MSP message. Called from the RX task, the receive
+ * side holds off further MSP data until mspReceiverUnlock().
+ **/
+static void processMspData(void)
+{
+#ifdef USE_MSP_OVER_TELEMETRY
     if (hasFinishedMspData()) {
         if (mspBuffer[ELRS_MSP_COMMAND_INDEX] == ELRS_MSP_SET_RX_CONFIG && mspBuffer[ELRS_MSP_COMMAND_INDEX + 1] == ELRS_MSP_MODEL_ID) { //mspReceiverComplete
             if (rxExpressLrsSpiConfig()->modelId != mspBuffer[9]) { //UpdateModelMatch
@@ -697,7 +752,7 @@ static bool processRFSyncPacket(volatile uint8_t *packet, const uint32_t timeSta
     return false;
 }
 
-rx_spi_received_e processRFPacket(volatile uint8_t *payload, uint32_t timeStampUs)
+static rx_spi_received_e processRFPacketData(volatile uint8_t *payload, uint32_t timeStampUs)
 {
     elrsPacketType_e type = dmaBuffer[0] & 0x03;
     uint16_t inCRC = (((uint16_t)(dmaBuffer[0] & 0xFC)) << 6 ) | dmaBuffer[7];
@@ -768,6 +823,17 @@ rx_spi_received_e processRFPacket(volatile uint8_t *payload, uint32_t timeStampU
     return RX_SPI_RECEIVED_DATA;
 }
 
+rx_spi_received_e processRFPacket(volatile uint8_t *payload, uint32_t timeStampUs)
+{
+    const uint32_t startCycles = getCycleCounter();
+
+    const rx_spi_received_e status = processRFPacketData(payload, timeStampUs);
+
+    isrTimingRecord(startCycles);
+
+    return status;
+}
+
 static void updateTelemetryBurst(void)
 {
     if (telemBurstValid) {
@@ -1039,7 +1105,10 @@ void expressLrsHandleTelemetryUpdate(void)
     uint8_t *nextPayload = 0;
     uint8_t nextPlayloadSize = 0;
     if (!isTelemetrySenderActive() && getNextTelemetryPayload(&nextPlayloadSize, &nextPayload)) {
-        setTelemetryDataToTransmit(nextPlayloadSize, nextPayload, ELRS_TELEMETRY_BYTES_PER_CALL);
+        // The sender is read from the packet ISR
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            setTelemetryDataToTransmit(nextPlayloadSize, nextPayload, ELRS_TELEMETRY_BYTES_PER_CALL);
+        }
     }
     updateTelemetryBurst();
 }
@@ -1064,7 +1133,9 @@ static void enterBindingMode(void)
 
 void expressLrsDoTelem(void)
 {
-    expressLrsHandleTelemetryUpdate();
+    const uint32_t startCycles = getCycleCounter();
+
+    // The telemetry payload is prepared by expressLrsHandleTelemetryUpdate() in the RX task
     expressLrsSendTelemResp();
     
     if (rxExpressLrsSpiConfig()->domain != ISM2400 && !receiver.didFhss && !expressLrsTelemRespReq() && lqPeriodIsSet()) {
@@ -1072,6 +1143,8 @@ void expressLrsDoTelem(void)
         // TODO this needs to be DMA aswell, SX127x unlikely to work right now
         receiver.handleFreqCorrection(receiver.freqOffset, receiver.currentFreq); //corrects for RX freq offset
     }
+
+    isrTimingRecord(startCycles);
 }
 
 rx_spi_received_e expressLrsDataReceived(uint8_t *payloadBuffer)
@@ -1099,6 +1172,11 @@ rx_spi_received_e expressLrsDataReceived(uint8_t *payloadBuffer)
     handleConfigUpdate(timeStampMs);
     handleLinkStatsUpdate(timeStampMs);
 
+    processMspData();
+    expressLrsHandleTelemetryUpdate();
+
+    isrTimingDebug();
+
     DEBUG_SET(DEBUG_RX_EXPRESSLRS_SPI, 0, lostConnectionCounter);
     DEBUG_SET(DEBUG_RX_EXPRESSLRS_SPI, 1, receiver.rssiFiltered);
     DEBUG_SET(DEBUG_RX_EXPRESSLRS_SPI, 2, receiver.snr);
@@ -1124,7 +1202,11 @@ void expressLrsStop(void)
 void expressLrsISR(bool runAlways)
 {
     if (runAlways || !expressLrsTimerIsRunning()) {
+        const uint32_t startCycles = getCycleCounter();
+
         receiver.rxISR();
+
+        isrTimingRecord(startCycles);
     }
 }
 #endif /* USE_RX_EXPRESSLRS */
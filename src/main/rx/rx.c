@@ -102,6 +102,7 @@ static bool rxSignalReceived = false;
 static bool rxFlightChannelsValid = false;
 
 static timeUs_t needRxSignalBefore = 0;
+static timeUs_t rxFrameArrivalTimeUs = 0;
 static timeUs_t suspendRxSignalUntil = 0;
 static uint8_t  skipRxSamples = 0;
 
@@ -503,6 +504,7 @@ void rxFrameCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
 
     if (signalReceived) {
         //  true only when a new packet arrives
+        rxFrameArrivalTimeUs = currentTimeUs;
         needRxSignalBefore = currentTimeUs + needRxSignalMaxDelayUs;
         rxSignalReceived = true; // immediately process packet data
         if (useDataDrivenProcessing) {
@@ -850,14 +852,23 @@ bool isRssiConfigured(void)
     return rssiSource != RSSI_SOURCE_NONE;
 }
 
+timeUs_t rxGetFrameTimeUs(void)
+{
+    // Use the protocol timestamp if available, otherwise the time the frame was noticed
+    if (rxRuntimeState.rcFrameTimeUsFn)
+        return rxRuntimeState.rcFrameTimeUsFn();
+
+    return rxFrameArrivalTimeUs;
+}
+
 timeDelta_t rxGetFrameDelta(timeDelta_t *frameAgeUs)
 {
     static timeUs_t previousFrameTimeUs = 0;
     static timeDelta_t frameTimeDeltaUs = 0;
 
-    if (rxRuntimeState.rcFrameTimeUsFn) {
-        const timeUs_t frameTimeUs = rxRuntimeState.rcFrameTimeUsFn();
+    const timeUs_t frameTimeUs = rxGetFrameTimeUs();
 
+    if (frameTimeUs) {
         *frameAgeUs = cmpTimeUs(micros(), frameTimeUs);
 
         const timeDelta_t deltaUs = cmpTimeUs(frameTimeUs, previousFrameTimeUs);
@@ -226,5 +226,6 @@ void resumeRxSignal(void);
 uint16_t rxGetRefreshRate(void);
 
 timeDelta_t rxGetFrameDelta(timeDelta_t *frameAgeUs);
+timeUs_t rxGetFrameTimeUs(void);
 
 timeUs_t rxFrameTimeUs(void);
@@ -170,6 +170,12 @@ typedef enum {
     TASK_SPEED_NEGOTIATION,
 #endif
 
+#ifdef USE_CONFIG_JOURNAL_TASK
+    TASK_CONFIG_JOURNAL,
+#endif
+
+    TASK_DEFERRED_INIT,
+
     /* Count of real tasks */
     TASK_COUNT,
 
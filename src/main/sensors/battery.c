@@ -166,6 +166,11 @@ uint16_t getLegacyBatteryVoltage(void)
 
 uint16_t getBatteryVoltageSample(void)
 {
+    // ADC is read directly, so that callers faster than the battery task see fresh data
+    if (batteryConfig()->voltageMeterSource == VOLTAGE_METER_ADC) {
+        return voltageSensorADCSample(VOLTAGE_SENSOR_ADC_BAT) / 10;
+    }
+
     return voltageMeter.sample / 10;
 }
 
@@ -200,6 +205,10 @@ uint16_t getLegacyBatteryCurrent(void)
 
 uint16_t getBatteryCurrentSample(void)
 {
+    if (batteryConfig()->currentMeterSource == CURRENT_METER_ADC) {
+        return currentSensorADCSample(CURRENT_SENSOR_ADC_BAT) / 10;
+    }
+
     return currentMeter.sample / 10;
 }
 
@@ -143,6 +143,21 @@ void currentSensorADCRefresh(timeUs_t currentTimeUs)
 #endif
 }
 
+// Fresh (unfiltered) conversion of the latest averaged ADC value in mA
+uint32_t currentSensorADCSample(currentSensorADC_e sensor)
+{
+#ifdef USE_ADC
+    if (currentADCSensors[sensor].enabled) {
+        const uint16_t sample = adcGetChannel(currentSensorAdcChannelMap[sensor]);
+        return currentSensorADCToCurrent(sensor, sample);
+    }
+#else
+    UNUSED(sensor);
+#endif
+
+    return 0;
+}
+
 bool currentSensorADCRead(currentSensorADC_e sensor, currentMeter_t *meter)
 {
 #ifdef USE_ADC
@@ -60,6 +60,7 @@ typedef struct {
 void currentSensorADCInit(void);
 void currentSensorADCRefresh(timeUs_t currentTimeUs);
 bool currentSensorADCRead(currentSensorADC_e sensor, currentMeter_t *meter);
+uint32_t currentSensorADCSample(currentSensorADC_e sensor);
 
 void currentSensorESCInit(void);
 void currentSensorESCRefresh(void);
@@ -18,6 +18,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -40,6 +41,7 @@
 #include "common/maths.h"
 #include "common/utils.h"
 
+#include "drivers/time.h"
 #include "drivers/timer.h"
 #include "drivers/motor.h"
 #include "drivers/dshot.h"
@@ -97,6 +99,7 @@ enum {
     DEBUG_FRAME_CRC_ERRORS,
     DEBUG_FRAME_TIMEOUTS,
     DEBUG_FRAME_BUFFER,
+    DEBUG_FRAME_OVERRUNS,
 };
 
 #define TELEMETRY_BUFFER_SIZE    140
@@ -120,6 +123,7 @@ static escSensorData_t escSensorDataCombined;
 static bool combinedNeedsUpdate = true;
 
 static timeUs_t dataUpdateUs = 0;
+static timeUs_t rpmSampleUs[MAX_SUPPORTED_MOTORS];
 static timeUs_t consumptionUpdateUs = 0;
 
 static float consumptionDelta = 0.0f;
@@ -184,6 +188,11 @@ uint32_t getEscSensorRPM(uint8_t motorNumber)
     return (escSensorData[motorNumber].age <= ESC_BATTERY_AGE_MAX) ? escSensorData[motorNumber].erpm : 0;
 }
 
+timeUs_t getEscSensorRPMTimestamp(uint8_t motorNumber)
+{
+    return rpmSampleUs[motorNumber];
+}
+
 static void combinedDataUpdate(void)
 {
     const int motorCount = getMotorCount();
@@ -287,6 +296,208 @@ static void updateConsumption(timeUs_t currentTimeUs)
 }
 
 
+/*
+ * Frame reception
+ *
+ * If the UART supports it, the ESC sensor port is switched to frame mode.
+ * The UART then receives by DMA (or into its RX buffer) and reports
+ * everything received up to a line idle in one callback. That is one
+ * interrupt per telemetry frame instead of one per byte, and each frame
+ * comes with the time it was received.
+ *
+ * Protocols with a receive callback still get their bytes delivered from
+ * the interrupt. The streaming protocols get whole frames queued for the
+ * sensor task, where they are validated against the frame table of the
+ * protocol and handed to its field decoder.
+ */
+
+#define ESC_RX_FRAME_COUNT      4
+#define ESC_RX_FRAME_SIZE       64
+
+typedef struct {
+    timeUs_t    timeUs;
+    uint8_t     length;
+    uint8_t     data[ESC_RX_FRAME_SIZE];
+} escRxFrame_t;
+
+static escRxFrame_t escRxFrames[ESC_RX_FRAME_COUNT];
+static volatile uint8_t escRxFrameHead = 0;
+static volatile uint8_t escRxFrameTail = 0;
+
+static bool escRxFrameMode = false;
+static volatile timeUs_t escRxFrameTimeUs = 0;
+static serialReceiveCallbackPtr escRxByteCallback = NULL;
+
+static uint32_t totalOverrunCount = 0;
+
+static FAST_CODE void escSensorFrameReceive(const uint8_t *data, uint16_t len, timeUs_t frameTimeUs, void *callbackData)
+{
+    if (escRxByteCallback) {
+        escRxFrameTimeUs = frameTimeUs;
+        while (len--) {
+            escRxByteCallback(*data++, callbackData);
+        }
+        return;
+    }
+
+    // Queue the chunk in as many slots as it needs. The decoder carries
+    // a partial frame over to the next slot.
+    while (len) {
+        const uint8_t next = (escRxFrameHead + 1) % ESC_RX_FRAME_COUNT;
+
+        if (next == escRxFrameTail) {
+            totalOverrunCount++;
+            return;
+        }
+
+        escRxFrame_t *frame = &escRxFrames[escRxFrameHead];
+        const uint8_t count = MIN(len, ESC_RX_FRAME_SIZE);
+
+        frame->timeUs = frameTimeUs;
+        frame->length = count;
+        memcpy(frame->data, data, count);
+
+        data += count;
+        len -= count;
+
+        escRxFrameHead = next;
+    }
+}
+
+// Capture time of the frame being decoded by a byte callback protocol
+static timeUs_t escSensorFrameTime(void)
+{
+    return escRxFrameMode ? escRxFrameTimeUs : micros();
+}
+
+
+/*
+ * Table driven framing for the streaming protocols
+ */
+
+#define ESC_FRAME_SYNC_MAX      4
+#define ESC_FRAME_LENGTHS       2
+
+typedef enum {
+    ESC_FRAME_PENDING = 0,
+    ESC_FRAME_VALID,
+    ESC_FRAME_INVALID,
+} escFrameStatus_e;
+
+// Validate buffer[0..length) as a frame candidate (length, CRC, fixed fields)
+typedef escFrameStatus_e (*escFrameCheckPtr)(uint8_t length);
+
+// Decode the fields of a validated frame in buffer[]
+typedef void (*escFrameDecodePtr)(uint8_t length, timeUs_t frameTimeUs);
+
+typedef struct {
+    uint8_t             sync[ESC_FRAME_SYNC_MAX];       // Sync bytes starting each frame
+    uint8_t             syncLength;
+    uint8_t             syncFrames;                     // Frames in sync before decoding starts
+    uint8_t             filler;                         // Byte skipped between frames, 0 = none
+    uint8_t             lengths[ESC_FRAME_LENGTHS];     // Possible frame lengths, ascending, 0 = unused
+    escFrameCheckPtr    check;
+    escFrameDecodePtr   decode;
+} escFrameSpec_t;
+
+static bool escFrameIsLength(const escFrameSpec_t *spec, uint8_t length)
+{
+    for (int i = 0; i < ESC_FRAME_LENGTHS; i++) {
+        if (spec->lengths[i] == length)
+            return true;
+    }
+    return false;
+}
+
+static uint8_t escFrameMaxLength(const escFrameSpec_t *spec)
+{
+    uint8_t length = 0;
+
+    for (int i = 0; i < ESC_FRAME_LENGTHS; i++) {
+        length = MAX(length, spec->lengths[i]);
+    }
+    return length;
+}
+
+static void escFrameComplete(const escFrameSpec_t *spec, escFrameStatus_e status, uint8_t length, timeUs_t frameTimeUs, timeUs_t currentTimeUs)
+{
+    readBytes = 0;
+
+    if (status == ESC_FRAME_VALID) {
+        if (syncCount > spec->syncFrames) {
+            spec->decode(length, frameTimeUs);
+            dataUpdateUs = currentTimeUs;
+            totalFrameCount++;
+        }
+    }
+    else {
+        totalCrcErrorCount++;
+    }
+}
+
+static void escFrameByte(const escFrameSpec_t *spec, uint8_t dataByte, timeUs_t frameTimeUs, timeUs_t currentTimeUs)
+{
+    totalByteCount++;
+
+    buffer[readBytes++] = dataByte;
+
+    if (readBytes == 1 && spec->filler && dataByte == spec->filler) {
+        readBytes = 0;
+    }
+    else if (readBytes <= spec->syncLength) {
+        if (dataByte != spec->sync[readBytes - 1])
+            frameSyncError();
+        else if (readBytes == spec->syncLength)
+            syncCount++;
+    }
+    else if (escFrameIsLength(spec, readBytes)) {
+        escFrameStatus_e status = spec->check(readBytes);
+
+        if (status == ESC_FRAME_PENDING && readBytes >= escFrameMaxLength(spec))
+            status = ESC_FRAME_INVALID;
+
+        if (status != ESC_FRAME_PENDING)
+            escFrameComplete(spec, status, readBytes, frameTimeUs, currentTimeUs);
+    }
+}
+
+static void escFrameBlock(const escFrameSpec_t *spec, const uint8_t *data, uint8_t length, timeUs_t frameTimeUs, timeUs_t currentTimeUs)
+{
+    // Whole frame received, validate it in one go
+    if (readBytes == 0 && escFrameIsLength(spec, length) && memcmp(data, spec->sync, spec->syncLength) == 0) {
+        memcpy(buffer, data, length);
+        totalByteCount += length;
+        syncCount++;
+
+        const escFrameStatus_e status = spec->check(length);
+
+        escFrameComplete(spec, (status == ESC_FRAME_VALID) ? ESC_FRAME_VALID : ESC_FRAME_INVALID, length, frameTimeUs, currentTimeUs);
+    }
+    else {
+        // Partial or several frames, continue byte by byte from where the last chunk ended
+        while (length--) {
+            escFrameByte(spec, *data++, frameTimeUs, currentTimeUs);
+        }
+    }
+}
+
+static void escFrameProcess(const escFrameSpec_t *spec, timeUs_t currentTimeUs)
+{
+    if (escRxFrameMode) {
+        while (escRxFrameTail != escRxFrameHead) {
+            const escRxFrame_t *frame = &escRxFrames[escRxFrameTail];
+            escFrameBlock(spec, frame->data, frame->length, frame->timeUs, currentTimeUs);
+            escRxFrameTail = (escRxFrameTail + 1) % ESC_RX_FRAME_COUNT;
+        }
+    }
+    else {
+        while (serialRxBytesWaiting(escSensorPort)) {
+            escFrameByte(spec, serialRead(escSensorPort), currentTimeUs, currentTimeUs);
+        }
+    }
+}
+
+
 /*
  * BLHeli32 / KISS Telemetry Protocol
  *
@@ -369,6 +580,7 @@ static uint8_t blDecodeTelemetryFrame(void)
         uint16_t erpm = buffer[7] << 8 | buffer[8];
 
         escSensorData[currentEsc].age = 0;
+        rpmSampleUs[currentEsc] = escSensorFrameTime();
         escSensorData[currentEsc].erpm = erpm * 100;
         escSensorData[currentEsc].voltage = volt * 10;
         escSensorData[currentEsc].current = curr * 10;
@@ -579,131 +791,123 @@ static inline float calcCurrHW(uint16_t currentADC)
         (currentADC - hw4CurrentOffset) * hw4CurrentScale : 0;
 }
 
-#define HW4_FRAME_NONE   0
-#define HW4_FRAME_INFO   1
-#define HW4_FRAME_DATA   2
+#define HW4_INFO_FRAME_LENGTH   13
+#define HW4_DATA_FRAME_LENGTH   19
 
-static uint8_t processHW4TelemetryStream(uint8_t dataByte)
+static escFrameStatus_e hw4FrameCheck(uint8_t length)
 {
-    totalByteCount++;
+    if (length == HW4_INFO_FRAME_LENGTH) {
+        // Info frame, or the first part of a data frame
+        if (buffer[1] == 0x9B && buffer[4] == 0x01 && buffer[12] == 0xB9)
+            return ESC_FRAME_VALID;
+        return ESC_FRAME_PENDING;
+    }
 
-    buffer[readBytes++] = dataByte;
+    if (buffer[4] < 4 && buffer[6] < 4 && buffer[11] < 0x10 &&
+        buffer[13] < 0x10 && buffer[15] < 0x10 && buffer[17] < 0x10)
+        return ESC_FRAME_VALID;
 
-    if (readBytes == 1) {
-        if (dataByte == 0x9B) {
-            syncCount++;
-        }
-        else if (dataByte == 0xB9) {
-            readBytes = 0;
+    return ESC_FRAME_INVALID;
+}
+
+static void hw4DecodeInfoFrame(void)
+{
+    // Wait for a few frames before trusting the scaling info
+    if (syncCount <= 3)
+        return;
+
+    if (escSensorConfig()->hw4_voltage_gain) {
+        hw4VoltageScale = HW4_VOLTAGE_SCALE * escSensorConfig()->hw4_voltage_gain;
+    }
+    else {
+        if (buffer[5] && buffer[6])
+            hw4VoltageScale = (float)buffer[5] / (float)buffer[6] / 10;
+        else
+            hw4VoltageScale = 0;
+    }
+
+    if (escSensorConfig()->hw4_current_gain) {
+        hw4CurrentScale = HW4_CURRENT_SCALE / escSensorConfig()->hw4_current_gain;
+        hw4CurrentOffset = escSensorConfig()->hw4_current_offset;
+    }
+    else {
+        if (buffer[7] && buffer[8]) {
+            hw4CurrentScale = (float)buffer[7] / (float)buffer[8];
+            hw4CurrentOffset = (float)buffer[9] / hw4CurrentScale;
         }
         else {
-            frameSyncError();
+            hw4CurrentScale = 0;
+            hw4CurrentOffset = 0;
         }
     }
-    else if (readBytes == 13) {
-        if (buffer[1] == 0x9B && buffer[4] == 0x01 && buffer[12] == 0xB9) {
-            readBytes = 0;
-            if (syncCount > 3)
-                return HW4_FRAME_INFO;
-        }
+}
+
+static void hw4DecodeFrame(uint8_t length, timeUs_t frameTimeUs)
+{
+    if (length == HW4_INFO_FRAME_LENGTH) {
+        hw4DecodeInfoFrame();
+        return;
     }
-    else if (readBytes == 19) {
-        readBytes = 0;
-        return HW4_FRAME_DATA;
+
+    //uint32_t cnt = buffer[1] << 16 | buffer[2] << 8 | buffer[3];
+    uint16_t thr = buffer[4] << 8 | buffer[5];
+    uint16_t pwm = buffer[6] << 8 | buffer[7];
+    uint32_t rpm = buffer[8] << 16 | buffer[9] << 8 | buffer[10];
+    uint16_t Vadc = buffer[11] << 8 | buffer[12];
+    uint16_t Iadc = buffer[13] << 8 | buffer[14];
+    uint16_t Tadc = buffer[15] << 8 | buffer[16];
+    uint16_t Cadc = buffer[17] << 8 | buffer[18];
+
+    float voltage = calcVoltHW(Vadc);
+    float current = calcCurrHW(Iadc);
+    float tempFET = calcTempHW(Tadc);
+    float tempCAP = calcTempHW(Cadc);
+
+    // When throttle changes to zero, the last current reading is
+    // repeated until the motor has totally stopped.
+    if (pwm == 0) {
+        current = 0;
     }
 
-    return HW4_FRAME_NONE;
+    setConsumptionCurrent(current);
+
+    escSensorData[0].age = 0;
+    rpmSampleUs[0] = frameTimeUs;
+    escSensorData[0].erpm = rpm;
+    escSensorData[0].throttle = thr;
+    escSensorData[0].pwm = pwm;
+    escSensorData[0].voltage = lrintf(voltage * 1000);
+    escSensorData[0].current = lrintf(current * 1000);
+    escSensorData[0].temperature = lrintf(tempFET * 10);
+    escSensorData[0].temperature2 = lrintf(tempCAP * 10);
+
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, lrintf(tempFET * 10));
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, lrintf(voltage * 100));
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, lrintf(current * 100));
+
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, pwm);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, Tadc);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, Vadc);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, Iadc);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, thr);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
 }
 
+static const escFrameSpec_t hw4FrameSpec = {
+    .sync = { 0x9B },
+    .syncLength = 1,
+    .syncFrames = 0,
+    .filler = 0xB9,
+    .lengths = { HW4_INFO_FRAME_LENGTH, HW4_DATA_FRAME_LENGTH },
+    .check = hw4FrameCheck,
+    .decode = hw4DecodeFrame,
+};
+
 static void hw4SensorProcess(timeUs_t currentTimeUs)
 {
-    // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        const uint8_t frameType = processHW4TelemetryStream(serialRead(escSensorPort));
-
-        if (frameType == HW4_FRAME_DATA) {
-            if (buffer[4] < 4 && buffer[6] < 4 && buffer[11] < 0x10 &&
-                buffer[13] < 0x10 && buffer[15] < 0x10 && buffer[17] < 0x10) {
-
-                //uint32_t cnt = buffer[1] << 16 | buffer[2] << 8 | buffer[3];
-                uint16_t thr = buffer[4] << 8 | buffer[5];
-                uint16_t pwm = buffer[6] << 8 | buffer[7];
-                uint32_t rpm = buffer[8] << 16 | buffer[9] << 8 | buffer[10];
-                uint16_t Vadc = buffer[11] << 8 | buffer[12];
-                uint16_t Iadc = buffer[13] << 8 | buffer[14];
-                uint16_t Tadc = buffer[15] << 8 | buffer[16];
-                uint16_t Cadc = buffer[17] << 8 | buffer[18];
-
-                float voltage = calcVoltHW(Vadc);
-                float current = calcCurrHW(Iadc);
-                float tempFET = calcTempHW(Tadc);
-                float tempCAP = calcTempHW(Cadc);
-
-                // When throttle changes to zero, the last current reading is
-                // repeated until the motor has totally stopped.
-                if (pwm == 0) {
-                    current = 0;
-                }
-
-                setConsumptionCurrent(current);
-
-                escSensorData[0].age = 0;
-                escSensorData[0].erpm = rpm;
-                escSensorData[0].throttle = thr;
-                escSensorData[0].pwm = pwm;
-                escSensorData[0].voltage = lrintf(voltage * 1000);
-                escSensorData[0].current = lrintf(current * 1000);
-                escSensorData[0].temperature = lrintf(tempFET * 10);
-                escSensorData[0].temperature2 = lrintf(tempCAP * 10);
-
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, lrintf(tempFET * 10));
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, lrintf(voltage * 100));
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, lrintf(current * 100));
-
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, pwm);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, Tadc);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, Vadc);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, Iadc);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, thr);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
-
-                dataUpdateUs = currentTimeUs;
-
-                totalFrameCount++;
-            }
-            else {
-                totalCrcErrorCount++;
-            }
-        }
-        else if (frameType == HW4_FRAME_INFO) {
-            if (escSensorConfig()->hw4_voltage_gain) {
-                hw4VoltageScale = HW4_VOLTAGE_SCALE * escSensorConfig()->hw4_voltage_gain;
-            }
-            else {
-                if (buffer[5] && buffer[6])
-                    hw4VoltageScale = (float)buffer[5] / (float)buffer[6] / 10;
-                else
-                    hw4VoltageScale = 0;
-            }
-
-            if (escSensorConfig()->hw4_current_gain) {
-                hw4CurrentScale = HW4_CURRENT_SCALE / escSensorConfig()->hw4_current_gain;
-                hw4CurrentOffset = escSensorConfig()->hw4_current_offset;
-            }
-            else {
-                if (buffer[7] && buffer[8]) {
-                    hw4CurrentScale = (float)buffer[7] / (float)buffer[8];
-                    hw4CurrentOffset = (float)buffer[9] / hw4CurrentScale;
-                }
-                else {
-                    hw4CurrentScale = 0;
-                    hw4CurrentOffset = 0;
-                }
-            }
-        }
-    }
+    escFrameProcess(&hw4FrameSpec, currentTimeUs);
 
     // Update consumption on every cycle
     updateConsumption(currentTimeUs);
@@ -794,122 +998,105 @@ static uint32_t kontronikDecodeCRC(uint8_t index)
     return buffer[index + 3] << 24 | buffer[index + 2] << 16 | buffer[index + 1] << 8 | buffer[index];
 }
 
-static bool processKontronikTelemetryStream(uint8_t dataByte)
+static escFrameStatus_e kontronikFrameCheck(uint8_t length)
 {
-    totalByteCount++;
-
-    buffer[readBytes++] = dataByte;
+    if (kontronikPacketLength == 0) {
+        // Auto detect the frame format...
+        const uint32_t crc = kontronikDecodeCRC(length - KON_CRC_LENGTH);
 
-    if (readBytes == 1) {
-        if (dataByte != 0x4B)
-            frameSyncError();
-    }
-    else if (readBytes == 2) {
-        if (dataByte != 0x4F)
-            frameSyncError();
-    }
-    else if (readBytes == 3) {
-        if (dataByte != 0x44)
-            frameSyncError();
-    }
-    else if (readBytes == 4) {
-        if (dataByte != 0x4C)
-            frameSyncError();
-        else
-            syncCount++;
-    }
-    else if (readBytes == kontronikPacketLength) {
-        readBytes = 0;
-        return true;
-    }
-    else if (kontronikPacketLength == 0 && readBytes == KON_FRAME_LENGTH_LEGACY) {
-        // auto detect legacy 38 byte packet...
-        uint32_t crc = kontronikDecodeCRC(KON_FRAME_LENGTH_LEGACY - KON_CRC_LENGTH);
-        if (calculateCRC32(buffer, KON_FRAME_LENGTH_LEGACY - 2 - KON_CRC_LENGTH) == crc) {
-            // ...w/ 32 byte payload (2 bytes excluded)
-            kontronikPacketLength = KON_FRAME_LENGTH_LEGACY;
-            kontronikCrcExclude = 2;
-            readBytes = 0;
-            return true;
-        }
-        else if (calculateCRC32(buffer, KON_FRAME_LENGTH_LEGACY - KON_CRC_LENGTH) == crc) {
-            // ...w/ 34 byte payload
-            kontronikPacketLength = KON_FRAME_LENGTH_LEGACY;
-            kontronikCrcExclude = 0;
-            readBytes = 0;
-            return true;
+        if (length == KON_FRAME_LENGTH_LEGACY) {
+            if (calculateCRC32(buffer, KON_FRAME_LENGTH_LEGACY - 2 - KON_CRC_LENGTH) == crc) {
+                // ...legacy 38 byte frame w/ 32 byte payload (2 bytes excluded)
+                kontronikPacketLength = KON_FRAME_LENGTH_LEGACY;
+                kontronikCrcExclude = 2;
+                return ESC_FRAME_VALID;
+            }
+            if (calculateCRC32(buffer, KON_FRAME_LENGTH_LEGACY - KON_CRC_LENGTH) == crc) {
+                // ...legacy 38 byte frame w/ 34 byte payload
+                kontronikPacketLength = KON_FRAME_LENGTH_LEGACY;
+                kontronikCrcExclude = 0;
+                return ESC_FRAME_VALID;
+            }
+            return ESC_FRAME_PENDING;
         }
-    }
-    else if (kontronikPacketLength == 0 && readBytes == KON_FRAME_LENGTH) {
-        // auto detect 40 byte packet...
-        uint32_t crc = kontronikDecodeCRC(KON_FRAME_LENGTH - KON_CRC_LENGTH);
+
         if (calculateCRC32(buffer, KON_FRAME_LENGTH - KON_CRC_LENGTH) == crc) {
-            // ...w/ 36 byte payload
+            // ...40 byte frame w/ 36 byte payload
             kontronikPacketLength = KON_FRAME_LENGTH;
             kontronikCrcExclude = 0;
+            return ESC_FRAME_VALID;
         }
-        readBytes = 0;
-        return true;
+        return ESC_FRAME_INVALID;
     }
 
-    return false;
+    if (length != kontronikPacketLength)
+        return ESC_FRAME_PENDING;
+
+    const uint32_t crc = kontronikDecodeCRC(kontronikPacketLength - KON_CRC_LENGTH);
+
+    if (calculateCRC32(buffer, kontronikPacketLength - kontronikCrcExclude - KON_CRC_LENGTH) == crc)
+        return ESC_FRAME_VALID;
+
+    return ESC_FRAME_INVALID;
+}
+
+static void kontronikDecodeFrame(uint8_t length, timeUs_t frameTimeUs)
+{
+    UNUSED(length);
+
+    uint32_t rpm = buffer[7] << 24 | buffer[6] << 16 | buffer[5] << 8 | buffer[4];
+    int16_t  throttle = (int8_t)buffer[24];
+    uint16_t pwm = buffer[23] << 8 | buffer[22];
+    uint16_t voltage = buffer[9] << 8 | buffer[8];
+    uint16_t current = buffer[11] << 8 | buffer[10];
+    uint16_t capacity = buffer[17] << 8 | buffer[16];
+    int16_t  tempFET = (int8_t)buffer[26];
+    int16_t  tempBEC = (int8_t)buffer[27];
+    uint16_t currBEC = buffer[19] << 8 | buffer[18];
+    uint16_t voltBEC = buffer[21] << 8 | buffer[20];
+    uint32_t status = buffer[31] << 24 | buffer[30] << 16 | buffer[29] << 8 | buffer[28];
+
+    escSensorData[0].age = 0;
+    rpmSampleUs[0] = frameTimeUs;
+    escSensorData[0].erpm = rpm;
+    escSensorData[0].throttle = (throttle + 100) * 5;
+    escSensorData[0].pwm = pwm * 10;
+    escSensorData[0].voltage = voltage * 10;
+    escSensorData[0].current = current * 100;
+    escSensorData[0].consumption = capacity;
+    escSensorData[0].temperature = tempFET * 10;
+    escSensorData[0].temperature2 = tempBEC * 10;
+    escSensorData[0].bec_voltage = voltBEC;
+    escSensorData[0].bec_current = currBEC;
+    escSensorData[0].status = status;
+
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, tempFET * 10);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, voltage);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, current * 10);
+
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, pwm);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, tempFET);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, voltage);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, current);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CAPACITY, capacity);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, tempBEC);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
 }
 
+static const escFrameSpec_t kontronikFrameSpec = {
+    .sync = { 0x4B, 0x4F, 0x44, 0x4C },
+    .syncLength = 4,
+    .syncFrames = 0,
+    .lengths = { KON_FRAME_LENGTH_LEGACY, KON_FRAME_LENGTH },
+    .check = kontronikFrameCheck,
+    .decode = kontronikDecodeFrame,
+};
+
 static void kontronikSensorProcess(timeUs_t currentTimeUs)
 {
-    // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        if (processKontronikTelemetryStream(serialRead(escSensorPort))) {
-            uint32_t crc = kontronikDecodeCRC(kontronikPacketLength - KON_CRC_LENGTH);
-            if (calculateCRC32(buffer, kontronikPacketLength - kontronikCrcExclude - KON_CRC_LENGTH) == crc) {
-                uint32_t rpm = buffer[7] << 24 | buffer[6] << 16 | buffer[5] << 8 | buffer[4];
-                int16_t  throttle = (int8_t)buffer[24];
-                uint16_t pwm = buffer[23] << 8 | buffer[22];
-                uint16_t voltage = buffer[9] << 8 | buffer[8];
-                uint16_t current = buffer[11] << 8 | buffer[10];
-                uint16_t capacity = buffer[17] << 8 | buffer[16];
-                int16_t  tempFET = (int8_t)buffer[26];
-                int16_t  tempBEC = (int8_t)buffer[27];
-                uint16_t currBEC = buffer[19] << 8 | buffer[18];
-                uint16_t voltBEC = buffer[21] << 8 | buffer[20];
-                uint32_t status = buffer[31] << 24 | buffer[30] << 16 | buffer[29] << 8 | buffer[28];
-
-                escSensorData[0].age = 0;
-                escSensorData[0].erpm = rpm;
-                escSensorData[0].throttle = (throttle + 100) * 5;
-                escSensorData[0].pwm = pwm * 10;
-                escSensorData[0].voltage = voltage * 10;
-                escSensorData[0].current = current * 100;
-                escSensorData[0].consumption = capacity;
-                escSensorData[0].temperature = tempFET * 10;
-                escSensorData[0].temperature2 = tempBEC * 10;
-                escSensorData[0].bec_voltage = voltBEC;
-                escSensorData[0].bec_current = currBEC;
-                escSensorData[0].status = status;
-
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, tempFET * 10);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, voltage);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, current * 10);
-
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, pwm);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, tempFET);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, voltage);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, current);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CAPACITY, capacity);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, tempBEC);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
-
-                dataUpdateUs = currentTimeUs;
-
-                totalFrameCount++;
-            }
-            else {
-                totalCrcErrorCount++;
-            }
-        }
-    }
+    escFrameProcess(&kontronikFrameSpec, currentTimeUs);
 
     checkFrameTimeout(currentTimeUs, 500000);
 }
@@ -952,76 +1139,68 @@ static void kontronikSensorProcess(timeUs_t currentTimeUs)
  *
  */
 
-static bool processOMPTelemetryStream(uint8_t dataByte)
+static escFrameStatus_e ompFrameCheck(uint8_t length)
 {
-    totalByteCount++;
+    UNUSED(length);
 
-    buffer[readBytes++] = dataByte;
+    // Make sure this is OMP M4 ESC
+    if (buffer[1] == 0x01 && buffer[2] == 0x20 && buffer[11] == 0 && buffer[18] == 0 && buffer[20] == 0)
+        return ESC_FRAME_VALID;
 
-    if (readBytes == 1) {
-        if (dataByte != 0xDD)
-            frameSyncError();
-        else
-            syncCount++;
-    }
-    else if (readBytes == 32) {
-        readBytes = 0;
-        if (syncCount > 2)
-            return true;
-    }
+    return ESC_FRAME_INVALID;
+}
 
-    return false;
+static void ompDecodeFrame(uint8_t length, timeUs_t frameTimeUs)
+{
+    UNUSED(length);
+
+    uint16_t rpm = buffer[8] << 8 | buffer[9];
+    uint16_t throttle = buffer[7];
+    uint16_t pwm = buffer[12];
+    uint16_t temp = buffer[10];
+    uint16_t voltage = buffer[3] << 8 | buffer[4];
+    uint16_t current = buffer[5] << 8 | buffer[6];
+    uint16_t capacity = buffer[15] << 8 | buffer[16];
+    uint16_t status = buffer[13] << 8 | buffer[14];
+
+    escSensorData[0].age = 0;
+    rpmSampleUs[0] = frameTimeUs;
+    escSensorData[0].erpm = rpm * 10;
+    escSensorData[0].throttle = throttle * 10;
+    escSensorData[0].pwm = pwm * 10;
+    escSensorData[0].voltage = voltage * 100;
+    escSensorData[0].current = current * 100;
+    escSensorData[0].consumption = capacity;
+    escSensorData[0].temperature = temp * 10;
+    escSensorData[0].status = status;
+
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm * 10);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, temp * 10);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, voltage * 10);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, current * 10);
+
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, pwm);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, temp);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, voltage);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, current);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CAPACITY, capacity);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, status);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
 }
 
+static const escFrameSpec_t ompFrameSpec = {
+    .sync = { 0xDD },
+    .syncLength = 1,
+    .syncFrames = 2,
+    .lengths = { 32 },
+    .check = ompFrameCheck,
+    .decode = ompDecodeFrame,
+};
+
 static void ompSensorProcess(timeUs_t currentTimeUs)
 {
-    // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        if (processOMPTelemetryStream(serialRead(escSensorPort))) {
-            // Make sure this is OMP M4 ESC
-            if (buffer[1] == 0x01 && buffer[2] == 0x20 && buffer[11] == 0 && buffer[18] == 0 && buffer[20] == 0) {
-                uint16_t rpm = buffer[8] << 8 | buffer[9];
-                uint16_t throttle = buffer[7];
-                uint16_t pwm = buffer[12];
-                uint16_t temp = buffer[10];
-                uint16_t voltage = buffer[3] << 8 | buffer[4];
-                uint16_t current = buffer[5] << 8 | buffer[6];
-                uint16_t capacity = buffer[15] << 8 | buffer[16];
-                uint16_t status = buffer[13] << 8 | buffer[14];
-
-                escSensorData[0].age = 0;
-                escSensorData[0].erpm = rpm * 10;
-                escSensorData[0].throttle = throttle * 10;
-                escSensorData[0].pwm = pwm * 10;
-                escSensorData[0].voltage = voltage * 100;
-                escSensorData[0].current = current * 100;
-                escSensorData[0].consumption = capacity;
-                escSensorData[0].temperature = temp * 10;
-                escSensorData[0].status = status;
-
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm * 10);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, temp * 10);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, voltage * 10);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, current * 10);
-
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, pwm);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, temp);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, voltage);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, current);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CAPACITY, capacity);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, status);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
-
-                dataUpdateUs = currentTimeUs;
-
-                totalFrameCount++;
-            }
-            else {
-                totalCrcErrorCount++;
-            }
-        }
-    }
+    escFrameProcess(&ompFrameSpec, currentTimeUs);
 
     // Maximum frame spacing 50ms, sync after 3 frames
     checkFrameTimeout(currentTimeUs, 500000);
@@ -1073,77 +1252,69 @@ static void ompSensorProcess(timeUs_t currentTimeUs)
  *
  */
 
-static bool processZTWTelemetryStream(uint8_t dataByte)
+static escFrameStatus_e ztwFrameCheck(uint8_t length)
 {
-    totalByteCount++;
+    UNUSED(length);
 
-    buffer[readBytes++] = dataByte;
+    if (buffer[1] == 0x01 && buffer[2] == 0x20)
+        return ESC_FRAME_VALID;
 
-    if (readBytes == 1) {
-        if (dataByte != 0xDD)
-            frameSyncError();
-        else
-            syncCount++;
-    }
-    else if (readBytes == 32) {
-        readBytes = 0;
-        if (syncCount > 2)
-            return true;
-    }
+    return ESC_FRAME_INVALID;
+}
 
-    return false;
+static void ztwDecodeFrame(uint8_t length, timeUs_t frameTimeUs)
+{
+    UNUSED(length);
+
+    uint16_t rpm = buffer[8] << 8 | buffer[9];
+    uint16_t temp = buffer[10];
+    uint16_t throttle = buffer[7];
+    uint16_t power = buffer[12];
+    uint16_t voltage = buffer[3] << 8 | buffer[4];
+    uint16_t current = buffer[5] << 8 | buffer[6];
+    uint16_t capacity = buffer[15] << 8 | buffer[16];
+    uint16_t status = buffer[13] << 8 | buffer[14];
+    uint16_t voltBEC = buffer[19];
+
+    escSensorData[0].age = 0;
+    rpmSampleUs[0] = frameTimeUs;
+    escSensorData[0].erpm = rpm * 10;
+    escSensorData[0].throttle = throttle * 10;
+    escSensorData[0].pwm = power * 10;
+    escSensorData[0].voltage = voltage * 100;
+    escSensorData[0].current = current * 100;
+    escSensorData[0].consumption = capacity;
+    escSensorData[0].temperature = temp * 10;
+    escSensorData[0].bec_voltage = voltBEC * 1000;
+    escSensorData[0].status = status;
+
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm * 10);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, temp * 10);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, voltage * 10);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, current * 10);
+
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, power);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, temp);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, voltage);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, current);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CAPACITY, capacity);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, status);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
 }
 
+static const escFrameSpec_t ztwFrameSpec = {
+    .sync = { 0xDD },
+    .syncLength = 1,
+    .syncFrames = 2,
+    .lengths = { 32 },
+    .check = ztwFrameCheck,
+    .decode = ztwDecodeFrame,
+};
+
 static void ztwSensorProcess(timeUs_t currentTimeUs)
 {
-    // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        if (processZTWTelemetryStream(serialRead(escSensorPort))) {
-            if (buffer[1] == 0x01 && buffer[2] == 0x20) {
-                uint16_t rpm = buffer[8] << 8 | buffer[9];
-                uint16_t temp = buffer[10];
-                uint16_t throttle = buffer[7];
-                uint16_t power = buffer[12];
-                uint16_t voltage = buffer[3] << 8 | buffer[4];
-                uint16_t current = buffer[5] << 8 | buffer[6];
-                uint16_t capacity = buffer[15] << 8 | buffer[16];
-                uint16_t status = buffer[13] << 8 | buffer[14];
-                uint16_t voltBEC = buffer[19];
-
-                escSensorData[0].age = 0;
-                escSensorData[0].erpm = rpm * 10;
-                escSensorData[0].throttle = throttle * 10;
-                escSensorData[0].pwm = power * 10;
-                escSensorData[0].voltage = voltage * 100;
-                escSensorData[0].current = current * 100;
-                escSensorData[0].consumption = capacity;
-                escSensorData[0].temperature = temp * 10;
-                escSensorData[0].bec_voltage = voltBEC * 1000;
-                escSensorData[0].status = status;
-
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm * 10);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, temp * 10);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, voltage * 10);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, current * 10);
-
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, power);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, temp);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, voltage);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, current);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CAPACITY, capacity);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, status);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
-
-                dataUpdateUs = currentTimeUs;
-
-                totalFrameCount++;
-            }
-            else {
-                totalCrcErrorCount++;
-            }
-        }
-    }
+    escFrameProcess(&ztwFrameSpec, currentTimeUs);
 
     // Maximum frame spacing 50ms, sync after 3 frames
     checkFrameTimeout(currentTimeUs, 500000);
@@ -1210,82 +1381,70 @@ static uint16_t calculateFletcher16(const uint8_t *ptr, size_t len)
     return s1 << 8 | s0;
 }
 
-static bool processAPDTelemetryStream(uint8_t dataByte)
+static escFrameStatus_e apdFrameCheck(uint8_t length)
 {
-    totalByteCount++;
+    UNUSED(length);
 
-    buffer[readBytes++] = dataByte;
+    const uint16_t crc = buffer[21] << 8 | buffer[20];
 
-    if (readBytes == 1) {
-        if (dataByte != 0xFF)
-            frameSyncError();
-    }
-    else if (readBytes == 2) {
-        if (dataByte != 0xFF)
-            frameSyncError();
-        else
-            syncCount++;
-    }
-    else if (readBytes == 22) {
-        readBytes = 0;
-        if (syncCount > 2)
-            return true;
-    }
+    if (calculateFletcher16(buffer + 2, 18) == crc)
+        return ESC_FRAME_VALID;
 
-    return false;
+    return ESC_FRAME_INVALID;
 }
 
+static void apdDecodeFrame(uint8_t length, timeUs_t frameTimeUs)
+{
+    UNUSED(length);
+
+    uint16_t rpm = buffer[13] << 24 | buffer[12] << 16 | buffer[11] << 8 | buffer[10];
+    uint16_t tadc = buffer[3] << 8 | buffer[2];
+    uint16_t throttle = buffer[15] << 8 | buffer[14];
+    uint16_t power = buffer[17] << 8 | buffer[16];
+    uint16_t voltage = buffer[1] << 8 | buffer[0];
+    uint16_t current = buffer[5] << 8 | buffer[4];
+    uint16_t status = buffer[18];
+
+    float temp = calcTempAPD(tadc);
+
+    setConsumptionCurrent(current * 0.08f);
+
+    escSensorData[0].age = 0;
+    rpmSampleUs[0] = frameTimeUs;
+    escSensorData[0].erpm = rpm;
+    escSensorData[0].throttle = throttle;
+    escSensorData[0].pwm = power;
+    escSensorData[0].voltage = voltage * 10;
+    escSensorData[0].current = current * 80;
+    escSensorData[0].temperature = lrintf(temp * 10);
+    escSensorData[0].status = status;
+
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, lrintf(temp * 10));
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, voltage);
+    DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, current * 8);
+
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, power);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, tadc);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, voltage);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, current);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, status);
+    DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
+}
+
+static const escFrameSpec_t apdFrameSpec = {
+    .sync = { 0xFF, 0xFF },
+    .syncLength = 2,
+    .syncFrames = 2,
+    .lengths = { 22 },
+    .check = apdFrameCheck,
+    .decode = apdDecodeFrame,
+};
+
 static void apdSensorProcess(timeUs_t currentTimeUs)
 {
-    // check for any available bytes in the rx buffer
-    while (serialRxBytesWaiting(escSensorPort)) {
-        if (processAPDTelemetryStream(serialRead(escSensorPort))) {
-            uint16_t crc = buffer[21] << 8 | buffer[20];
-
-            if (calculateFletcher16(buffer + 2, 18) == crc) {
-                uint16_t rpm = buffer[13] << 24 | buffer[12] << 16 | buffer[11] << 8 | buffer[10];
-                uint16_t tadc = buffer[3] << 8 | buffer[2];
-                uint16_t throttle = buffer[15] << 8 | buffer[14];
-                uint16_t power = buffer[17] << 8 | buffer[16];
-                uint16_t voltage = buffer[1] << 8 | buffer[0];
-                uint16_t current = buffer[5] << 8 | buffer[4];
-                uint16_t status = buffer[18];
-
-                float temp = calcTempAPD(tadc);
-
-                setConsumptionCurrent(current * 0.08f);
-
-                escSensorData[0].age = 0;
-                escSensorData[0].erpm = rpm;
-                escSensorData[0].throttle = throttle;
-                escSensorData[0].pwm = power;
-                escSensorData[0].voltage = voltage * 10;
-                escSensorData[0].current = current * 80;
-                escSensorData[0].temperature = lrintf(temp * 10);
-                escSensorData[0].status = status;
-
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_RPM, rpm);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_TEMP, lrintf(temp * 10));
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_VOLTAGE, voltage);
-                DEBUG(ESC_SENSOR, DEBUG_ESC_1_CURRENT, current * 8);
-
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_RPM, rpm);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_PWM, power);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_TEMP, tadc);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_VOLTAGE, voltage);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_CURRENT, current);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_EXTRA, status);
-                DEBUG(ESC_SENSOR_DATA, DEBUG_DATA_AGE, 0);
-
-                dataUpdateUs = currentTimeUs;
-
-                totalFrameCount++;
-            }
-            else {
-                totalCrcErrorCount++;
-            }
-        }
-    }
+    escFrameProcess(&apdFrameSpec, currentTimeUs);
 
     // Update consumption on every cycle
     updateConsumption(currentTimeUs);
@@ -1631,6 +1790,7 @@ static bool pl5DecodeTeleFrame(timeUs_t currentTimeUs)
     setConsumptionCurrent(current * 0.1f);
 
     escSensorData[0].age = 0;
+    rpmSampleUs[0] = escSensorFrameTime();
     escSensorData[0].erpm = tele->rpm * 10;
     escSensorData[0].throttle = tele->throttle * 10;
     escSensorData[0].pwm = tele->throttle * 10;
@@ -2151,6 +2311,7 @@ static bool tribDecodeLogRecord(uint8_t hl)
     const uint16_t voltBEC = buffer[hl + 12];
 
     escSensorData[0].age = 0;
+    rpmSampleUs[0] = escSensorFrameTime();
     escSensorData[0].erpm = rpm * 5;
     escSensorData[0].pwm = power * 5;
     escSensorData[0].voltage = voltage * 100;
@@ -2575,6 +2736,7 @@ static void oygeDecodeTelemetryFrame(void)
     int16_t tempBEC = tele->bec_temp - OPENYGE_TEMP_OFFSET;
 
     escSensorData[0].age = 0;
+    rpmSampleUs[0] = escSensorFrameTime();
     escSensorData[0].erpm = tele->rpm * 10;
     escSensorData[0].pwm = tele->pwm * 10;
     escSensorData[0].throttle = tele->throttle * 10;
@@ -2803,6 +2965,7 @@ void escSensorProcess(timeUs_t currentTimeUs)
         DEBUG(ESC_SENSOR_FRAME, DEBUG_FRAME_CRC_ERRORS, totalCrcErrorCount);
         DEBUG(ESC_SENSOR_FRAME, DEBUG_FRAME_TIMEOUTS, totalTimeoutCount);
         DEBUG(ESC_SENSOR_FRAME, DEBUG_FRAME_BUFFER, readBytes);
+        DEBUG(ESC_SENSOR_FRAME, DEBUG_FRAME_OVERRUNS, totalOverrunCount);
     }
 }
 
@@ -2820,6 +2983,10 @@ bool INIT_CODE escSensorInit(void)
 
     options = SERIAL_STOPBITS_1 | SERIAL_PARITY_NO | SERIAL_NOT_INVERTED | (escHalfDuplex ? SERIAL_BIDIR : 0);
 
+    // Start looking for the first frame
+    readBytes = 0;
+    syncCount = 0;
+
     switch (escSensorConfig()->protocol) {
         case ESC_SENSOR_PROTO_BLHELI32:
             callback = blDataReceive;
@@ -2833,6 +3000,7 @@ bool INIT_CODE escSensorInit(void)
             baudrate = 38400;
             break;
         case ESC_SENSOR_PROTO_KONTRONIK:
+            kontronikPacketLength = 0;
             baudrate = 115200;
             options |= SERIAL_PARITY_EVEN;
             break;
@@ -2858,6 +3026,12 @@ bool INIT_CODE escSensorInit(void)
         escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, callback, NULL, baudrate, escHalfDuplex ? MODE_RXTX : MODE_RX, options);
     }
 
+    // Use DMA/idle line frame reception where the port supports it
+    if (escSensorPort && escSensorConfig()->protocol != ESC_SENSOR_PROTO_RECORD) {
+        escRxByteCallback = callback;
+        escRxFrameMode = serialSetFrameCallback(escSensorPort, escSensorFrameReceive);
+    }
+
     for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
         escSensorData[i].age = ESC_DATA_INVALID;
     }
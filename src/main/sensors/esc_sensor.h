@@ -82,6 +82,7 @@ void escSensorProcess(timeUs_t currentTime);
 bool isEscSensorActive(void);
 
 uint32_t getEscSensorRPM(uint8_t motorNumber);
+timeUs_t getEscSensorRPMTimestamp(uint8_t motorNumber);
 escSensorData_t *getEscSensorData(uint8_t motorNumber);
 
 uint8_t escGetParamBufferLength(void);
@@ -88,7 +88,7 @@ STATIC_UNIT_TESTED gyroDev_t * const gyroDevPtr = &gyro.gyroSensor1.gyroDev;
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_FN(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 9);
+PG_REGISTER_WITH_RESET_FN(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 10);
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
@@ -115,6 +115,7 @@ void pgResetFn_gyroConfig(gyroConfig_t *gyroConfig)
     gyroConfig->gyro_soft_notch_cutoff_2 = 0;
     gyroConfig->checkOverflow = GYRO_OVERFLOW_CHECK_ALL_AXES;
     gyroConfig->gyro_offset_yaw = 0;
+    gyroConfig->gyro_fifo_frames = 0;
 }
 
 static inline bool isGyroSensorCalibrationComplete(const gyroSensor_t *gyroSensor)
@@ -147,7 +148,7 @@ static bool isOnFinalGyroCalibrationCycle(const gyroCalibration_t *gyroCalibrati
 
 static int32_t gyroCalculateCalibratingCycles(void)
 {
-    return (gyroConfig()->gyroCalibrationDuration * 10000) / gyro.sampleLooptime;
+    return (gyroConfig()->gyroCalibrationDuration * 10000) / gyro.sampleLooptime * gyro.samplesPerCycle;
 }
 
 static bool isOnFirstGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration)
@@ -312,13 +313,8 @@ static FAST_CODE void checkForOverflow(timeUs_t currentTimeUs)
 }
 #endif // USE_GYRO_OVERFLOW_CHECK
 
-static FAST_CODE void gyroUpdateSensor(gyroSensor_t *gyroSensor)
+static FAST_CODE void gyroProcessSensor(gyroSensor_t *gyroSensor)
 {
-    if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
-        return;
-    }
-    gyroSensor->gyroDev.dataReady = false;
-
     if (isGyroSensorCalibrationComplete(gyroSensor)) {
         // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
 
@@ -342,8 +338,86 @@ static FAST_CODE void gyroUpdateSensor(gyroSensor_t *gyroSensor)
     }
 }
 
+static FAST_CODE void gyroUpdateSensor(gyroSensor_t *gyroSensor)
+{
+    if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
+        return;
+    }
+    gyroSensor->gyroDev.dataReady = false;
+
+    gyroProcessSensor(gyroSensor);
+}
+
+#ifdef USE_GYRO_FIFO
+static FAST_CODE_NOINLINE void gyroFifoDebug(const gyroDev_t *gyroDev)
+{
+    static uint16_t lastTimestamp;
+    static uint32_t droppedSamples;
+
+    // Nominal sample period at the native sensor rate
+    const unsigned samplePeriod = gyro.sampleLooptime / gyro.samplesPerCycle;
+    unsigned maxInterval = 0;
+    unsigned interval = 0;
+
+    for (unsigned i = 0; i < gyroDev->fifoCount; i++) {
+        interval = (uint16_t)(gyroDev->fifoTimestamp[i] - lastTimestamp);
+        lastTimestamp = gyroDev->fifoTimestamp[i];
+        if (interval > samplePeriod + samplePeriod / 2) {
+            droppedSamples += (interval + samplePeriod / 2) / samplePeriod - 1;
+        }
+        maxInterval = MAX(maxInterval, interval);
+    }
+
+    DEBUG_SET(DEBUG_GYRO_FIFO, 0, gyroDev->fifoCount);
+    DEBUG_SET(DEBUG_GYRO_FIFO, 1, interval);
+    DEBUG_SET(DEBUG_GYRO_FIFO, 2, maxInterval);
+    DEBUG_SET(DEBUG_GYRO_FIFO, 3, droppedSamples);
+}
+
+static FAST_CODE void gyroUpdateFifo(gyroSensor_t *gyroSensor)
+{
+    gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+
+    if (!gyroDev->readFn(gyroDev)) {
+        return;
+    }
+    gyroDev->dataReady = false;
+
+    // Every sample of the burst goes through calibration and the decimator
+    for (unsigned i = 0; i < gyroDev->fifoCount; i++) {
+        gyroDev->gyroADCRaw[X] = gyroDev->fifoGyroRaw[i][X];
+        gyroDev->gyroADCRaw[Y] = gyroDev->fifoGyroRaw[i][Y];
+        gyroDev->gyroADCRaw[Z] = gyroDev->fifoGyroRaw[i][Z];
+
+        gyroProcessSensor(gyroSensor);
+
+        if (isGyroSensorCalibrationComplete(gyroSensor)) {
+            gyro.gyroADC[X] = gyroDev->gyroADC[X] * gyroDev->scale;
+            gyro.gyroADC[Y] = gyroDev->gyroADC[Y] * gyroDev->scale;
+            gyro.gyroADC[Z] = gyroDev->gyroADC[Z] * gyroDev->scale;
+        }
+
+        gyro.gyroADCd[X] = filterStackApply(gyro.decimator[X], gyro.gyroADC[X], 2);
+        gyro.gyroADCd[Y] = filterStackApply(gyro.decimator[Y], gyro.gyroADC[Y], 2);
+        gyro.gyroADCd[Z] = filterStackApply(gyro.decimator[Z], gyro.gyroADC[Z], 2);
+    }
+
+    if (debugMode == DEBUG_GYRO_FIFO) {
+        gyroFifoDebug(gyroDev);
+    }
+}
+#endif
+
 FAST_CODE void gyroUpdate(void)
 {
+#ifdef USE_GYRO_FIFO
+    // A single frame burst still only fills the FIFO sample buffer
+    if (gyro.rawSensorDev && gyro.rawSensorDev->fifoFrames) {
+        gyroUpdateFifo(container_of(gyro.rawSensorDev, gyroSensor_t, gyroDev));
+        return;
+    }
+#endif
+
     switch (gyro.gyroToUse) {
     case GYRO_CONFIG_USE_GYRO_1:
         gyroUpdateSensor(&gyro.gyroSensor1);
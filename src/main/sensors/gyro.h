@@ -105,6 +105,7 @@ typedef struct gyro_s {
     filter_t notchFilter2[XYZ_AXIS_COUNT];
 
     uint16_t accSampleRateHz;
+    uint8_t samplesPerCycle;           // sensor samples handled per gyro cycle (FIFO burst size)
     uint8_t gyroToUse;
     uint8_t gyroDebugMode;
 
@@ -168,6 +169,8 @@ typedef struct gyroConfig_s {
 
     uint8_t gyrosDetected; // What gyros should detection be attempted for on startup. Automatically set on first startup.
 
+    uint8_t gyro_fifo_frames;           // Samples per FIFO burst, 0 = read the data registers without the FIFO
+
 } gyroConfig_t;
 
 PG_DECLARE(gyroConfig_t, gyroConfig);
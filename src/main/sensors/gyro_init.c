@@ -79,6 +79,9 @@
 // gyro types are supported with SPI DMA.
 #define GYRO_BUF_SIZE 32
 
+// FIFO burst buffer, sized for the largest frame (16 bytes on ICM-426xx) plus the count/length header
+#define GYRO_FIFO_BUF_SIZE (4 + GYRO_FIFO_MAX_FRAMES * 16)
+
 static gyroDetectionFlags_t gyroDetectionFlags = GYRO_NONE_MASK;
 
 static float calculateNyquistAdjustedNotchHz(float notchHz, float notchCutoffHz)
@@ -137,9 +140,10 @@ void gyroInitFilters(void)
     }
 #endif
 
+    // The decimator sees every sensor sample, including all samples of a FIFO burst
     gyroInitDecimationFilter(
         gyroConfig()->gyro_decimation_hz,
-        gyro.sampleRateHz
+        gyro.sampleRateHz * gyro.samplesPerCycle
     );
 
     gyroInitLowpassFilter(
@@ -201,6 +205,12 @@ void gyroInitSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t *config)
     buildRotationMatrixFromAlignment(&config->customAlignment, &gyroSensor->gyroDev.rotationMatrix);
     gyroSensor->gyroDev.mpuIntExtiTag = config->extiTag;
     gyroSensor->gyroDev.hardware_lpf = gyroConfig()->gyro_hardware_lpf;
+#ifdef USE_GYRO_FIFO
+    // FIFO bursts are only used with a single gyro
+    if (gyro.gyroToUse != GYRO_CONFIG_USE_GYRO_BOTH) {
+        gyroSensor->gyroDev.fifoFrames = MIN(gyroConfig()->gyro_fifo_frames, GYRO_FIFO_MAX_FRAMES);
+    }
+#endif
 
     gyroSetSampleRate(&gyroSensor->gyroDev);
     gyroSensor->gyroDev.initFn(&gyroSensor->gyroDev);
@@ -547,6 +557,10 @@ bool gyroInit(void)
         // SPI DMA buffer required per device
         gyro.gyroSensor2.gyroDev.dev.txBuf = gyroBuf2;
         gyro.gyroSensor2.gyroDev.dev.rxBuf = &gyroBuf2[GYRO_BUF_SIZE / 2];
+#ifdef USE_GYRO_FIFO
+        static DMA_DATA uint8_t gyroFifoBuf2[GYRO_FIFO_BUF_SIZE];
+        gyro.gyroSensor2.gyroDev.fifoBuf = gyroFifoBuf2;
+#endif
 
         gyroInitSensor(&gyro.gyroSensor2, gyroDeviceConfig(1));
         gyro.gyroHasOverflowProtection =  gyro.gyroHasOverflowProtection && gyro.gyroSensor2.gyroDev.gyroHasOverflowProtection;
@@ -563,6 +577,10 @@ bool gyroInit(void)
         // SPI DMA buffer required per device
         gyro.gyroSensor1.gyroDev.dev.txBuf = gyroBuf1;
         gyro.gyroSensor1.gyroDev.dev.rxBuf = &gyroBuf1[GYRO_BUF_SIZE / 2];
+#ifdef USE_GYRO_FIFO
+        static DMA_DATA uint8_t gyroFifoBuf1[GYRO_FIFO_BUF_SIZE];
+        gyro.gyroSensor1.gyroDev.fifoBuf = gyroFifoBuf1;
+#endif
         gyroInitSensor(&gyro.gyroSensor1, gyroDeviceConfig(0));
         gyro.gyroHasOverflowProtection =  gyro.gyroHasOverflowProtection && gyro.gyroSensor1.gyroDev.gyroHasOverflowProtection;
         detectedSensors[SENSOR_INDEX_GYRO] = gyro.gyroSensor1.gyroDev.gyroHardware;
@@ -584,9 +602,15 @@ bool gyroInit(void)
     if (gyro.rawSensorDev) {
         gyro.sampleRateHz = gyro.rawSensorDev->gyroSampleRateHz;
         gyro.accSampleRateHz = gyro.rawSensorDev->accSampleRateHz;
+#ifdef USE_GYRO_FIFO
+        gyro.samplesPerCycle = MAX(gyro.rawSensorDev->fifoFrames, 1);
+#else
+        gyro.samplesPerCycle = 1;
+#endif
     } else {
         gyro.sampleRateHz = 0;
         gyro.accSampleRateHz = 0;
+        gyro.samplesPerCycle = 1;
     }
 
     return true;
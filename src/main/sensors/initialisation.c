@@ -24,11 +24,16 @@
 
 #include "platform.h"
 
+#include "build/version.h"
+
+#include "common/crc.h"
 #include "common/utils.h"
 
 #include "config/config.h"
 #include "config/feature.h"
 
+#include "drivers/persistent.h"
+
 #include "fc/runtime_config.h"
 
 #include "flight/pid.h"
@@ -50,6 +55,66 @@
 uint8_t requestedSensors[SENSOR_INDEX_COUNT] = { GYRO_NONE, ACC_NONE, BARO_NONE, MAG_NONE, RANGEFINDER_NONE };
 uint8_t detectedSensors[SENSOR_INDEX_COUNT] = { GYRO_NONE, ACC_NONE, BARO_NONE, MAG_NONE, RANGEFINDER_NONE };
 
+static uint32_t sensorsSkipped = 0;
+
+uint32_t sensorsProbeSkipped(void)
+{
+    return sensorsSkipped;
+}
+
+#ifdef USE_PERSISTENT_OBJECTS
+
+/*
+ * Optional sensors that were not found on the previous boot are not
+ * probed again after a software reset. The hint is tagged with the
+ * firmware build, so a new firmware always probes everything, and
+ * the backup registers are cleared on power-on.
+ */
+
+#define SENSOR_PROBE_HINT_MASK      (SENSOR_BARO | SENSOR_MAG)
+
+static uint32_t sensorProbeTag(void)
+{
+    uint32_t hash = 0x811c9dc5;
+
+    hash = fnv_update(hash, buildDate, strlen(buildDate));
+    hash = fnv_update(hash, buildTime, strlen(buildTime));
+    hash = fnv_update(hash, shortGitRevision, strlen(shortGitRevision));
+
+    return hash & 0xffff0000;
+}
+
+static uint32_t sensorProbeHint(void)
+{
+    const uint32_t hint = persistentObjectRead(PERSISTENT_OBJECT_SENSOR_PROBE);
+
+    if ((hint & 0xffff0000) == sensorProbeTag()) {
+        return hint & SENSOR_PROBE_HINT_MASK;
+    }
+
+    return 0;
+}
+
+static void sensorProbeHintUpdate(void)
+{
+    const uint32_t missing = ~sensorsMask() & SENSOR_PROBE_HINT_MASK;
+
+    persistentObjectWrite(PERSISTENT_OBJECT_SENSOR_PROBE, sensorProbeTag() | missing);
+}
+
+#else
+
+static uint32_t sensorProbeHint(void)
+{
+    return 0;
+}
+
+static void sensorProbeHintUpdate(void)
+{
+}
+
+#endif
+
 void sensorsPreInit(void)
 {
     gyroPreInit();
@@ -65,6 +130,9 @@ void sensorsPreInit(void)
 
 bool sensorsAutodetect(void)
 {
+    const uint32_t missing = sensorProbeHint();
+
+    UNUSED(missing);
 
     // gyro must be initialised before accelerometer
 
@@ -77,11 +145,19 @@ bool sensorsAutodetect(void)
 #endif
 
 #ifdef USE_MAG
-    compassInit();
+    if ((missing & SENSOR_MAG) && compassConfig()->mag_hardware == MAG_DEFAULT) {
+        sensorsSkipped |= SENSOR_MAG;
+    } else {
+        compassInit();
+    }
 #endif
 
 #ifdef USE_BARO
-    baroDetect(&baro.dev, barometerConfig()->baro_hardware);
+    if ((missing & SENSOR_BARO) && barometerConfig()->baro_hardware == BARO_DEFAULT) {
+        sensorsSkipped |= SENSOR_BARO;
+    } else {
+        baroDetect(&baro.dev, barometerConfig()->baro_hardware);
+    }
 #endif
 
 #ifdef USE_RANGEFINDER
@@ -92,5 +168,7 @@ bool sensorsAutodetect(void)
     adcInternalInit();
 #endif
 
+    sensorProbeHintUpdate();
+
     return gyroDetected;
 }
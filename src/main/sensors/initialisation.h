@@ -22,3 +22,4 @@
 
 void sensorsPreInit(void);
 bool sensorsAutodetect(void);
+uint32_t sensorsProbeSkipped(void);
@@ -134,6 +134,21 @@ void voltageSensorADCRefresh(void)
 #endif
 }
 
+// Fresh (unfiltered) conversion of the latest averaged ADC value in mV
+uint32_t voltageSensorADCSample(voltageSensorADC_e sensor)
+{
+#ifdef USE_ADC
+    if (voltageADCSensors[sensor].enabled) {
+        const uint16_t sample = adcGetChannel(voltageSensorAdcChannelMap[sensor]);
+        return voltageSensorADCtoVoltage(sensor, sample);
+    }
+#else
+    UNUSED(sensor);
+#endif
+
+    return 0;
+}
+
 bool voltageSensorADCRead(voltageSensorADC_e sensor, voltageMeter_t *meter)
 {
 #ifdef USE_ADC
@@ -74,6 +74,7 @@ typedef struct voltageMeter_s {
 void voltageSensorADCInit(void);
 void voltageSensorADCRefresh(void);
 bool voltageSensorADCRead(voltageSensorADC_e sensor, voltageMeter_t *voltageMeter);
+uint32_t voltageSensorADCSample(voltageSensorADC_e sensor);
 
 void voltageSensorESCInit(void);
 void voltageSensorESCRefresh(void);
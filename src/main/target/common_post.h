@@ -251,6 +251,11 @@
 #define USE_SPI_GYRO
 #endif
 
+// FIFO burst reads are supported by the ICM-426xx and BMI270 drivers
+#if defined(USE_GYRO_SPI_ICM42605) || defined(USE_GYRO_SPI_ICM42688P) || defined(USE_ACCGYRO_BMI270)
+#define USE_GYRO_FIFO
+#endif
+
 // CX10 is a special case of SPI RX which requires XN297
 #if defined(USE_RX_CX10)
 #define USE_RX_XN297
@@ -387,6 +392,12 @@ extern uint8_t eepromData[EEPROM_SIZE];
 #endif
 extern uint8_t __config_start;   // configured via linker script when building binaries.
 extern uint8_t __config_end;
+#define USE_CONFIG_JOURNAL
+// In-flight journal steps must never erase. The config streamer erases at every
+// erase unit boundary, so this is limited to MCUs whose config region is one sector.
+#if !defined(STM32G4) && !defined(STM32H7A3xx) && !defined(STM32H7A3xxQ)
+#define USE_CONFIG_JOURNAL_TASK
+#endif
 #endif
 
 #if defined(USE_EXST) && !defined(RAMBASED)
@@ -309,6 +309,7 @@ extern uint8_t _dmaram_end__;
 
 #if ((TARGET_FLASH_SIZE > 256) || (FEATURE_CUT_LEVEL < 4))
 #define USE_HUFFMAN
+#define USE_LZ4
 #define USE_PINIO
 #define USE_PINIOBOX
 #endif
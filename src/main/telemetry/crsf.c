@@ -36,6 +36,7 @@
 #include "config/feature.h"
 
 #include "common/crc.h"
+#include "common/encoding.h"
 #include "common/maths.h"
 #include "common/printf.h"
 #include "common/streambuf.h"
@@ -44,6 +45,7 @@
 
 #include "drivers/nvic.h"
 #include "drivers/persistent.h"
+#include "drivers/time.h"
 
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
@@ -73,12 +75,14 @@
 #include "sensors/esc_sensor.h"
 
 #include "telemetry/telemetry.h"
+#include "telemetry/sensors.h"
 #include "telemetry/msp_shared.h"
 
 #include "crsf.h"
 
 
 #define CRSF_CYCLETIME_US                   100000 // 100ms, 10 Hz
+#define CRSF_CUSTOM_TELEM_INTERVAL_US       20000  // 20ms, 50 Hz
 #define CRSF_DEVICEINFO_VERSION             0x01
 #define CRSF_DEVICEINFO_PARAMETER_COUNT     0
 
@@ -713,6 +717,99 @@ void crsfFrameFlightMode(sbuf_t *dst)
     *lengthPtr = sbufPtr(dst) - lengthPtr;
 }
 
+/*
+0x88 Custom telemetry
+Payload:
+uint8_t     Destination
+uint8_t     Origin
+uint8_t     Sequence number ( 0-127 )
+Repeated until the end of the frame:
+uint8_t     Sensor id ( telemetrySensorId_e ), bit 7 set if the value is absolute
+varint      Zigzag encoded value, or its change from the previous value of the sensor
+
+Only sensors that have changed are included, and every sensor is sent as an
+absolute value now and then. A receiver that sees a gap in the sequence
+numbers must forget its values and wait for an absolute one before applying
+changes again.
+*/
+
+#define CRSF_CUSTOM_TELEM_ABSOLUTE_FRAMES   32
+#define CRSF_CUSTOM_TELEM_RECORD_SIZE_MAX   6   // sensor id + 5 byte varint
+#define CRSF_CUSTOM_TELEM_ABSOLUTE_FLAG     0x80
+
+typedef struct {
+    telemetrySensor_t   sensor;
+    uint8_t             framesSinceAbsolute;
+    bool                valid;
+} crsfCustomSensor_t;
+
+static crsfCustomSensor_t crsfCustomSensors[CRSF_TELEMETRY_SENSOR_COUNT];
+static uint8_t crsfCustomSensorCount;
+static uint8_t crsfCustomSensorIndex;
+static uint8_t crsfCustomSequence;
+
+static void crsfCustomTelemetryInit(void)
+{
+    crsfCustomSensorCount = 0;
+    crsfCustomSensorIndex = 0;
+
+    for (int i = 0; i < CRSF_TELEMETRY_SENSOR_COUNT; i++) {
+        const uint8_t id = telemetryConfig()->crsf_telemetry_sensors[i];
+        if (id > TELEM_NONE && id < TELEM_SENSOR_COUNT) {
+            crsfCustomSensor_t *custom = &crsfCustomSensors[crsfCustomSensorCount++];
+            custom->sensor.sensor = id;
+            custom->sensor.index = ESC_SENSOR_COMBINED;
+            custom->sensor.threshold = telemetrySensorDesc(id)->threshold;
+            custom->valid = false;
+        }
+    }
+}
+
+static void crsfWriteVarint(sbuf_t *dst, uint32_t value)
+{
+    while (value >= 0x80) {
+        sbufWriteU8(dst, (value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    sbufWriteU8(dst, value);
+}
+
+static void crsfFrameCustomTelemetry(sbuf_t *dst)
+{
+    uint8_t *lengthPtr = sbufPtr(dst);
+    sbufWriteU8(dst, 0);
+    sbufWriteU8(dst, CRSF_FRAMETYPE_CUSTOM_TELEM);
+    sbufWriteU8(dst, CRSF_ADDRESS_RADIO_TRANSMITTER);
+    sbufWriteU8(dst, CRSF_ADDRESS_FLIGHT_CONTROLLER);
+    sbufWriteU8(dst, crsfCustomSequence);
+
+    crsfCustomSequence = (crsfCustomSequence + 1) & 0x7F;
+
+    // Continue from where the previous frame ran out of room. One byte is left for the CRC.
+    for (int i = 0; i < crsfCustomSensorCount && sbufBytesRemaining(dst) > CRSF_CUSTOM_TELEM_RECORD_SIZE_MAX; i++) {
+        crsfCustomSensor_t *custom = &crsfCustomSensors[crsfCustomSensorIndex];
+        crsfCustomSensorIndex = (crsfCustomSensorIndex + 1) % crsfCustomSensorCount;
+
+        const int32_t value = telemetrySensorValue(&custom->sensor);
+        const int32_t delta = value - custom->sensor.value;
+
+        if (!custom->valid || ++custom->framesSinceAbsolute >= CRSF_CUSTOM_TELEM_ABSOLUTE_FRAMES) {
+            sbufWriteU8(dst, custom->sensor.sensor | CRSF_CUSTOM_TELEM_ABSOLUTE_FLAG);
+            crsfWriteVarint(dst, zigzagEncode(value));
+            custom->sensor.value = value;
+            custom->framesSinceAbsolute = 0;
+            custom->valid = true;
+        }
+        else if ((uint32_t)ABS(delta) > custom->sensor.threshold) {
+            sbufWriteU8(dst, custom->sensor.sensor);
+            crsfWriteVarint(dst, zigzagEncode(delta));
+            custom->sensor.value = value;
+        }
+    }
+
+    *lengthPtr = sbufPtr(dst) - lengthPtr;
+}
+
 /*
 0x29 Device Info
 Payload:
@@ -903,19 +1000,21 @@ static void crsfFrameDisplayPortClear(sbuf_t *dst)
 
 #endif
 
-// schedule array to decide how often each type of frame is sent
+// telemetry frames handed out by the shared telemetry scheduler
 typedef enum {
     CRSF_FRAME_START_INDEX = 0,
     CRSF_FRAME_ATTITUDE_INDEX = CRSF_FRAME_START_INDEX,
     CRSF_FRAME_BATTERY_SENSOR_INDEX,
     CRSF_FRAME_FLIGHT_MODE_INDEX,
     CRSF_FRAME_GPS_INDEX,
+    CRSF_FRAME_CUSTOM_INDEX,
     CRSF_FRAME_HEARTBEAT_INDEX,
     CRSF_SCHEDULE_COUNT_MAX
 } crsfFrameTypeIndex_e;
 
-static uint8_t crsfScheduleCount;
-static uint8_t crsfSchedule[CRSF_SCHEDULE_COUNT_MAX];
+static telemetrySensor_t crsfSensors[CRSF_SCHEDULE_COUNT_MAX];
+static telemetrySchedule_t crsfSchedule;
+static timeDelta_t crsfFrameInterval;
 
 #if defined(USE_MSP_OVER_TELEMETRY)
 
@@ -944,52 +1043,151 @@ static void crsfSendMspResponse(uint8_t *payload, const uint8_t payloadSize)
 }
 #endif
 
+static void crsfFrameWrite(sbuf_t *dst, uint16_t frameIndex)
+{
+    switch (frameIndex) {
+        case CRSF_FRAME_ATTITUDE_INDEX:
+            crsfFrameAttitude(dst);
+            break;
+        case CRSF_FRAME_BATTERY_SENSOR_INDEX:
+            crsfFrameBatterySensor(dst);
+            break;
+        case CRSF_FRAME_FLIGHT_MODE_INDEX:
+            crsfFrameFlightMode(dst);
+            break;
+#ifdef USE_GPS
+        case CRSF_FRAME_GPS_INDEX:
+            crsfFrameGps(dst);
+            break;
+#endif
+        case CRSF_FRAME_CUSTOM_INDEX:
+            crsfFrameCustomTelemetry(dst);
+            break;
+        default:
+            crsfFrameHeartbeat(dst);
+            break;
+    }
+}
+
+static uint32_t crsfSignatureAdd(uint32_t signature, int32_t value)
+{
+    return signature * 31 + (uint32_t)value;
+}
+
+static int32_t crsfFlightModeSignature(void)
+{
+    const uint32_t armState = ARMING_FLAG(ARMED) | (isArmingDisabled() << 1);
+    escSensorData_t *escData;
+    voltageMeter_t meter;
+
+    switch (telemetryConfig()->crsf_flight_mode_reuse) {
+        case CRSF_FM_REUSE_GOV_STATE:
+            return crsfSignatureAdd(armState, getGovernorState());
+        case CRSF_FM_REUSE_HEADSPEED:
+            return getHeadSpeed();
+        case CRSF_FM_REUSE_THROTTLE:
+            return lrintf(getGovernorOutput() * 100);
+        case CRSF_FM_REUSE_ESC_TEMP:
+            escData = getEscSensorData(ESC_SENSOR_COMBINED);
+            return (escData) ? escData->temperature / 10 : 0;
+        case CRSF_FM_REUSE_MCU_TEMP:
+            return getCoreTemperatureCelsius();
+        case CRSF_FM_REUSE_MCU_LOAD:
+            return getAverageCPULoadPercent();
+        case CRSF_FM_REUSE_SYS_LOAD:
+            return getAverageSystemLoadPercent();
+        case CRSF_FM_REUSE_RT_LOAD:
+            return getMaxRealTimeLoadPercent();
+        case CRSF_FM_REUSE_BEC_VOLTAGE:
+            return voltageMeterRead(VOLTAGE_METER_ID_BEC, &meter) ? meter.voltage / 10 : 0;
+        case CRSF_FM_REUSE_BUS_VOLTAGE:
+            return voltageMeterRead(VOLTAGE_METER_ID_BUS, &meter) ? meter.voltage / 10 : 0;
+        case CRSF_FM_REUSE_MCU_VOLTAGE:
+            return voltageMeterRead(VOLTAGE_METER_ID_MCU, &meter) ? meter.voltage / 10 : 0;
+        case CRSF_FM_REUSE_ADJFUNC:
+        case CRSF_FM_REUSE_GOV_ADJFUNC:
+            if (getAdjustmentsRangeName())
+                return crsfSignatureAdd(getAdjustmentsRangeFunc(), getAdjustmentsRangeValue());
+            if (telemetryConfig()->crsf_flight_mode_reuse == CRSF_FM_REUSE_GOV_ADJFUNC)
+                return crsfSignatureAdd(armState, getGovernorState());
+            return 0;
+        default:
+            break;
+    }
+
+    uint32_t signature = crsfSignatureAdd(armState, flightModeFlags);
+#ifdef USE_GPS
+    signature = crsfSignatureAdd(signature, STATE(GPS_FIX) | (STATE(GPS_FIX_HOME) << 1));
+#endif
+    return signature;
+}
+
+// Combine the values carried by a frame, after the *_reuse substitutions,
+// into one signature. The scheduler only compares it for equality.
+static int32_t crsfFrameSignature(const telemetrySensor_t *sensor)
+{
+    uint32_t signature = 0;
+
+    switch (sensor->code) {
+        case CRSF_FRAME_ATTITUDE_INDEX:
+            signature = crsfSignatureAdd(signature, crsfAttitudeReuse(telemetryConfig()->crsf_att_pitch_reuse, attitude.values.pitch));
+            signature = crsfSignatureAdd(signature, crsfAttitudeReuse(telemetryConfig()->crsf_att_roll_reuse, attitude.values.roll));
+            signature = crsfSignatureAdd(signature, crsfAttitudeReuse(telemetryConfig()->crsf_att_yaw_reuse, attitude.values.yaw));
+            break;
+        case CRSF_FRAME_BATTERY_SENSOR_INDEX:
+            signature = crsfSignatureAdd(signature, telemetryConfig()->report_cell_voltage ?
+                getBatteryAverageCellVoltage() : getLegacyBatteryVoltage());
+            signature = crsfSignatureAdd(signature, getLegacyBatteryCurrent());
+            signature = crsfSignatureAdd(signature, getBatteryCapacityUsed());
+            signature = crsfSignatureAdd(signature, calculateBatteryPercentageRemaining());
+            break;
+        case CRSF_FRAME_FLIGHT_MODE_INDEX:
+            signature = crsfFlightModeSignature();
+            break;
+#ifdef USE_GPS
+        case CRSF_FRAME_GPS_INDEX:
+            signature = crsfSignatureAdd(signature, gpsSol.llh.lat);
+            signature = crsfSignatureAdd(signature, gpsSol.llh.lon);
+            signature = crsfSignatureAdd(signature, crsfGpsReuse(telemetryConfig()->crsf_gps_ground_speed_reuse, gpsSol.groundSpeed));
+            signature = crsfSignatureAdd(signature, crsfGpsReuse(telemetryConfig()->crsf_gps_heading_reuse, gpsSol.groundCourse));
+            signature = crsfSignatureAdd(signature, crsfGpsAltitudeReuse(telemetryConfig()->crsf_gps_altitude_reuse, getEstimatedAltitudeCm()));
+            signature = crsfSignatureAdd(signature, crsfGpsSatsReuse(telemetryConfig()->crsf_gps_sats_reuse, gpsSol.numSat));
+            break;
+#endif
+        default:
+            // The custom frame leaves out unchanged values by itself
+            break;
+    }
+
+    return signature;
+}
+
 static void processCrsf(void)
 {
     if (!crsfRxIsTelemetryBufEmpty()) {
         return; // do nothing if telemetry ouptut buffer is not empty yet.
     }
 
-    static uint8_t crsfScheduleIndex = 0;
-
-    const uint8_t currentSchedule = crsfSchedule[crsfScheduleIndex];
+    const timeMs_t currentTimeMs = millis();
+    telemetrySensor_t *sensor = telemetryScheduleNext(&crsfSchedule, currentTimeMs);
 
     sbuf_t crsfPayloadBuf;
     sbuf_t *dst = &crsfPayloadBuf;
 
-    if (currentSchedule & BIT(CRSF_FRAME_ATTITUDE_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameAttitude(dst);
-        crsfFinalize(dst);
-    }
-    if (currentSchedule & BIT(CRSF_FRAME_BATTERY_SENSOR_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameBatterySensor(dst);
-        crsfFinalize(dst);
-    }
-
-    if (currentSchedule & BIT(CRSF_FRAME_FLIGHT_MODE_INDEX)) {
+    if (sensor) {
         crsfInitializeFrame(dst);
-        crsfFrameFlightMode(dst);
+        crsfFrameWrite(dst, sensor->code);
         crsfFinalize(dst);
+        telemetryScheduleCommit(sensor, currentTimeMs);
     }
-#ifdef USE_GPS
-    if (currentSchedule & BIT(CRSF_FRAME_GPS_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameGps(dst);
-        crsfFinalize(dst);
-    }
-#endif
-
 #if defined(USE_CRSF_V3)
-    if (currentSchedule & BIT(CRSF_FRAME_HEARTBEAT_INDEX)) {
+    else {
+        // keep the frame rate up when there is nothing else to send
         crsfInitializeFrame(dst);
         crsfFrameHeartbeat(dst);
         crsfFinalize(dst);
     }
 #endif
-
-    crsfScheduleIndex = (crsfScheduleIndex + 1) % crsfScheduleCount;
 }
 
 void crsfScheduleDeviceInfoResponse(void)
@@ -997,31 +1195,17 @@ void crsfScheduleDeviceInfoResponse(void)
     deviceInfoReplyPending = true;
 }
 
-void initCrsfTelemetry(void)
+static void crsfNativeTelemetryInit(void)
 {
-    // check if there is a serial port open for CRSF telemetry (ie opened by the CRSF RX)
-    // and feature is enabled, if so, set CRSF telemetry enabled
-    crsfTelemetryEnabled = crsfRxIsActive();
-
-    if (!crsfTelemetryEnabled) {
-        return;
-    }
-
-    deviceInfoReplyPending = false;
-#if defined(USE_MSP_OVER_TELEMETRY)
-    mspReplyPending = false;
-#endif
-
-    int index = 0;
     if (sensors(SENSOR_ACC) && telemetryIsSensorEnabled(SENSOR_PITCH | SENSOR_ROLL | SENSOR_HEADING)) {
-        crsfSchedule[index++] = BIT(CRSF_FRAME_ATTITUDE_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_ATTITUDE_INDEX, TELEM_ATTITUDE, 0);
     }
     if ((isBatteryVoltageConfigured() && telemetryIsSensorEnabled(SENSOR_VOLTAGE))
         || (isBatteryCurrentConfigured() && telemetryIsSensorEnabled(SENSOR_CURRENT | SENSOR_FUEL))) {
-        crsfSchedule[index++] = BIT(CRSF_FRAME_BATTERY_SENSOR_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_BATTERY_SENSOR_INDEX, TELEM_BATTERY, 0);
     }
     if (telemetryIsSensorEnabled(SENSOR_MODE)) {
-        crsfSchedule[index++] = BIT(CRSF_FRAME_FLIGHT_MODE_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_FLIGHT_MODE_INDEX, TELEM_FLIGHT_MODE, 0);
     }
 #ifdef USE_GPS
     if ((featureIsEnabled(FEATURE_GPS)
@@ -1030,18 +1214,45 @@ void initCrsfTelemetry(void)
        || telemetryConfig()->crsf_gps_heading_reuse
        || telemetryConfig()->crsf_gps_altitude_reuse
        || telemetryConfig()->crsf_gps_sats_reuse) {
-        crsfSchedule[index++] = BIT(CRSF_FRAME_GPS_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_GPS_INDEX, TELEM_GPS, 0);
     }
 #endif
 
+    // Same link budget as before: every frame type at 10Hz on average
+    const int frameCount = telemetryScheduleCount(&crsfSchedule);
+    crsfFrameInterval = (frameCount > 0) ? CRSF_CYCLETIME_US / frameCount : CRSF_CYCLETIME_US;
+
 #if defined(USE_CRSF_V3)
-    while (index < (CRSF_CYCLETIME_US / CRSF_TELEMETRY_FRAME_INTERVAL_MAX_US) && index < CRSF_SCHEDULE_COUNT_MAX) {
-        // schedule heartbeat to ensure that telemetry/heartbeat frames are sent at minimum 50Hz
-        crsfSchedule[index++] = BIT(CRSF_FRAME_HEARTBEAT_INDEX);
+    // telemetry/heartbeat frames are sent at minimum 50Hz
+    crsfFrameInterval = MIN(crsfFrameInterval, CRSF_TELEMETRY_FRAME_INTERVAL_MAX_US);
+#endif
+}
+
+void initCrsfTelemetry(void)
+{
+    // check if there is a serial port open for CRSF telemetry (ie opened by the CRSF RX)
+    // and feature is enabled, if so, set CRSF telemetry enabled
+    crsfTelemetryEnabled = crsfRxIsActive();
+
+    if (!crsfTelemetryEnabled) {
+        return;
     }
+
+    deviceInfoReplyPending = false;
+#if defined(USE_MSP_OVER_TELEMETRY)
+    mspReplyPending = false;
 #endif
 
-    crsfScheduleCount = (uint8_t)index;
+    telemetryScheduleInit(&crsfSchedule, crsfSensors, CRSF_SCHEDULE_COUNT_MAX, crsfFrameSignature);
+
+    if (telemetryConfig()->crsf_telemetry_mode == CRSF_TELEMETRY_MODE_CUSTOM) {
+        crsfCustomTelemetryInit();
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_CUSTOM_INDEX, TELEM_NONE, 0);
+        crsfFrameInterval = CRSF_CUSTOM_TELEM_INTERVAL_US;
+    }
+    else {
+        crsfNativeTelemetryInit();
+    }
 
 #if defined(USE_CRSF_CMS_TELEMETRY)
     crsfDisplayportRegister();
@@ -1179,7 +1390,7 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
 
     // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
     // Spread out scheduled frames evenly so each frame is sent at the same frequency.
-    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
+    if (currentTimeUs >= crsfLastCycleTime + crsfFrameInterval) {
         crsfLastCycleTime = currentTimeUs;
         processCrsf();
     }
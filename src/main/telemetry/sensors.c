@@ -0,0 +1,355 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_TELEMETRY
+
+#include "common/axis.h"
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "config/feature.h"
+
+#include "fc/runtime_config.h"
+#include "fc/rc_adjustments.h"
+
+#include "flight/imu.h"
+#include "flight/motors.h"
+#include "flight/position.h"
+#include "flight/governor.h"
+
+#include "io/gps.h"
+
+#include "sensors/acceleration.h"
+#include "sensors/adcinternal.h"
+#include "sensors/battery.h"
+#include "sensors/esc_sensor.h"
+#include "sensors/gyro.h"
+#include "sensors/sensors.h"
+#include "sensors/voltage.h"
+
+#include "telemetry/sensors.h"
+
+
+// Weight given to an unchanged value that is not yet due for a refresh
+#define TELEM_WEIGHT_IDLE   1
+
+// Smoothing of the vibration level between samples
+#define TELEM_VIBRATION_GAIN    0.1f
+
+static const telemetrySensorDesc_t telemetrySensors[TELEM_SENSOR_COUNT] =
+{
+    [TELEM_NONE]                    = {   0,    0,    0,   0 },
+    [TELEM_HEARTBEAT]               = {   1,    0, 1000,   0 },
+
+    [TELEM_BATTERY]                 = {  80,   50, 1000,   0 },
+    [TELEM_BATTERY_VOLTAGE]         = {  60,   50, 1000,   5 },
+    [TELEM_BATTERY_CURRENT]         = { 100,   50, 1000,   5 },
+    [TELEM_BATTERY_CONSUMPTION]     = {  40,  200, 2000,   1 },
+    [TELEM_BATTERY_CHARGE_LEVEL]    = {  20,  500, 5000,   0 },
+    [TELEM_BATTERY_CELL_VOLTAGE]    = {  40,  100, 2000,   2 },
+
+    [TELEM_HEADSPEED]               = { 100,   50, 1000,   5 },
+
+    [TELEM_ATTITUDE]                = { 100,   20, 1000,   0 },
+    [TELEM_ATTITUDE_PITCH]          = {  80,   20, 1000,   5 },
+    [TELEM_ATTITUDE_ROLL]           = {  80,   20, 1000,   5 },
+    [TELEM_ATTITUDE_YAW]            = {  60,   20, 1000,   5 },
+
+    [TELEM_ACCEL_X]                 = {  40,   50, 2000,   5 },
+    [TELEM_ACCEL_Y]                 = {  40,   50, 2000,   5 },
+    [TELEM_ACCEL_Z]                 = {  40,   50, 2000,   5 },
+
+    [TELEM_ALTITUDE]                = {  50,  100, 2000,  10 },
+    [TELEM_VARIO]                   = {  50,  100, 2000,   5 },
+
+    [TELEM_GPS]                     = {  50,  100, 2000,   0 },
+    [TELEM_GPS_COORD]               = {  30,  100, 2000,   0 },
+    [TELEM_GPS_GROUNDSPEED]         = {  30,  100, 2000,  10 },
+    [TELEM_GPS_HOME_DISTANCE]       = {  30,  200, 2000,   1 },
+    [TELEM_GPS_ALTITUDE]            = {  30,  200, 2000,  50 },
+
+    [TELEM_ESC_VOLTAGE]             = {  40,  100, 2000,   5 },
+    [TELEM_ESC_CURRENT]             = {  40,  100, 2000,   5 },
+    [TELEM_ESC_RPM]                 = {  60,  100, 2000,   5 },
+    [TELEM_ESC_TEMP]                = {  20,  500, 5000,   5 },
+
+    [TELEM_MCU_TEMP]                = {  10, 1000, 5000,   1 },
+
+    [TELEM_FLIGHT_MODE]             = {  50,   50, 2000,   0 },
+    [TELEM_GOVERNOR_STATE]          = {  50,   50, 2000,   0 },
+    [TELEM_STATUS]                  = {  20,  200, 1000,   0 },
+
+    [TELEM_ADJFUNC]                 = {  50,   50, 2000,   0 },
+    [TELEM_ADJVALUE]                = {  50,   50, 2000,   0 },
+
+    [TELEM_BEC_VOLTAGE]             = {  40,  100, 2000,  50 },
+    [TELEM_THROTTLE]                = {  60,   50, 1000,   5 },
+    [TELEM_VIBRATION]               = {  40,  100, 2000,   5 },
+};
+
+const telemetrySensorDesc_t * telemetrySensorDesc(telemetrySensorId_e id)
+{
+    return &telemetrySensors[(id < TELEM_SENSOR_COUNT) ? id : TELEM_NONE];
+}
+
+
+/** Shared sensor values **/
+
+static int32_t telemetryFlightModeValue(void)
+{
+    int32_t value = 0;
+
+    if (ARMING_FLAG(ARMED))
+        value |= BIT(0);
+    if (isArmingDisabled())
+        value |= BIT(1);
+
+    return value | (flightModeFlags << 2);
+}
+
+static int32_t telemetryVoltageMeterValue(voltageMeterId_e id)
+{
+    voltageMeter_t meter;
+
+    return voltageMeterRead(id, &meter) ? meter.voltage : 0;
+}
+
+// Smoothed difference between the raw and filtered gyro [deg/s]
+static float telemetryVibration = 0;
+
+// Difference between the raw and filtered gyro, in 0.1 deg/s
+static int32_t telemetryVibrationValue(void)
+{
+    return lrintf(telemetryVibration * 10);
+}
+
+#ifdef USE_ESC_SENSOR
+static int32_t telemetryEscValue(const telemetrySensor_t *sensor)
+{
+    const escSensorData_t *escData = getEscSensorData(sensor->index);
+
+    if (escData) {
+        switch (sensor->sensor) {
+            case TELEM_ESC_VOLTAGE:
+                return escData->voltage;
+            case TELEM_ESC_CURRENT:
+                return escData->current;
+            case TELEM_ESC_TEMP:
+                return escData->temperature;
+            default:
+                break;
+        }
+    }
+
+    return 0;
+}
+#endif
+
+int32_t telemetrySensorValue(const telemetrySensor_t *sensor)
+{
+    switch (sensor->sensor) {
+        case TELEM_BATTERY_VOLTAGE:
+            return getBatteryVoltage();
+        case TELEM_BATTERY_CURRENT:
+            return getBatteryCurrent();
+        case TELEM_BATTERY_CONSUMPTION:
+            return getBatteryCapacityUsed();
+        case TELEM_BATTERY_CHARGE_LEVEL:
+            return calculateBatteryPercentageRemaining();
+        case TELEM_BATTERY_CELL_VOLTAGE:
+            return getBatteryAverageCellVoltage();
+
+        case TELEM_HEADSPEED:
+            return getHeadSpeed();
+
+        case TELEM_ATTITUDE_PITCH:
+            return attitude.values.pitch;
+        case TELEM_ATTITUDE_ROLL:
+            return attitude.values.roll;
+        case TELEM_ATTITUDE_YAW:
+            return attitude.values.yaw;
+
+#ifdef USE_ACC
+        case TELEM_ACCEL_X:
+        case TELEM_ACCEL_Y:
+        case TELEM_ACCEL_Z:
+            return lrintf(100 * acc.accADC[sensor->sensor - TELEM_ACCEL_X] * acc.dev.acc_1G_rec);
+#endif
+
+        case TELEM_ALTITUDE:
+            return getEstimatedAltitudeCm();
+#ifdef USE_VARIO
+        case TELEM_VARIO:
+            return getEstimatedVario();
+#endif
+
+#ifdef USE_GPS
+        case TELEM_GPS_COORD:
+            return gpsSol.llh.lat ^ gpsSol.llh.lon;
+        case TELEM_GPS_GROUNDSPEED:
+            return gpsSol.groundSpeed;
+        case TELEM_GPS_HOME_DISTANCE:
+            return GPS_distanceToHome;
+        case TELEM_GPS_ALTITUDE:
+            return gpsSol.llh.altCm;
+        case TELEM_STATUS:
+            return STATE(GPS_FIX) | (STATE(GPS_FIX_HOME) << 1) | (gpsSol.numSat << 2);
+#endif
+
+#ifdef USE_ESC_SENSOR
+        case TELEM_ESC_VOLTAGE:
+        case TELEM_ESC_CURRENT:
+        case TELEM_ESC_TEMP:
+            return telemetryEscValue(sensor);
+#endif
+        case TELEM_ESC_RPM:
+            return (sensor->index == ESC_SENSOR_COMBINED) ?
+                getHeadSpeed() : getMotorRPM(sensor->index);
+
+#ifdef USE_ADC_INTERNAL
+        case TELEM_MCU_TEMP:
+            return getCoreTemperatureCelsius();
+#endif
+
+        case TELEM_FLIGHT_MODE:
+            return telemetryFlightModeValue();
+        case TELEM_GOVERNOR_STATE:
+            return (telemetryFlightModeValue() & 0x03) | (getGovernorState() << 2);
+
+        case TELEM_ADJFUNC:
+            return getAdjustmentsRangeFunc();
+        case TELEM_ADJVALUE:
+            return getAdjustmentsRangeValue();
+
+        case TELEM_BEC_VOLTAGE:
+            return telemetryVoltageMeterValue(VOLTAGE_METER_ID_BEC);
+        case TELEM_THROTTLE:
+            return lrintf(getGovernorOutput() * 1000);
+        case TELEM_VIBRATION:
+            return telemetryVibrationValue();
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+
+// Called at the telemetry task rate, so that the smoothing does not
+// depend on how often the protocols read the values
+void telemetrySensorsUpdate(void)
+{
+    float noise = 0;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        noise += sq(gyro.gyroADC[axis] - gyro.gyroADCf[axis]);
+    }
+
+    telemetryVibration += (sqrtf(noise) - telemetryVibration) * TELEM_VIBRATION_GAIN;
+}
+
+
+/** Scheduler **/
+
+void telemetryScheduleInit(telemetrySchedule_t *sched, telemetrySensor_t *sensors, uint8_t size, telemetryValueFn *valueFn)
+{
+    sched->sensors = sensors;
+    sched->size = size;
+    sched->count = 0;
+    sched->valueFn = valueFn ? valueFn : telemetrySensorValue;
+}
+
+telemetrySensor_t * telemetryScheduleAdd(telemetrySchedule_t *sched, uint16_t code, telemetrySensorId_e sensor, uint8_t index)
+{
+    if (sched->count >= sched->size)
+        return NULL;
+
+    telemetrySensor_t *entry = &sched->sensors[sched->count++];
+
+    entry->code = code;
+    entry->sensor = sensor;
+    entry->index = index;
+    entry->threshold = telemetrySensorDesc(sensor)->threshold;
+    entry->value = 0;
+    entry->pending = 0;
+    entry->bucket = 0;
+    entry->updated = 0;
+
+    return entry;
+}
+
+/*
+ * Pick the next entry to send, using smooth weighted round-robin.
+ *
+ * Every eligible entry adds its weight to its bucket, and the entry with
+ * the fullest bucket is sent and pays back the total. A value that has
+ * changed by more than its threshold uses its full weight; an unchanged
+ * value only gets a trickle until its refresh interval expires. Entries
+ * still inside their minimum interval are skipped. Returns NULL if
+ * nothing is eligible.
+ */
+telemetrySensor_t * telemetryScheduleNext(telemetrySchedule_t *sched, timeMs_t currentTimeMs)
+{
+    telemetrySensor_t *best = NULL;
+    int32_t total = 0;
+
+    for (int i = 0; i < sched->count; i++) {
+        telemetrySensor_t *entry = &sched->sensors[i];
+        const telemetrySensorDesc_t *desc = telemetrySensorDesc(entry->sensor);
+        const timeDelta_t age = cmp32(currentTimeMs, entry->updated);
+
+        if (entry->updated && age < desc->minInterval)
+            continue;
+
+        entry->pending = sched->valueFn(entry);
+
+        // Entries without a threshold may carry a signature, which only compares for equality
+        const bool changed = entry->threshold ?
+            llabs((int64_t)entry->pending - entry->value) > entry->threshold :
+            entry->pending != entry->value;
+        const bool expired = !entry->updated || age >= desc->maxInterval;
+        const int32_t weight = (changed || expired) ? desc->weight : TELEM_WEIGHT_IDLE;
+
+        entry->bucket += weight;
+        total += weight;
+
+        if (!best || entry->bucket > best->bucket)
+            best = entry;
+    }
+
+    if (best)
+        best->bucket -= total;
+
+    return best;
+}
+
+void telemetryScheduleCommit(telemetrySensor_t *sensor, timeMs_t currentTimeMs)
+{
+    sensor->value = sensor->pending;
+    sensor->updated = currentTimeMs ? currentTimeMs : 1;
+}
+
+#endif /* USE_TELEMETRY */
@@ -0,0 +1,127 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+/*
+ * Telemetry values shared by all telemetry protocols.
+ *
+ * Each sensor has a default bandwidth weight, rate limits and a change
+ * threshold. A protocol builds a schedule of its own data/frame ids,
+ * each bound to one of these sensors, and asks the scheduler for the
+ * next entry whenever the link has room for one more value.
+ *
+ * The ids are also sent over the air in the CRSF custom telemetry frame,
+ * so new sensors must only be appended.
+ */
+typedef enum {
+    TELEM_NONE = 0,
+
+    TELEM_HEARTBEAT,
+
+    TELEM_BATTERY,
+    TELEM_BATTERY_VOLTAGE,
+    TELEM_BATTERY_CURRENT,
+    TELEM_BATTERY_CONSUMPTION,
+    TELEM_BATTERY_CHARGE_LEVEL,
+    TELEM_BATTERY_CELL_VOLTAGE,
+
+    TELEM_HEADSPEED,
+
+    TELEM_ATTITUDE,
+    TELEM_ATTITUDE_PITCH,
+    TELEM_ATTITUDE_ROLL,
+    TELEM_ATTITUDE_YAW,
+
+    TELEM_ACCEL_X,
+    TELEM_ACCEL_Y,
+    TELEM_ACCEL_Z,
+
+    TELEM_ALTITUDE,
+    TELEM_VARIO,
+
+    TELEM_GPS,
+    TELEM_GPS_COORD,
+    TELEM_GPS_GROUNDSPEED,
+    TELEM_GPS_HOME_DISTANCE,
+    TELEM_GPS_ALTITUDE,
+
+    TELEM_ESC_VOLTAGE,
+    TELEM_ESC_CURRENT,
+    TELEM_ESC_RPM,
+    TELEM_ESC_TEMP,
+
+    TELEM_MCU_TEMP,
+
+    TELEM_FLIGHT_MODE,
+    TELEM_GOVERNOR_STATE,
+    TELEM_STATUS,
+
+    TELEM_ADJFUNC,
+    TELEM_ADJVALUE,
+
+    TELEM_BEC_VOLTAGE,
+    TELEM_THROTTLE,
+    TELEM_VIBRATION,
+
+    TELEM_SENSOR_COUNT
+} telemetrySensorId_e;
+
+typedef struct {
+    uint8_t     weight;         // Share of the link while the value is changing
+    uint16_t    minInterval;    // Minimum time between updates (ms)
+    uint16_t    maxInterval;    // Update at least this often, even if unchanged (ms)
+    uint16_t    threshold;      // Change needed to count as a new value
+} telemetrySensorDesc_t;
+
+typedef struct telemetrySensor_s {
+    uint16_t    code;           // Protocol specific data/frame id
+    uint8_t     sensor;         // telemetrySensorId_e
+    uint8_t     index;          // Motor/ESC number, where applicable
+    uint16_t    threshold;
+    int32_t     value;          // Value at the last update
+    int32_t     pending;        // Value at selection time
+    int32_t     bucket;
+    timeMs_t    updated;
+} telemetrySensor_t;
+
+typedef int32_t telemetryValueFn(const telemetrySensor_t *sensor);
+
+typedef struct {
+    telemetrySensor_t  *sensors;
+    uint8_t             size;
+    uint8_t             count;
+    telemetryValueFn   *valueFn;
+} telemetrySchedule_t;
+
+const telemetrySensorDesc_t * telemetrySensorDesc(telemetrySensorId_e id);
+
+int32_t telemetrySensorValue(const telemetrySensor_t *sensor);
+void telemetrySensorsUpdate(void);
+
+void telemetryScheduleInit(telemetrySchedule_t *sched, telemetrySensor_t *sensors, uint8_t size, telemetryValueFn *valueFn);
+telemetrySensor_t * telemetryScheduleAdd(telemetrySchedule_t *sched, uint16_t code, telemetrySensorId_e sensor, uint8_t index);
+telemetrySensor_t * telemetryScheduleNext(telemetrySchedule_t *sched, timeMs_t currentTimeMs);
+void telemetryScheduleCommit(telemetrySensor_t *sensor, timeMs_t currentTimeMs);
+
+static inline uint8_t telemetryScheduleCount(const telemetrySchedule_t *sched) { return sched->count; }
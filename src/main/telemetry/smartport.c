@@ -83,6 +83,7 @@
 #include "sensors/sensors.h"
 
 #include "telemetry/msp_shared.h"
+#include "telemetry/sensors.h"
 #include "telemetry/smartport.h"
 #include "telemetry/telemetry.h"
 
@@ -162,28 +163,18 @@ enum
 // if adding more sensors then increase this value (should be equal to the maximum number of ADD_SENSOR calls)
 #define MAX_DATAIDS 25
 
-static uint16_t frSkyDataIdTable[MAX_DATAIDS];
-
 #ifdef USE_ESC_SENSOR_TELEMETRY
-// number of sensors to send between sending the ESC sensors
-#define ESC_SENSOR_PERIOD 7
-
 // if adding more esc sensors then increase this value
 #define MAX_ESC_DATAIDS 4
-
-static uint16_t frSkyEscDataIdTable[MAX_ESC_DATAIDS];
+#else
+#define MAX_ESC_DATAIDS 0
 #endif
 
-typedef struct frSkyTableInfo_s {
-    uint16_t * table;
-    uint8_t size;
-    uint8_t index;
-} frSkyTableInfo_t;
+// ESC sensors are sent for the combined value and for each motor
+#define MAX_SCHEDULE_DATAIDS (MAX_DATAIDS + MAX_ESC_DATAIDS * (MAX_SUPPORTED_MOTORS + 1))
 
-static frSkyTableInfo_t frSkyDataIdTableInfo = { frSkyDataIdTable, 0, 0 };
-#ifdef USE_ESC_SENSOR_TELEMETRY
-static frSkyTableInfo_t frSkyEscDataIdTableInfo = {frSkyEscDataIdTable, 0, 0};
-#endif
+static telemetrySensor_t frSkySensors[MAX_SCHEDULE_DATAIDS];
+static telemetrySchedule_t frSkySchedule;
 
 #define SMARTPORT_BAUD 57600
 #define SMARTPORT_UART_MODE MODE_RXTX
@@ -327,26 +318,26 @@ static void smartPortSendPackage(uint16_t id, uint32_t val)
     smartPortWriteFrame(&payload);
 }
 
-#define ADD_SENSOR(dataId) frSkyDataIdTableInfo.table[frSkyDataIdTableInfo.index++] = dataId
-#define ADD_ESC_SENSOR(dataId) frSkyEscDataIdTableInfo.table[frSkyEscDataIdTableInfo.index++] = dataId
+#define ADD_SENSOR(dataId, sensor) telemetryScheduleAdd(&frSkySchedule, dataId, sensor, 0)
+#define ADD_ESC_SENSOR(dataId, sensor, motor) telemetryScheduleAdd(&frSkySchedule, dataId, sensor, motor)
 
 static void initSmartPortSensors(void)
 {
-    frSkyDataIdTableInfo.index = 0;
+    telemetryScheduleInit(&frSkySchedule, frSkySensors, MAX_SCHEDULE_DATAIDS, NULL);
 
     //prob need configurator option for these?
     if (telemetryIsSensorEnabled(SENSOR_GOV_MODE)) {
-    ADD_SENSOR(FSSP_DATAID_GOV_MODE);
-    }    
+        ADD_SENSOR(FSSP_DATAID_GOV_MODE, TELEM_GOVERNOR_STATE);
+    }
 
     if (telemetryIsSensorEnabled(SENSOR_MODE)) {
-        ADD_SENSOR(FSSP_DATAID_T1);
-        ADD_SENSOR(FSSP_DATAID_T2);
+        ADD_SENSOR(FSSP_DATAID_T1, TELEM_FLIGHT_MODE);
+        ADD_SENSOR(FSSP_DATAID_T2, TELEM_STATUS);
     }
 
 #if defined(USE_ADC_INTERNAL)
     if (telemetryIsSensorEnabled(SENSOR_TEMPERATURE)) {
-        ADD_SENSOR(FSSP_DATAID_T11);
+        ADD_SENSOR(FSSP_DATAID_T11, TELEM_MCU_TEMP);
     }
 #endif
 
@@ -355,10 +346,10 @@ static void initSmartPortSensors(void)
         if (!telemetryIsSensorEnabled(ESC_SENSOR_VOLTAGE))
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_VFAS);
+            ADD_SENSOR(FSSP_DATAID_VFAS, TELEM_BATTERY_VOLTAGE);
         }
 
-        ADD_SENSOR(FSSP_DATAID_A4);
+        ADD_SENSOR(FSSP_DATAID_A4, TELEM_BATTERY_CELL_VOLTAGE);
     }
 
     if (isBatteryCurrentConfigured() && telemetryIsSensorEnabled(SENSOR_CURRENT)) {
@@ -366,95 +357,94 @@ static void initSmartPortSensors(void)
         if (!telemetryIsSensorEnabled(ESC_SENSOR_CURRENT))
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_CURRENT);
+            ADD_SENSOR(FSSP_DATAID_CURRENT, TELEM_BATTERY_CURRENT);
         }
 
         if (telemetryIsSensorEnabled(SENSOR_FUEL)) {
-            ADD_SENSOR(FSSP_DATAID_FUEL);
+            ADD_SENSOR(FSSP_DATAID_FUEL, (batteryConfig()->batteryCapacity > 0) ?
+                TELEM_BATTERY_CHARGE_LEVEL : TELEM_BATTERY_CONSUMPTION);
         }
 
         if (telemetryIsSensorEnabled(SENSOR_CAP_USED)) {
-            ADD_SENSOR(FSSP_DATAID_CAP_USED);
+            ADD_SENSOR(FSSP_DATAID_CAP_USED, TELEM_BATTERY_CONSUMPTION);
         }
     }
 
     if (telemetryIsSensorEnabled(SENSOR_HEADING)) {
-        ADD_SENSOR(FSSP_DATAID_HEADING);
+        ADD_SENSOR(FSSP_DATAID_HEADING, TELEM_ATTITUDE_YAW);
     }
 
 #if defined(USE_ACC)
     if (sensors(SENSOR_ACC)) {
         if (telemetryIsSensorEnabled(SENSOR_PITCH)) {
-            ADD_SENSOR(FSSP_DATAID_PITCH);
+            ADD_SENSOR(FSSP_DATAID_PITCH, TELEM_ATTITUDE_PITCH);
         }
         if (telemetryIsSensorEnabled(SENSOR_ROLL)) {
-            ADD_SENSOR(FSSP_DATAID_ROLL);
+            ADD_SENSOR(FSSP_DATAID_ROLL, TELEM_ATTITUDE_ROLL);
         }
         if (telemetryIsSensorEnabled(SENSOR_ACC_X)) {
-            ADD_SENSOR(FSSP_DATAID_ACCX);
+            ADD_SENSOR(FSSP_DATAID_ACCX, TELEM_ACCEL_X);
         }
         if (telemetryIsSensorEnabled(SENSOR_ACC_Y)) {
-            ADD_SENSOR(FSSP_DATAID_ACCY);
+            ADD_SENSOR(FSSP_DATAID_ACCY, TELEM_ACCEL_Y);
         }
         if (telemetryIsSensorEnabled(SENSOR_ACC_Z)) {
-            ADD_SENSOR(FSSP_DATAID_ACCZ);
+            ADD_SENSOR(FSSP_DATAID_ACCZ, TELEM_ACCEL_Z);
         }
     }
 #endif
 
     if (sensors(SENSOR_BARO)) {
         if (telemetryIsSensorEnabled(SENSOR_ALTITUDE)) {
-            ADD_SENSOR(FSSP_DATAID_ALTITUDE);
+            ADD_SENSOR(FSSP_DATAID_ALTITUDE, TELEM_ALTITUDE);
         }
         if (telemetryIsSensorEnabled(SENSOR_VARIO)) {
-            ADD_SENSOR(FSSP_DATAID_VARIO);
+            ADD_SENSOR(FSSP_DATAID_VARIO, TELEM_VARIO);
         }
     }
 
 #ifdef USE_GPS
     if (featureIsEnabled(FEATURE_GPS)) {
         if (telemetryIsSensorEnabled(SENSOR_GROUND_SPEED)) {
-            ADD_SENSOR(FSSP_DATAID_SPEED);
+            ADD_SENSOR(FSSP_DATAID_SPEED, TELEM_GPS_GROUNDSPEED);
         }
         if (telemetryIsSensorEnabled(SENSOR_LAT_LONG)) {
-            ADD_SENSOR(FSSP_DATAID_LATLONG);
-            ADD_SENSOR(FSSP_DATAID_LATLONG); // twice (one for lat, one for long)
+            // twice (index 0 for lat, index 1 for long)
+            telemetryScheduleAdd(&frSkySchedule, FSSP_DATAID_LATLONG, TELEM_GPS_COORD, 0);
+            telemetryScheduleAdd(&frSkySchedule, FSSP_DATAID_LATLONG, TELEM_GPS_COORD, 1);
         }
         if (telemetryIsSensorEnabled(SENSOR_DISTANCE)) {
-            ADD_SENSOR(FSSP_DATAID_HOME_DIST);
+            ADD_SENSOR(FSSP_DATAID_HOME_DIST, TELEM_GPS_HOME_DISTANCE);
         }
         if (telemetryIsSensorEnabled(SENSOR_ALTITUDE)) {
-            ADD_SENSOR(FSSP_DATAID_GPS_ALT);
+            ADD_SENSOR(FSSP_DATAID_GPS_ALT, TELEM_GPS_ALTITUDE);
         }
     }
 #endif
 
     if (telemetryIsSensorEnabled(SENSOR_ADJUSTMENT)) {
-        ADD_SENSOR(FSSP_DATAID_ADJFUNC);
-        ADD_SENSOR(FSSP_DATAID_ADJVALUE);
+        ADD_SENSOR(FSSP_DATAID_ADJFUNC, TELEM_ADJFUNC);
+        ADD_SENSOR(FSSP_DATAID_ADJVALUE, TELEM_ADJVALUE);
     }
 
-    frSkyDataIdTableInfo.size = frSkyDataIdTableInfo.index;
-    frSkyDataIdTableInfo.index = 0;
-
 #ifdef USE_ESC_SENSOR_TELEMETRY
-    frSkyEscDataIdTableInfo.index = 0;
+    // offset 0 is the combined value, offsets 1..N are the individual motors
+    for (int offset = 0; offset <= getMotorCount(); offset++) {
+        const uint8_t motor = offset ? offset - 1 : ESC_SENSOR_COMBINED;
 
-    if (telemetryIsSensorEnabled(ESC_SENSOR_VOLTAGE)) {
-        ADD_ESC_SENSOR(FSSP_DATAID_VFAS);
-    }
-    if (telemetryIsSensorEnabled(ESC_SENSOR_CURRENT)) {
-        ADD_ESC_SENSOR(FSSP_DATAID_CURRENT);
-    }
-    if (telemetryIsSensorEnabled(ESC_SENSOR_RPM)) {
-        ADD_ESC_SENSOR(FSSP_DATAID_RPM);
-    }
-    if (telemetryIsSensorEnabled(ESC_SENSOR_TEMPERATURE)) {
-        ADD_ESC_SENSOR(FSSP_DATAID_TEMP);
+        if (telemetryIsSensorEnabled(ESC_SENSOR_VOLTAGE)) {
+            ADD_ESC_SENSOR(FSSP_DATAID_VFAS + offset, offset ? TELEM_ESC_VOLTAGE : TELEM_BATTERY_VOLTAGE, motor);
+        }
+        if (telemetryIsSensorEnabled(ESC_SENSOR_CURRENT)) {
+            ADD_ESC_SENSOR(FSSP_DATAID_CURRENT + offset, offset ? TELEM_ESC_CURRENT : TELEM_BATTERY_CURRENT, motor);
+        }
+        if (telemetryIsSensorEnabled(ESC_SENSOR_RPM)) {
+            ADD_ESC_SENSOR(FSSP_DATAID_RPM + offset, TELEM_ESC_RPM, motor);
+        }
+        if (telemetryIsSensorEnabled(ESC_SENSOR_TEMPERATURE)) {
+            ADD_ESC_SENSOR(FSSP_DATAID_TEMP + offset, TELEM_ESC_TEMP, motor);
+        }
     }
-
-    frSkyEscDataIdTableInfo.size = frSkyEscDataIdTableInfo.index;
-    frSkyEscDataIdTableInfo.index = 0;
 #endif
 }
 
@@ -533,13 +523,9 @@ static void smartPortSendMspResponse(uint8_t *data, const uint8_t dataSize) {
 
 void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clearToSend, const timeUs_t *requestTimeout)
 {
-    static uint8_t smartPortIdCycleCnt = 0;
     static uint8_t t1Cnt = 0;
     static uint8_t t2Cnt = 0;
     static uint8_t skipRequests = 0;
-#ifdef USE_ESC_SENSOR_TELEMETRY
-    static uint8_t smartPortIdOffset = 0;
-#endif
 
 #if defined(USE_MSP_OVER_TELEMETRY)
     if (skipRequests) {
@@ -594,40 +580,19 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
         }
 #endif
 
-        // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
-        frSkyTableInfo_t * tableInfo = &frSkyDataIdTableInfo;
+        // we can send back any data we want, the telemetry scheduler picks the value most worth sending
+        const timeMs_t currentTimeMs = millis();
+        telemetrySensor_t *sensor = telemetryScheduleNext(&frSkySchedule, currentTimeMs);
 
-#ifdef USE_ESC_SENSOR_TELEMETRY
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            // send ESC sensors
-            tableInfo = &frSkyEscDataIdTableInfo;
-            if (tableInfo->index == tableInfo->size) { // end of ESC table, return to other sensors
-                tableInfo->index = 0;
-                smartPortIdCycleCnt = 0;
-                smartPortIdOffset++;
-                if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
-                    smartPortIdOffset = 0;
-                }
-            }
-        }
-        if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD) {
-            // send other sensors
-            tableInfo = &frSkyDataIdTableInfo;
-#endif
-            if (tableInfo->index == tableInfo->size) { // end of table reached, loop back
-                tableInfo->index = 0;
-            }
-#ifdef USE_ESC_SENSOR_TELEMETRY
-        }
-#endif
-        uint16_t id = tableInfo->table[tableInfo->index];
-#ifdef USE_ESC_SENSOR_TELEMETRY
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            id += smartPortIdOffset;
+        if (!sensor) {
+            // nothing is due yet
+            return;
         }
-#endif
-        smartPortIdCycleCnt++;
-        tableInfo->index++;
+
+        // the slot is used up even if nothing is sent below, so this sensor isn't picked again right away
+        telemetryScheduleCommit(sensor, currentTimeMs);
+
+        const uint16_t id = sensor->code;
 
         int32_t tmpi;
         uint32_t tmp2 = 0;
@@ -895,7 +860,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     // the same ID is sent twice, one for longitude, one for latitude
                     // the MSB of the sent uint32_t helps FrSky keep track
                     // the even/odd bit of our counter helps us keep track
-                    if (tableInfo->index & 1) {
+                    if (sensor->index & 1) {
                         tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
                         if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
@@ -48,6 +48,7 @@
 #include "rx/rx.h"
 
 #include "telemetry/telemetry.h"
+#include "telemetry/sensors.h"
 #include "telemetry/frsky_hub.h"
 #include "telemetry/hott.h"
 #include "telemetry/smartport.h"
@@ -60,7 +61,7 @@
 #include "telemetry/ibus.h"
 #include "telemetry/msp_shared.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 5);
+PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 6);
 
 PG_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig,
     .telemetry_inverted = false,
@@ -91,6 +92,18 @@ PG_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig,
     .crsf_att_pitch_reuse = CRSF_ATT_REUSE_NONE,
     .crsf_att_roll_reuse = CRSF_ATT_REUSE_NONE,
     .crsf_att_yaw_reuse = CRSF_ATT_REUSE_NONE,
+    .crsf_telemetry_mode = CRSF_TELEMETRY_MODE_NATIVE,
+    .crsf_telemetry_sensors = {
+        TELEM_HEADSPEED,
+        TELEM_BATTERY_VOLTAGE,
+        TELEM_BATTERY_CURRENT,
+        TELEM_BATTERY_CONSUMPTION,
+        TELEM_ESC_TEMP,
+        TELEM_BEC_VOLTAGE,
+        TELEM_GOVERNOR_STATE,
+        TELEM_THROTTLE,
+        TELEM_VIBRATION,
+    },
 );
 
 void telemetryInit(void)
@@ -212,6 +225,8 @@ void telemetryCheckState(void)
 
 void telemetryProcess(uint32_t currentTime)
 {
+    telemetrySensorsUpdate();
+
 #ifdef USE_TELEMETRY_FRSKY_HUB
     handleFrSkyHubTelemetry(currentTime);
 #else
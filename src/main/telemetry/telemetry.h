@@ -73,6 +73,13 @@ typedef enum {
     SENSOR_ALL             = (1 << 23) - 1,
 } sensor_e;
 
+#define CRSF_TELEMETRY_SENSOR_COUNT 16
+
+enum {
+    CRSF_TELEMETRY_MODE_NATIVE = 0,
+    CRSF_TELEMETRY_MODE_CUSTOM,
+};
+
 typedef struct telemetryConfig_s {
     int16_t gpsNoFixLatitude;
     int16_t gpsNoFixLongitude;
@@ -94,6 +101,8 @@ typedef struct telemetryConfig_s {
     uint8_t crsf_gps_ground_speed_reuse;
     uint8_t crsf_gps_altitude_reuse;
     uint8_t crsf_gps_sats_reuse;
+    uint8_t crsf_telemetry_mode;
+    uint8_t crsf_telemetry_sensors[CRSF_TELEMETRY_SENSOR_COUNT];
     uint32_t enableSensors;
 } telemetryConfig_t;
 
@@ -18,7 +18,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include <ctype.h>
 #include <limits.h>
+#include <string.h>
 
 #include <math.h>
 
@@ -64,6 +66,8 @@ extern "C" {
         { "wos_unit_test",     VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config.string = { 0, 16, STRING_FLAGS_WRITEONCE }, PG_RESERVED_FOR_TESTING_1, 0 },
     };
     const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
+    uint16_t valueTableHashHead[VALUE_TABLE_HASH_BUCKETS];
+    uint16_t valueTableHashNext[ARRAYLEN(valueTable)];
     const lookupTableEntry_t lookupTables[] = {};
     const char * const lookupTableOsdDisplayPortDevice[] = {};
 
@@ -93,6 +97,31 @@ extern "C" {
 #include "unittest_macros.h"
 #include "gtest/gtest.h"
 
+TEST(CLIUnittest, TestCliSettingIndex)
+{
+    // Every setting is found at its own index, whatever the case
+    for (uint16_t i = 0; i < valueTableEntryCount; i++) {
+        char name[32];
+        strcpy(name, valueTable[i].name);
+        EXPECT_EQ(i, cliGetSettingIndex(name, strlen(name)));
+
+        for (char *c = name; *c; c++) {
+            *c = toupper(*c);
+        }
+        EXPECT_EQ(i, cliGetSettingIndex(name, strlen(name)));
+    }
+
+    // Only exact names match
+    char *unknown = (char *)"no_such_setting";
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex(unknown, strlen(unknown)));
+
+    char *prefix = (char *)"str_unit";
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex(prefix, strlen(prefix)));
+
+    char *longer = (char *)"str_unit_test_x";
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex(longer, strlen(longer)));
+}
+
 TEST(CLIUnittest, TestCliSetArray)
 {
     char *str = (char *)"array_unit_test    =   123,  -3  , 1";
@@ -283,6 +312,7 @@ uint8_t getCurrentControlRateProfileIndex(void){ return 1; }
 void changeControlRateProfile(uint8_t) {}
 void resetAllRxChannelRangeConfigurations(rxChannelRangeConfig_t *) {}
 void writeEEPROM() {}
+void configSnapshotCancel(void) {}
 serialPortConfig_t *serialFindPortConfigurationMutable(serialPortIdentifier_e) {return NULL; }
 baudRate_e lookupBaudRateIndex(uint32_t){return BAUD_9600; }
 serialPortUsage_t *findSerialPortUsageByIdentifier(serialPortIdentifier_e){ return NULL; }
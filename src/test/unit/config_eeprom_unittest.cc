@@ -0,0 +1,338 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/config_streamer.h"
+
+    #include "drivers/system.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/position.h"
+    #include "pg/stats.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// u16 size, u16 pgn, u8 version, u8 flags
+#define RECORD_SIZE         6
+#define CR_JOURNAL_ENTRY    0x80
+
+extern "C" {
+    uint8_t eepromData[EEPROM_SIZE];
+
+    static int flashErases;
+    static int failures;
+}
+
+static uint8_t image[EEPROM_SIZE];
+
+static void eraseFlash(void)
+{
+    memset(eepromData, 0xFF, sizeof(eepromData));
+    flashErases = 0;
+    failures = 0;
+}
+
+static void changeConfig(void)
+{
+    positionConfigMutable()->gps_min_sats = 8;
+    statsConfigMutable()->stats_total_flights = 1234;
+}
+
+// Offset of the last journal entry of the PG, or -1
+static int findLastEntry(pgn_t pgn)
+{
+    const pgRegistry_t *reg = pgFind(pgn);
+    const uint16_t size = RECORD_SIZE + pgSize(reg);
+    const uint8_t header[RECORD_SIZE] = {
+        (uint8_t)(size & 0xff), (uint8_t)(size >> 8),
+        (uint8_t)(pgn & 0xff), (uint8_t)(pgn >> 8),
+        pgVersion(reg), CR_JOURNAL_ENTRY,
+    };
+    int found = -1;
+
+    for (int offset = getEEPROMConfigSize(); offset + RECORD_SIZE <= EEPROM_SIZE; offset++) {
+        if (memcmp(eepromData + offset, header, RECORD_SIZE) == 0) {
+            found = offset;
+        }
+    }
+
+    return found;
+}
+
+static void saveAndReload(void)
+{
+    writeConfigToEEPROM();
+
+    pgResetAll();
+    EXPECT_TRUE(loadEEPROM());
+}
+
+TEST(ConfigEepromTest, FullWrite)
+{
+    eraseFlash();
+    pgResetAll();
+    changeConfig();
+
+    saveAndReload();
+
+    EXPECT_EQ(1, flashErases);
+    EXPECT_TRUE(isEEPROMVersionValid());
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_EQ(8, positionConfig()->gps_min_sats);
+    EXPECT_EQ(1234u, statsConfig()->stats_total_flights);
+
+    // Nothing to do when the config is unchanged
+    memcpy(image, eepromData, sizeof(image));
+    writeConfigToEEPROM();
+
+    EXPECT_EQ(1, flashErases);
+    EXPECT_EQ(0, memcmp(image, eepromData, sizeof(image)));
+    EXPECT_EQ(0, failures);
+}
+
+TEST(ConfigEepromTest, JournalAppendsChanges)
+{
+    eraseFlash();
+    pgResetAll();
+    saveAndReload();
+
+    const int imageSize = getEEPROMConfigSize();
+    memcpy(image, eepromData, imageSize);
+
+    positionConfigMutable()->gps_min_sats = 5;
+    saveAndReload();
+
+    positionConfigMutable()->gps_min_sats = 6;
+    statsConfigMutable()->stats_total_time_s = 60;
+    saveAndReload();
+
+    // The full image stays in place, the changes are appended behind it
+    EXPECT_EQ(1, flashErases);
+    EXPECT_EQ(0, memcmp(image, eepromData, imageSize));
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_GT(findLastEntry(PG_POSITION), imageSize);
+
+    // The last entry wins
+    EXPECT_EQ(6, positionConfig()->gps_min_sats);
+    EXPECT_EQ(60u, statsConfig()->stats_total_time_s);
+    EXPECT_EQ(100, positionConfig()->baro_alt_lpf);
+    EXPECT_EQ(0, failures);
+}
+
+TEST(ConfigEepromTest, JournalFullCompacts)
+{
+    eraseFlash();
+    pgResetAll();
+    saveAndReload();
+
+    int count;
+    for (count = 1; count < EEPROM_SIZE && flashErases == 1; count++) {
+        statsConfigMutable()->stats_total_flights = count;
+        saveAndReload();
+        ASSERT_EQ((uint32_t)count, statsConfig()->stats_total_flights);
+    }
+
+    // Compacted by a full write once the sector is full
+    EXPECT_EQ(2, flashErases);
+    EXPECT_GT(count, EEPROM_SIZE / (RECORD_SIZE + (int)sizeof(statsConfig_t) + 2) / 2);
+    EXPECT_EQ(-1, findLastEntry(PG_STATS_CONFIG));
+
+    statsConfigMutable()->stats_total_flights = 1;
+    saveAndReload();
+
+    EXPECT_EQ(2, flashErases);
+    EXPECT_EQ(1u, statsConfig()->stats_total_flights);
+    EXPECT_EQ(0, failures);
+}
+
+TEST(ConfigEepromTest, CorruptEntryIgnored)
+{
+    eraseFlash();
+    pgResetAll();
+    saveAndReload();
+
+    positionConfigMutable()->gps_min_sats = 5;
+    saveAndReload();
+    positionConfigMutable()->gps_min_sats = 6;
+    saveAndReload();
+
+    const int entry = findLastEntry(PG_POSITION);
+    ASSERT_GT(entry, 0);
+    eepromData[entry + RECORD_SIZE + offsetof(positionConfig_t, gps_min_sats)] &= ~0x02;
+
+    // Falls back to the previous entry
+    pgResetAll();
+    loadEEPROM();
+    EXPECT_EQ(5, positionConfig()->gps_min_sats);
+
+    // The broken entry cannot be overwritten, so the next save compacts
+    positionConfigMutable()->gps_min_sats = 7;
+    saveAndReload();
+
+    EXPECT_EQ(2, flashErases);
+    EXPECT_EQ(7, positionConfig()->gps_min_sats);
+    EXPECT_EQ(0, failures);
+}
+
+TEST(ConfigEepromTest, StaleEntryIgnored)
+{
+    eraseFlash();
+    pgResetAll();
+    saveAndReload();
+
+    positionConfigMutable()->gps_min_sats = 5;
+    saveAndReload();
+
+    const int entry = findLastEntry(PG_POSITION);
+    ASSERT_GT(entry, 0);
+    uint8_t stale[RECORD_SIZE + sizeof(positionConfig_t) + 2];
+    memcpy(stale, eepromData + entry, sizeof(stale));
+
+    // A new image of the same size, with the old entry left behind it
+    pgResetAll();
+    statsConfigMutable()->stats_total_flights = 10;
+    eraseFlash();
+    writeConfigToEEPROM();
+    memcpy(eepromData + entry, stale, sizeof(stale));
+
+    pgResetAll();
+    loadEEPROM();
+
+    EXPECT_EQ(12, positionConfig()->gps_min_sats);
+    EXPECT_EQ(10u, statsConfig()->stats_total_flights);
+    EXPECT_EQ(0, failures);
+}
+
+TEST(ConfigEepromTest, JournalInFlight)
+{
+    eraseFlash();
+    pgResetAll();
+    saveAndReload();
+
+    // Nothing is written until a change is requested
+    changeConfig();
+    configJournalProcess();
+    EXPECT_EQ(-1, findLastEntry(PG_POSITION));
+
+    configJournalRequest();
+    for (int i = 0; i < 10; i++) {
+        configJournalProcess();
+    }
+
+    EXPECT_GT(findLastEntry(PG_POSITION), 0);
+    EXPECT_GT(findLastEntry(PG_STATS_CONFIG), 0);
+
+    // Already saved
+    memcpy(image, eepromData, sizeof(image));
+    writeConfigToEEPROM();
+    EXPECT_EQ(0, memcmp(image, eepromData, sizeof(image)));
+
+    pgResetAll();
+    loadEEPROM();
+
+    EXPECT_EQ(1, flashErases);
+    EXPECT_EQ(8, positionConfig()->gps_min_sats);
+    EXPECT_EQ(1234u, statsConfig()->stats_total_flights);
+    EXPECT_EQ(0, failures);
+}
+
+// STUBS
+
+extern "C" {
+
+void failureMode(failureMode_e) { failures++; }
+
+// NOR flash over eepromData, erased as a single sector
+static int writeWord(config_streamer_t *c)
+{
+    uint8_t *dst = (uint8_t *)c->address;
+
+    if (dst < eepromData || dst + sizeof(c->buffer) > ARRAYEND(eepromData)) {
+        return -1;
+    }
+    if (dst == eepromData) {
+        memset(eepromData, 0xFF, sizeof(eepromData));
+        flashErases++;
+    }
+
+    // Programming can only clear bits
+    for (unsigned i = 0; i < sizeof(c->buffer); i++) {
+        dst[i] &= c->buffer.b[i];
+    }
+    c->address += sizeof(c->buffer);
+
+    return 0;
+}
+
+void config_streamer_init(config_streamer_t *c)
+{
+    memset(c, 0, sizeof(*c));
+}
+
+void config_streamer_start(config_streamer_t *c, uintptr_t base, int size)
+{
+    c->address = base;
+    c->size = size;
+    c->unlocked = true;
+}
+
+int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        c->buffer.b[c->at++] = p[i];
+
+        if (c->at == sizeof(c->buffer)) {
+            c->err = writeWord(c);
+            c->at = 0;
+        }
+    }
+    return c->err;
+}
+
+int config_streamer_flush(config_streamer_t *c)
+{
+    if (c->at != 0) {
+        memset(c->buffer.b + c->at, 0, sizeof(c->buffer) - c->at);
+        c->err = writeWord(c);
+        c->at = 0;
+    }
+    return c->err;
+}
+
+int config_streamer_finish(config_streamer_t *c)
+{
+    c->unlocked = false;
+    return c->err;
+}
+
+int config_streamer_status(config_streamer_t *c)
+{
+    return c->err;
+}
+
+}
@@ -0,0 +1,378 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/maths.h"
+    #include "common/streambuf.h"
+
+    #include "config/config.h"
+    #include "config/config_eeprom.h"
+    #include "config/config_snapshot.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/position.h"
+    #include "pg/stats.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SNAPSHOT_BUF_LEN    256
+
+// Header, then u16 pgn, u8 version, u16 offset, u16 length per record
+#define HEADER_SIZE         4
+#define RECORD_SIZE         7
+#define TRAILER_SIZE        4
+
+static uint8_t snapshot[SNAPSHOT_BUF_LEN];
+
+static int activateCount;
+
+// Read the snapshot in chunks, the way MSP fetches it
+static int readSnapshot(uint8_t flags, int chunkLen)
+{
+    uint8_t chunk[SNAPSHOT_BUF_LEN];
+    int len = 0;
+    bool done;
+
+    memset(snapshot, 0, sizeof(snapshot));
+
+    do {
+        sbuf_t buf;
+        sbufInit(&buf, chunk, chunk + sizeof(chunk));
+
+        done = configSnapshotRead(flags, len, chunkLen, &buf);
+
+        const int count = buf.ptr - chunk;
+        EXPECT_LE(count, chunkLen);
+        EXPECT_LE(len + count, SNAPSHOT_BUF_LEN);
+        memcpy(snapshot + len, chunk, count);
+        len += count;
+
+        if (count == 0) {
+            break;
+        }
+    } while (!done);
+
+    EXPECT_TRUE(done);
+
+    return len;
+}
+
+static configSnapshotStatus_e writeSnapshot(int len, int chunkLen)
+{
+    configSnapshotStatus_e status = CONFIG_SNAPSHOT_FAILED;
+
+    for (int offset = 0; offset < len; offset += chunkLen) {
+        sbuf_t buf;
+        sbufInit(&buf, snapshot + offset, snapshot + MIN(offset + chunkLen, len));
+
+        status = configSnapshotWrite(offset, &buf);
+        if (status != CONFIG_SNAPSHOT_PENDING) {
+            break;
+        }
+    }
+
+    return status;
+}
+
+// Fix up the trailer after a test has patched the snapshot
+static void updateCrc(int len)
+{
+    const uint16_t crc = crc16_ccitt_update(0xFFFF, snapshot, len - 2);
+
+    snapshot[len - 2] = crc & 0xff;
+    snapshot[len - 1] = crc >> 8;
+}
+
+static void changeConfig(void)
+{
+    positionConfigMutable()->gps_min_sats = 8;
+    positionConfigMutable()->vario_lpf = 20;
+    statsConfigMutable()->stats_total_flights = 1234;
+    statsConfigMutable()->stats_min_armed_time_s = 15;
+}
+
+static void expectChangedConfig(void)
+{
+    EXPECT_EQ(8, positionConfig()->gps_min_sats);
+    EXPECT_EQ(20, positionConfig()->vario_lpf);
+    EXPECT_EQ(100, positionConfig()->baro_alt_lpf);
+    EXPECT_EQ(1234u, statsConfig()->stats_total_flights);
+    EXPECT_EQ(0u, statsConfig()->stats_total_time_s);
+    EXPECT_EQ(15, statsConfig()->stats_min_armed_time_s);
+}
+
+TEST(ConfigSnapshotTest, FullRoundTrip)
+{
+    pgResetAll();
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, 7);
+
+    EXPECT_EQ(HEADER_SIZE + 2 * RECORD_SIZE + (int)sizeof(positionConfig_t) + (int)sizeof(statsConfig_t) + TRAILER_SIZE, len);
+    EXPECT_EQ(CONFIG_SNAPSHOT_FORMAT, snapshot[0]);
+    EXPECT_EQ(EEPROM_CONF_VERSION, snapshot[1]);
+    EXPECT_EQ(CONFIG_SNAPSHOT_FULL, snapshot[2]);
+    EXPECT_EQ(0xFF, snapshot[len - 4]);
+    EXPECT_EQ(0xFF, snapshot[len - 3]);
+
+    pgResetAll();
+    positionConfigMutable()->baro_alt_lpf = 1;
+
+    activateCount = 0;
+    EXPECT_EQ(CONFIG_SNAPSHOT_APPLIED, writeSnapshot(len, 5));
+    EXPECT_EQ(0, configSnapshotSkippedRecords());
+    EXPECT_EQ(1, activateCount);
+
+    expectChangedConfig();
+}
+
+TEST(ConfigSnapshotTest, ChunkSizeDoesNotMatter)
+{
+    pgResetAll();
+    changeConfig();
+
+    uint8_t whole[SNAPSHOT_BUF_LEN];
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, SNAPSHOT_BUF_LEN);
+    memcpy(whole, snapshot, len);
+
+    for (int chunkLen = 1; chunkLen < len; chunkLen++) {
+        EXPECT_EQ(len, readSnapshot(CONFIG_SNAPSHOT_FULL, chunkLen));
+        EXPECT_EQ(0, memcmp(whole, snapshot, len));
+    }
+}
+
+TEST(ConfigSnapshotTest, DiffRoundTrip)
+{
+    pgResetAll();
+
+    // Nothing but the header and trailer when all PGs are at defaults
+    EXPECT_EQ(HEADER_SIZE + TRAILER_SIZE, readSnapshot(CONFIG_SNAPSHOT_DIFF, 16));
+    EXPECT_EQ(CONFIG_SNAPSHOT_DIFF, snapshot[2]);
+
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_DIFF, 3);
+    const int fullLen = HEADER_SIZE + 2 * RECORD_SIZE + (int)sizeof(positionConfig_t) + (int)sizeof(statsConfig_t) + TRAILER_SIZE;
+
+    EXPECT_LT(len, fullLen);
+
+    // The diff is applied on top of defaults
+    pgResetAll();
+    positionConfigMutable()->baro_alt_lpf = 1;
+    statsConfigMutable()->stats_total_time_s = 99;
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_APPLIED, writeSnapshot(len, 4));
+
+    expectChangedConfig();
+}
+
+TEST(ConfigSnapshotTest, DiffMergesCloseRuns)
+{
+    pgResetAll();
+
+    // Adjacent fields end up in a single record
+    positionConfigMutable()->gps_alt_lpf = 1;
+    positionConfigMutable()->gps_min_sats = 2;
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_DIFF, 64);
+
+    EXPECT_EQ(HEADER_SIZE + RECORD_SIZE + 3 + TRAILER_SIZE, len);
+    EXPECT_EQ(PG_POSITION, snapshot[HEADER_SIZE] | (snapshot[HEADER_SIZE + 1] << 8));
+    EXPECT_EQ(offsetof(positionConfig_t, gps_alt_lpf), snapshot[HEADER_SIZE + 3]);
+    EXPECT_EQ(3, snapshot[HEADER_SIZE + 5]);
+}
+
+TEST(ConfigSnapshotTest, BadCrc)
+{
+    pgResetAll();
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, 32);
+    snapshot[len - 1] ^= 0x01;
+
+    pgResetAll();
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_FAILED, writeSnapshot(len, 32));
+
+    // Live config is untouched
+    EXPECT_EQ(12, positionConfig()->gps_min_sats);
+    EXPECT_EQ(0u, statsConfig()->stats_total_flights);
+}
+
+TEST(ConfigSnapshotTest, CorruptData)
+{
+    pgResetAll();
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, 32);
+    snapshot[HEADER_SIZE + RECORD_SIZE] ^= 0x80;
+
+    pgResetAll();
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_FAILED, writeSnapshot(len, 32));
+    EXPECT_EQ(12, positionConfig()->gps_min_sats);
+}
+
+TEST(ConfigSnapshotTest, OutOfOrder)
+{
+    pgResetAll();
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, 32);
+
+    pgResetAll();
+
+    sbuf_t buf;
+    sbufInit(&buf, snapshot, snapshot + 10);
+    EXPECT_EQ(CONFIG_SNAPSHOT_PENDING, configSnapshotWrite(0, &buf));
+
+    // Skipped a chunk
+    sbufInit(&buf, snapshot + 20, snapshot + len);
+    EXPECT_EQ(CONFIG_SNAPSHOT_FAILED, configSnapshotWrite(20, &buf));
+
+    // The transfer has to be restarted from zero
+    sbufInit(&buf, snapshot + 10, snapshot + len);
+    EXPECT_EQ(CONFIG_SNAPSHOT_FAILED, configSnapshotWrite(10, &buf));
+
+    EXPECT_EQ(12, positionConfig()->gps_min_sats);
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_APPLIED, writeSnapshot(len, 10));
+    expectChangedConfig();
+}
+
+TEST(ConfigSnapshotTest, ReadAbortsWrite)
+{
+    pgResetAll();
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, 32);
+
+    pgResetAll();
+
+    sbuf_t buf;
+    sbufInit(&buf, snapshot, snapshot + 10);
+    EXPECT_EQ(CONFIG_SNAPSHOT_PENDING, configSnapshotWrite(0, &buf));
+
+    // A read in between reuses the PG copies
+    uint8_t chunk[16];
+    sbuf_t dst;
+    sbufInit(&dst, chunk, chunk + sizeof(chunk));
+    configSnapshotRead(CONFIG_SNAPSHOT_DIFF, 0, sizeof(chunk), &dst);
+
+    sbufInit(&buf, snapshot + 10, snapshot + len);
+    EXPECT_EQ(CONFIG_SNAPSHOT_FAILED, configSnapshotWrite(10, &buf));
+}
+
+TEST(ConfigSnapshotTest, CancelAbortsWrite)
+{
+    pgResetAll();
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, 32);
+
+    pgResetAll();
+
+    sbuf_t buf;
+    sbufInit(&buf, snapshot, snapshot + 10);
+    EXPECT_EQ(CONFIG_SNAPSHOT_PENDING, configSnapshotWrite(0, &buf));
+
+    // Entering the CLI cancels the write
+    configSnapshotCancel();
+
+    activateCount = 0;
+    sbufInit(&buf, snapshot + 10, snapshot + len);
+    EXPECT_EQ(CONFIG_SNAPSHOT_FAILED, configSnapshotWrite(10, &buf));
+    EXPECT_EQ(0, activateCount);
+    EXPECT_EQ(12, positionConfig()->gps_min_sats);
+}
+
+TEST(ConfigSnapshotTest, SkipsOtherVersion)
+{
+    pgResetAll();
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, 64);
+
+    // Bump the version of the first record
+    const uint16_t pgn = snapshot[HEADER_SIZE] | (snapshot[HEADER_SIZE + 1] << 8);
+    snapshot[HEADER_SIZE + 2]++;
+    updateCrc(len);
+
+    pgResetAll();
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_APPLIED, writeSnapshot(len, 64));
+    EXPECT_EQ(1, configSnapshotSkippedRecords());
+
+    // The skipped PG keeps its defaults, the other one is restored
+    if (pgn == PG_POSITION) {
+        EXPECT_EQ(12, positionConfig()->gps_min_sats);
+        EXPECT_EQ(1234u, statsConfig()->stats_total_flights);
+    } else {
+        EXPECT_EQ(8, positionConfig()->gps_min_sats);
+        EXPECT_EQ(0u, statsConfig()->stats_total_flights);
+    }
+}
+
+TEST(ConfigSnapshotTest, RecordPastEnd)
+{
+    pgResetAll();
+    positionConfigMutable()->vario_lpf = 20;
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_DIFF, 64);
+
+    // Point the only record past the end of the PG
+    snapshot[HEADER_SIZE + 3] = sizeof(positionConfig_t);
+    updateCrc(len);
+
+    pgResetAll();
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_FAILED, writeSnapshot(len, 64));
+    EXPECT_EQ(50, positionConfig()->vario_lpf);
+}
+
+TEST(ConfigSnapshotTest, UnknownFormat)
+{
+    pgResetAll();
+    changeConfig();
+
+    const int len = readSnapshot(CONFIG_SNAPSHOT_FULL, 64);
+    snapshot[0] = CONFIG_SNAPSHOT_FORMAT + 1;
+    updateCrc(len);
+
+    pgResetAll();
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_FAILED, writeSnapshot(len, 64));
+    EXPECT_EQ(12, positionConfig()->gps_min_sats);
+}
+
+// STUBS
+
+extern "C" {
+    void activateNewConfig(void)
+    {
+        activateCount++;
+    }
+}
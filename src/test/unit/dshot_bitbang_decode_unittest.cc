@@ -0,0 +1,152 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/dshot_bitbang_decode.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Port samples per telemetry bit
+#define SAMPLES_PER_BIT     3
+// Start bit plus 20 GCR bits
+#define FRAME_BITS          21
+#define BUFFER_SAMPLES      120
+
+static uint16_t portBuffer[BUFFER_SAMPLES];
+static uint32_t pinValues[16];
+
+static const uint8_t gcrCodes[16] = {
+    0x19, 0x1B, 0x12, 0x13, 0x1D, 0x15, 0x16, 0x17,
+    0x1A, 0x09, 0x0A, 0x0B, 0x1E, 0x0D, 0x0E, 0x0F,
+};
+
+// GCR code of a 12 bit telemetry value (eeem mmmm mmmm) and its checksum
+static uint32_t gcrEncode(uint16_t value, bool badChecksum)
+{
+    const uint16_t csum = ~(value ^ (value >> 4) ^ (value >> 8)) & 0xf;
+    uint16_t word = (value << 4) | csum;
+
+    if (badChecksum) {
+        word ^= 1;
+    }
+
+    return (gcrCodes[(word >> 12) & 0xf] << 15) |
+           (gcrCodes[(word >> 8) & 0xf] << 10) |
+           (gcrCodes[(word >> 4) & 0xf] << 5) |
+            gcrCodes[word & 0xf];
+}
+
+// Fill the port samples of one pin. The line idles high, the start bit is
+// a falling edge and every one bit of the GCR code toggles the line.
+static void drawPin(int pin, int start, uint32_t gcr)
+{
+    const uint32_t edges = (1 << (FRAME_BITS - 1)) | gcr;
+    bool level = true;
+
+    for (int i = 0; i < BUFFER_SAMPLES; i++) {
+        const int offset = i - start;
+
+        if (offset >= 0 && offset < FRAME_BITS * SAMPLES_PER_BIT && offset % SAMPLES_PER_BIT == 0) {
+            if (edges & (1 << (FRAME_BITS - 1 - offset / SAMPLES_PER_BIT))) {
+                level = !level;
+            }
+        }
+
+        if (level) {
+            portBuffer[i] |= (1 << pin);
+        } else {
+            portBuffer[i] &= ~(1 << pin);
+        }
+    }
+}
+
+static void idlePort(void)
+{
+    for (int i = 0; i < BUFFER_SAMPLES; i++) {
+        portBuffer[i] = 0xffff;
+    }
+}
+
+TEST(DshotBitbangDecodeTest, DecodePort)
+{
+    idlePort();
+
+    // Period 100us => 6000 eRPM/100
+    drawPin(0, 10, gcrEncode(100, false));
+    // Period 300us << 1 => 1000 eRPM/100, two samples out of phase
+    drawPin(3, 12, gcrEncode((1 << 9) | 300, false));
+    // Motor stopped
+    drawPin(2, 10, gcrEncode(0x0fff, false));
+    // Checksum error
+    drawPin(7, 11, gcrEncode(100, true));
+    // Pin 5 stays idle
+    // Valid frame on a pin that is not decoded
+    drawPin(9, 10, gcrEncode(100, false));
+    // Frame starting too late to fit in the buffer
+    drawPin(11, 70, gcrEncode(100, false));
+
+    const uint32_t pinMask = BIT(0) | BIT(2) | BIT(3) | BIT(5) | BIT(7) | BIT(11);
+
+    decode_bb_port(portBuffer, BUFFER_SAMPLES, pinMask, pinValues);
+
+    EXPECT_EQ(6000u, pinValues[0]);
+    EXPECT_EQ(0u, pinValues[2]);
+    EXPECT_EQ(1000u, pinValues[3]);
+    EXPECT_EQ((uint32_t)BB_NOEDGE, pinValues[5]);
+    EXPECT_EQ((uint32_t)BB_INVALID, pinValues[7]);
+    EXPECT_EQ((uint32_t)BB_NOEDGE, pinValues[9]);
+    EXPECT_EQ((uint32_t)BB_NOEDGE, pinValues[11]);
+}
+
+TEST(DshotBitbangDecodeTest, DecodeAllPins)
+{
+    idlePort();
+
+    for (int pin = 0; pin < 16; pin++) {
+        drawPin(pin, 5 + pin, gcrEncode(100 + pin, false));
+    }
+
+    decode_bb_port(portBuffer, BUFFER_SAMPLES, 0xffff, pinValues);
+
+    for (int pin = 0; pin < 16; pin++) {
+        EXPECT_EQ((uint32_t)(600000 + (100 + pin) / 2) / (100 + pin), pinValues[pin]);
+    }
+}
+
+TEST(DshotBitbangDecodeTest, ShortBuffer)
+{
+    idlePort();
+    drawPin(0, 0, gcrEncode(100, false));
+
+    decode_bb_port(portBuffer, 40, 0xffff, pinValues);
+
+    for (int pin = 0; pin < 16; pin++) {
+        EXPECT_EQ((uint32_t)BB_NOEDGE, pinValues[pin]);
+    }
+}
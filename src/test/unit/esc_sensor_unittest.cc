@@ -0,0 +1,480 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "config/feature.h"
+
+    #include "drivers/dshot_dpwm.h"
+    #include "drivers/serial.h"
+
+    #include "flight/motors.h"
+
+    #include "io/serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/esc_sensor.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Frames sent with a good checksum, for the protocols that have one
+
+static uint32_t crc32(const uint8_t *ptr, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (len--) {
+        crc ^= *ptr++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+    }
+
+    return ~crc;
+}
+
+static uint16_t fletcher16(const uint8_t *ptr, size_t len)
+{
+    uint16_t s0 = 0;
+    uint16_t s1 = 0;
+
+    while (len--) {
+        s0 = (s0 + *ptr++) % 255;
+        s1 = (s1 + s0) % 255;
+    }
+    return s1 << 8 | s0;
+}
+
+static void putLE32(uint8_t *ptr, uint32_t value)
+{
+    ptr[0] = value;
+    ptr[1] = value >> 8;
+    ptr[2] = value >> 16;
+    ptr[3] = value >> 24;
+}
+
+// HW4 data frame: 10000 eRPM, throttle 50%, PWM 60%, V=0x0A00, I=0x0300
+static const uint8_t hw4DataFrame[19] = {
+    0x9B, 0x00, 0x01, 0x2C, 0x01, 0xF4, 0x02, 0x58, 0x00, 0x27,
+    0x10, 0x0A, 0x00, 0x03, 0x00, 0x08, 0x00, 0x08, 0x00,
+};
+
+// HW4 info frame of a 80A ESC: V1=8 V2=91 I1=33 I2=150 I3=90
+static const uint8_t hw4InfoFrame[13] = {
+    0x9B, 0x9B, 0x03, 0xE8, 0x01, 0x08, 0x5B, 0x21, 0x96, 0x5A,
+    0x00, 0x00, 0xB9,
+};
+
+// OMP M4: 25.2V 12.3A, throttle 45%, 1500 rpm, 38°C, PWM 55%, 321mAh
+static const uint8_t ompFrame[32] = {
+    0xDD, 0x01, 0x20, 0x00, 0xFC, 0x00, 0x7B, 0x2D, 0x00, 0x96,
+    0x26, 0x00, 0x37, 0x00, 0x00, 0x01, 0x41, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00,
+};
+
+// ZTW: as above plus status 0x0010, CAN throttle 50% and a 7V BEC
+static const uint8_t ztwFrame[32] = {
+    0xDD, 0x01, 0x20, 0x00, 0xFC, 0x00, 0x7B, 0x2D, 0x00, 0x96,
+    0x26, 0x00, 0x37, 0x00, 0x10, 0x01, 0x41, 0x00, 0x32, 0x07,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x5A, 0xA5,
+};
+
+static void kontronikFrame(uint8_t *frame, uint8_t length, uint8_t crcExclude)
+{
+    memset(frame, 0, length);
+
+    frame[0] = 0x4B;
+    frame[1] = 0x4F;
+    frame[2] = 0x44;
+    frame[3] = 0x4C;
+    putLE32(frame + 4, 123456);         // RPM
+    frame[8] = 0xD0;                    // 25.12V
+    frame[9] = 0x09;
+    frame[10] = 0x7B;                   // 12.3A
+    frame[16] = 0x41;                   // 321mAh
+    frame[17] = 0x01;
+    frame[18] = 0xE8;                   // BEC 1000mA
+    frame[19] = 0x03;
+    frame[20] = 0x58;                   // BEC 8.28V
+    frame[21] = 0x20;
+    frame[22] = 0xDC;                   // 1500us
+    frame[23] = 0x05;
+    frame[24] = 50;                     // 50%
+    frame[26] = 45;                     // FET 45°C
+    frame[27] = (uint8_t)-5;            // BEC -5°C
+    putLE32(frame + 28, 0x00020001);    // Status
+
+    putLE32(frame + length - 4, crc32(frame, length - crcExclude - 4));
+}
+
+static void apdFrame(uint8_t *frame)
+{
+    memset(frame, 0, 22);
+
+    frame[0] = 0xFF;
+    frame[1] = 0xFF;
+    frame[2] = 0x00;                    // Temperature ADC
+    frame[3] = 0x08;
+    frame[4] = 0x64;                    // 8A
+    putLE32(frame + 10, 4321);          // eRPM
+    frame[14] = 0xF4;                   // 50.0%
+    frame[15] = 0x01;
+    frame[16] = 0x26;                   // 55.0%
+    frame[17] = 0x02;
+    frame[18] = 0x01;                   // Motor started
+
+    const uint16_t crc = fletcher16(frame + 2, 18);
+    frame[20] = crc;
+    frame[21] = crc >> 8;
+}
+
+
+extern "C" {
+    uint8_t debugMode;
+    uint8_t debugAxis;
+    int32_t debug[DEBUG_VALUE_COUNT];
+
+    const uint32_t baudRates[] = { 0, 9600, 19200, 38400, 57600, 115200 };
+
+    bool featureIsEnabled(uint32_t mask) { UNUSED(mask); return true; }
+    uint8_t getMotorCount(void) { return 1; }
+    bool motorIsEnabled(void) { return true; }
+
+    static motorDmaOutput_t motorDmaOutput;
+    motorDmaOutput_t *getMotorDmaOutput(uint8_t index) { UNUSED(index); return &motorDmaOutput; }
+
+    void blackboxLogCustomData(const uint8_t *ptr, size_t length) { UNUSED(ptr); UNUSED(length); }
+
+    static timeUs_t currentTimeUs;
+    timeUs_t micros(void) { return currentTimeUs; }
+
+    static serialPort_t escSensorTestPort;
+    static serialPortConfig_t escSensorTestPortConfig;
+
+    static bool frameMode;
+    static serialFrameCallbackPtr frameCallback;
+
+    static uint8_t rxBuffer[512];
+    static uint16_t rxHead;
+    static uint16_t rxTail;
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
+    {
+        EXPECT_EQ(FUNCTION_ESC_SENSOR, function);
+        return &escSensorTestPortConfig;
+    }
+
+    serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function,
+        serialReceiveCallbackPtr callback, void *callbackData, uint32_t baudrate, portMode_e mode, portOptions_e options)
+    {
+        UNUSED(identifier);
+        UNUSED(function);
+        UNUSED(callback);
+        UNUSED(callbackData);
+        UNUSED(baudrate);
+        UNUSED(mode);
+        UNUSED(options);
+        return &escSensorTestPort;
+    }
+
+    bool serialSetFrameCallback(serialPort_t *instance, serialFrameCallbackPtr cb)
+    {
+        UNUSED(instance);
+        frameCallback = cb;
+        return frameMode;
+    }
+
+    uint32_t serialRxBytesWaiting(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return rxHead - rxTail;
+    }
+
+    uint8_t serialRead(serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return rxBuffer[rxTail++];
+    }
+
+    void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+    {
+        UNUSED(instance);
+        UNUSED(data);
+        UNUSED(count);
+    }
+}
+
+
+class EscSensorTest : public ::testing::TestWithParam<bool>
+{
+protected:
+    void startProtocol(uint8_t protocol)
+    {
+        memset(escSensorConfigMutable(), 0, sizeof(escSensorConfig_t));
+        escSensorConfigMutable()->protocol = protocol;
+
+        escSensorTestPortConfig.functionMask = FUNCTION_ESC_SENSOR;
+        escSensorTestPortConfig.identifier = SERIAL_PORT_USART1;
+
+        frameMode = GetParam();
+        frameCallback = NULL;
+        rxHead = rxTail = 0;
+        currentTimeUs = 1000;
+
+        EXPECT_TRUE(escSensorInit());
+    }
+
+    // Deliver a chunk as the UART would, in one callback per idle line
+    // in frame mode or byte by byte through the RX buffer otherwise
+    void receive(const uint8_t *data, uint16_t length)
+    {
+        if (frameMode) {
+            ASSERT_TRUE(frameCallback != NULL);
+            frameCallback(data, length, currentTimeUs, NULL);
+        }
+        else {
+            ASSERT_LE(rxHead + length, (int)sizeof(rxBuffer));
+            memcpy(rxBuffer + rxHead, data, length);
+            rxHead += length;
+        }
+    }
+
+    void process(void)
+    {
+        currentTimeUs += 10000;
+        escSensorProcess(currentTimeUs);
+        rxHead = rxTail = 0;
+    }
+
+    const escSensorData_t *data(void)
+    {
+        return getEscSensorData(0);
+    }
+};
+
+TEST_P(EscSensorTest, HW4)
+{
+    startProtocol(ESC_SENSOR_PROTO_HW4);
+
+    // Data frames with the slow rate filler in between
+    const uint8_t filler = 0xB9;
+    for (int i = 0; i < 4; i++) {
+        receive(hw4DataFrame, sizeof(hw4DataFrame));
+        receive(&filler, 1);
+        process();
+    }
+
+    EXPECT_EQ(0, data()->age);
+    EXPECT_EQ(10000u, data()->erpm);
+    EXPECT_EQ(500, data()->throttle);
+    EXPECT_EQ(600, data()->pwm);
+
+    // Scaling is taken from the info frame once in sync
+    receive(hw4InfoFrame, sizeof(hw4InfoFrame));
+    receive(hw4DataFrame, sizeof(hw4DataFrame));
+    process();
+
+    EXPECT_EQ(22505u, data()->voltage);
+    EXPECT_NEAR(78960, data()->current, 1);
+    EXPECT_EQ(10000u, data()->erpm);
+}
+
+TEST_P(EscSensorTest, HW4Resync)
+{
+    startProtocol(ESC_SENSOR_PROTO_HW4);
+
+    // Line noise and a partial frame before the first full one
+    const uint8_t noise[] = { 0x00, 0x55, 0x12 };
+    receive(noise, sizeof(noise));
+    receive(hw4DataFrame + 7, sizeof(hw4DataFrame) - 7);
+    process();
+
+    EXPECT_EQ(ESC_DATA_INVALID, data()->age);
+
+    receive(hw4DataFrame, sizeof(hw4DataFrame));
+    process();
+
+    EXPECT_EQ(0, data()->age);
+    EXPECT_EQ(10000u, data()->erpm);
+}
+
+TEST_P(EscSensorTest, Kontronik)
+{
+    uint8_t frame[40];
+
+    startProtocol(ESC_SENSOR_PROTO_KONTRONIK);
+    kontronikFrame(frame, sizeof(frame), 0);
+
+    receive(frame, sizeof(frame));
+    process();
+
+    EXPECT_EQ(0, data()->age);
+    EXPECT_EQ(123456u, data()->erpm);
+    EXPECT_EQ(750, data()->throttle);
+    EXPECT_EQ(15000, data()->pwm);
+    EXPECT_EQ(25120u, data()->voltage);
+    EXPECT_EQ(12300u, data()->current);
+    EXPECT_EQ(321u, data()->consumption);
+    EXPECT_EQ(450, data()->temperature);
+    EXPECT_EQ(-50, data()->temperature2);
+    EXPECT_EQ(8280u, data()->bec_voltage);
+    EXPECT_EQ(1000u, data()->bec_current);
+    EXPECT_EQ(0x00020001u, data()->status);
+
+    // A corrupted frame is dropped
+    frame[4] ^= 0xFF;
+    receive(frame, sizeof(frame));
+    process();
+
+    EXPECT_EQ(123456u, data()->erpm);
+}
+
+TEST_P(EscSensorTest, KontronikLegacy)
+{
+    uint8_t frame[38];
+
+    startProtocol(ESC_SENSOR_PROTO_KONTRONIK);
+    kontronikFrame(frame, sizeof(frame), 2);
+
+    for (int i = 0; i < 2; i++) {
+        receive(frame, sizeof(frame));
+        process();
+
+        EXPECT_EQ(0, data()->age);
+        EXPECT_EQ(123456u, data()->erpm);
+        EXPECT_EQ(25120u, data()->voltage);
+    }
+}
+
+TEST_P(EscSensorTest, KontronikSplitFrame)
+{
+    uint8_t frame[40];
+
+    startProtocol(ESC_SENSOR_PROTO_KONTRONIK);
+    kontronikFrame(frame, sizeof(frame), 0);
+
+    // The idle line detection may cut a frame in two
+    receive(frame, 17);
+    process();
+
+    EXPECT_EQ(ESC_DATA_INVALID, data()->age);
+
+    receive(frame + 17, sizeof(frame) - 17);
+    process();
+
+    EXPECT_EQ(0, data()->age);
+    EXPECT_EQ(123456u, data()->erpm);
+}
+
+TEST_P(EscSensorTest, OMP)
+{
+    startProtocol(ESC_SENSOR_PROTO_OMPHOBBY);
+
+    // Decoding starts on the third frame in sync
+    for (int i = 0; i < 2; i++) {
+        receive(ompFrame, sizeof(ompFrame));
+        process();
+        EXPECT_EQ(ESC_DATA_INVALID, data()->age);
+    }
+
+    receive(ompFrame, sizeof(ompFrame));
+    process();
+
+    EXPECT_EQ(0, data()->age);
+    EXPECT_EQ(1500u, data()->erpm);
+    EXPECT_EQ(450, data()->throttle);
+    EXPECT_EQ(550, data()->pwm);
+    EXPECT_EQ(25200u, data()->voltage);
+    EXPECT_EQ(12300u, data()->current);
+    EXPECT_EQ(321u, data()->consumption);
+    EXPECT_EQ(380, data()->temperature);
+    EXPECT_EQ(0u, data()->status);
+}
+
+TEST_P(EscSensorTest, OMPRejectsZTW)
+{
+    startProtocol(ESC_SENSOR_PROTO_OMPHOBBY);
+
+    for (int i = 0; i < 4; i++) {
+        receive(ztwFrame, sizeof(ztwFrame));
+        process();
+    }
+
+    EXPECT_EQ(ESC_DATA_INVALID, data()->age);
+}
+
+TEST_P(EscSensorTest, ZTW)
+{
+    startProtocol(ESC_SENSOR_PROTO_ZTW);
+
+    // Several frames received in one go
+    uint8_t frames[3 * sizeof(ztwFrame)];
+    for (int i = 0; i < 3; i++) {
+        memcpy(frames + i * sizeof(ztwFrame), ztwFrame, sizeof(ztwFrame));
+    }
+
+    receive(frames, sizeof(frames));
+    process();
+
+    EXPECT_EQ(0, data()->age);
+    EXPECT_EQ(1500u, data()->erpm);
+    EXPECT_EQ(25200u, data()->voltage);
+    EXPECT_EQ(12300u, data()->current);
+    EXPECT_EQ(7000u, data()->bec_voltage);
+    EXPECT_EQ(0x0010u, data()->status);
+}
+
+TEST_P(EscSensorTest, APD)
+{
+    uint8_t frame[22];
+
+    startProtocol(ESC_SENSOR_PROTO_APD);
+    apdFrame(frame);
+
+    for (int i = 0; i < 3; i++) {
+        receive(frame, sizeof(frame));
+        process();
+    }
+
+    EXPECT_EQ(0, data()->age);
+    EXPECT_EQ(4321u, data()->erpm);
+    EXPECT_EQ(8000u, data()->current);
+    EXPECT_EQ(500, data()->throttle);
+    EXPECT_EQ(550, data()->pwm);
+    EXPECT_EQ(1u, data()->status);
+
+    // Checksum error
+    frame[10] ^= 0x01;
+    receive(frame, sizeof(frame));
+    process();
+
+    EXPECT_EQ(4321u, data()->erpm);
+}
+
+// Byte by byte from the RX buffer, and whole frames from the frame callback
+INSTANTIATE_TEST_CASE_P(EscSensorFraming, EscSensorTest, ::testing::Values(false, true));
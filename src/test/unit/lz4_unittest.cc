@@ -0,0 +1,269 @@
+/*
+ * This file is part of Rotorflight.
+ *
+ * Rotorflight is free software. You can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Rotorflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/lz4.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BUF_LEN 4096
+
+static lz4State_t state;
+static uint8_t inBuf[BUF_LEN];
+static uint8_t outBuf[LZ4_COMPRESS_BOUND(BUF_LEN)];
+static uint8_t decBuf[BUF_LEN];
+
+static int lz4ReadLength(const uint8_t **ip, const uint8_t *iend, int length)
+{
+    if (length == 15) {
+        uint8_t byte;
+        do {
+            if (*ip >= iend) {
+                return -1;
+            }
+            byte = *(*ip)++;
+            length += byte;
+        } while (byte == 255);
+    }
+
+    return length;
+}
+
+/*
+ * Reference LZ4 block decoder.
+ *
+ * Also checks the end of block rules of the format: the last sequence
+ * is literals only, the last match starts at least 12 bytes before the
+ * end and the last 5 bytes are always literals.
+ *
+ * Returns the decoded length, or -1 if the block is malformed.
+ */
+static int lz4DecompressBlock(uint8_t *dst, int dstLen, const uint8_t *src, int srcLen)
+{
+    const uint8_t *ip = src;
+    const uint8_t * const iend = src + srcLen;
+    uint8_t *op = dst;
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+
+        const int literalLen = lz4ReadLength(&ip, iend, token >> 4);
+        if (literalLen < 0 || literalLen > iend - ip || literalLen > dst + dstLen - op) {
+            return -1;
+        }
+        memcpy(op, ip, literalLen);
+        ip += literalLen;
+        op += literalLen;
+
+        if (ip == iend) {
+            // Last sequence must not carry a match
+            return (token & 15) ? -1 : op - dst;
+        }
+
+        if (iend - ip < 2) {
+            return -1;
+        }
+        const int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op - dst) {
+            return -1;
+        }
+
+        int matchLen = lz4ReadLength(&ip, iend, token & 15);
+        if (matchLen < 0) {
+            return -1;
+        }
+        matchLen += 4;
+        if (matchLen > dst + dstLen - op) {
+            return -1;
+        }
+
+        // Byte by byte copy, matches may overlap the output
+        const uint8_t *match = op - offset;
+        for (int i = 0; i < matchLen; i++) {
+            *op++ = *match++;
+        }
+    }
+
+    return -1;
+}
+
+static bool lz4IsValidTail(const uint8_t *block, int blockLen, int inLen)
+{
+    // Decode again, tracking where the last match ends
+    const uint8_t *ip = block;
+    const uint8_t * const iend = block + blockLen;
+    int pos = 0;
+    int lastMatchStart = -1;
+    int lastMatchEnd = 0;
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+        const int literalLen = lz4ReadLength(&ip, iend, token >> 4);
+        ip += literalLen;
+        pos += literalLen;
+        if (ip >= iend) {
+            break;
+        }
+        ip += 2;
+        const int matchLen = lz4ReadLength(&ip, iend, token & 15) + 4;
+        lastMatchStart = pos;
+        pos += matchLen;
+        lastMatchEnd = pos;
+    }
+
+    if (lastMatchStart < 0) {
+        return true;
+    }
+
+    return lastMatchStart <= inLen - 12 && lastMatchEnd <= inLen - 5;
+}
+
+static void roundTrip(int inLen)
+{
+    memset(outBuf, 0, sizeof(outBuf));
+    memset(decBuf, 0, sizeof(decBuf));
+
+    const int outLen = lz4CompressBlock(&state, outBuf, sizeof(outBuf), inBuf, inLen);
+    ASSERT_GT(outLen, 0);
+    EXPECT_LE(outLen, LZ4_COMPRESS_BOUND(inLen));
+
+    const int decLen = lz4DecompressBlock(decBuf, sizeof(decBuf), outBuf, outLen);
+    ASSERT_EQ(inLen, decLen);
+    EXPECT_EQ(0, memcmp(inBuf, decBuf, inLen));
+    EXPECT_TRUE(lz4IsValidTail(outBuf, outLen, inLen));
+}
+
+TEST(LZ4Test, Empty)
+{
+    const int outLen = lz4CompressBlock(&state, outBuf, sizeof(outBuf), inBuf, 0);
+
+    // A single token with no literals
+    EXPECT_EQ(1, outLen);
+    EXPECT_EQ(0x00, outBuf[0]);
+}
+
+TEST(LZ4Test, ShortInput)
+{
+    // Too short for any match; stored as literals
+    for (int len = 1; len <= 13; len++) {
+        memset(inBuf, 'a', len);
+        roundTrip(len);
+    }
+
+    memset(inBuf, 'a', 12);
+    EXPECT_EQ(13, lz4CompressBlock(&state, outBuf, sizeof(outBuf), inBuf, 12));
+}
+
+TEST(LZ4Test, Zeros)
+{
+    memset(inBuf, 0, BUF_LEN);
+    roundTrip(BUF_LEN);
+
+    const int outLen = lz4CompressBlock(&state, outBuf, sizeof(outBuf), inBuf, BUF_LEN);
+    EXPECT_LT(outLen, 64);
+}
+
+TEST(LZ4Test, Text)
+{
+    static const char text[] =
+        "set gyro_lpf1_type = PT1\n"
+        "set gyro_lpf1_static_hz = 250\n"
+        "set gyro_lpf2_type = PT1\n"
+        "set gyro_lpf2_static_hz = 500\n"
+        "set dterm_lpf1_type = PT1\n"
+        "set dterm_lpf1_static_hz = 100\n";
+
+    int len = 0;
+    while (len + (int)sizeof(text) - 1 <= BUF_LEN) {
+        memcpy(inBuf + len, text, sizeof(text) - 1);
+        len += sizeof(text) - 1;
+    }
+
+    roundTrip(len);
+
+    const int outLen = lz4CompressBlock(&state, outBuf, sizeof(outBuf), inBuf, len);
+    EXPECT_LT(outLen, len / 4);
+}
+
+TEST(LZ4Test, Random)
+{
+    srand(1);
+    for (int i = 0; i < BUF_LEN; i++) {
+        inBuf[i] = rand();
+    }
+
+    for (int len = 0; len <= BUF_LEN; len += 257) {
+        roundTrip(len);
+    }
+    roundTrip(BUF_LEN);
+}
+
+TEST(LZ4Test, Mixed)
+{
+    // Short repeats, runs and noise to exercise long literal and match lengths
+    srand(2);
+    for (int i = 0; i < BUF_LEN; i++) {
+        switch ((i / 300) % 3) {
+            case 0:
+                inBuf[i] = rand();
+                break;
+            case 1:
+                inBuf[i] = i & 3;
+                break;
+            default:
+                inBuf[i] = 0x55;
+                break;
+        }
+    }
+
+    for (int len = 1; len <= BUF_LEN; len = len * 3 + 1) {
+        roundTrip(len);
+    }
+    roundTrip(BUF_LEN);
+}
+
+TEST(LZ4Test, OutputTooSmall)
+{
+    srand(3);
+    for (int i = 0; i < BUF_LEN; i++) {
+        inBuf[i] = rand();
+    }
+
+    const int outLen = lz4CompressBlock(&state, outBuf, sizeof(outBuf), inBuf, BUF_LEN);
+    ASSERT_GT(outLen, 0);
+
+    EXPECT_EQ(-1, lz4CompressBlock(&state, outBuf, outLen - 1, inBuf, BUF_LEN));
+    EXPECT_EQ(outLen, lz4CompressBlock(&state, outBuf, outLen, inBuf, BUF_LEN));
+
+    memset(inBuf, 0, BUF_LEN);
+    EXPECT_EQ(-1, lz4CompressBlock(&state, outBuf, 8, inBuf, BUF_LEN));
+}
+
+TEST(LZ4Test, InputTooLarge)
+{
+    EXPECT_EQ(-1, lz4CompressBlock(&state, outBuf, sizeof(outBuf), inBuf, LZ4_MAX_INPUT_SIZE + 1));
+    EXPECT_EQ(-1, lz4CompressBlock(&state, outBuf, sizeof(outBuf), inBuf, -1));
+}
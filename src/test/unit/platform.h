@@ -29,6 +29,7 @@
 #define NOINLINE
 #define FAST_CODE
 #define FAST_CODE_NOINLINE
+#define INIT_CODE
 #define FAST_DATA_ZERO_INIT
 #define FAST_DATA
 
@@ -80,6 +81,10 @@ typedef struct {
     void* test;
 } DMA_Channel_TypeDef;
 
+typedef struct {
+    void* test;
+} DMA_InitTypeDef;
+
 uint8_t DMA_GetFlagStatus(void *);
 void DMA_Cmd(DMA_Channel_TypeDef*, FunctionalState );
 void DMA_ClearFlag(uint32_t);
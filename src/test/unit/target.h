@@ -83,3 +83,10 @@
 #define TARGET_IO_PORTB         0xffff
 #define TARGET_IO_PORTC         0xffff
 
+
+#ifdef CONFIG_IN_RAM
+#define EEPROM_SIZE             4096
+extern uint8_t eepromData[EEPROM_SIZE];
+#define __config_start          (*eepromData)
+#define __config_end            (*ARRAYEND(eepromData))
+#endif
@@ -63,6 +63,8 @@ extern "C" {
     #include "telemetry/msp_shared.h"
     #include "telemetry/smartport.h"
     #include "sensors/acceleration.h"
+    #include "sensors/gyro.h"
+    #include "sensors/voltage.h"
 
     rssiSource_e rssiSource;
     bool handleMspFrame(uint8_t *frameStart, uint8_t frameLength, uint8_t *skipsBeforeResponse);
@@ -320,4 +322,17 @@ extern "C" {
     }
 
     timeUs_t rxFrameTimeUs(void) { return 0; }
+
+    // telemetry/sensors.c
+    acc_t acc;
+    gyro_t gyro;
+    uint16_t getBatteryCurrent(void) { return 0; }
+    uint32_t getBatteryCapacityUsed(void) { return testmAhDrawn; }
+    int getHeadSpeed(void) { return 0; }
+    int getMotorRPM(uint8_t) { return 0; }
+    uint8_t getGovernorState(void) { return 0; }
+    float getGovernorOutput(void) { return 0; }
+    int getAdjustmentsRangeFunc(void) { return 0; }
+    int getAdjustmentsRangeValue(void) { return 0; }
+    bool voltageMeterRead(voltageMeterId_e, voltageMeter_t *) { return false; }
 }
@@ -56,6 +56,8 @@ extern "C" {
     #include "sensors/battery.h"
     #include "sensors/sensors.h"
     #include "sensors/acceleration.h"
+    #include "sensors/gyro.h"
+    #include "sensors/voltage.h"
 
     #include "msp/msp_serial.h"
 
@@ -379,4 +381,17 @@ bool handleMspFrame(uint8_t *, uint8_t, uint8_t *)  { return false; }
 bool isBatteryVoltageConfigured(void) { return true; }
 bool isAmperageConfigured(void) { return true; }
 timeUs_t rxFrameTimeUs(void) { return 0; }
+
+// telemetry/sensors.c
+acc_t acc;
+gyro_t gyro;
+uint16_t getBatteryCurrent(void) { return 0; }
+uint32_t getBatteryCapacityUsed(void) { return testmAhDrawn; }
+int getHeadSpeed(void) { return 0; }
+int getMotorRPM(uint8_t) { return 0; }
+uint8_t getGovernorState(void) { return 0; }
+float getGovernorOutput(void) { return 0; }
+int getAdjustmentsRangeFunc(void) { return 0; }
+int getAdjustmentsRangeValue(void) { return 0; }
+bool voltageMeterRead(voltageMeterId_e, voltageMeter_t *) { return false; }
 }
@@ -31,7 +31,9 @@ extern "C" {
 #include "gtest/gtest.h"
 
 extern "C" {
-    void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex);
+    void ws2811BuildLUT(void);
+    void updateLEDFrameBuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex);
+    void ws2811PrepareDMABuffer(unsigned frameLength);
     void schedulerIgnoreTaskExecTime(void) {}
     void schedulerIgnoreTaskStateTime(void) {}
 }
@@ -39,9 +41,13 @@ extern "C" {
 TEST(WS2812, updateDMABuffer) {
     // given
     rgbColor24bpp_t color1 = { .raw = {0xFF,0xAA,0x55} };
+    BIT_COMPARE_1 = 2;
+    BIT_COMPARE_0 = 1;
+    ws2811BuildLUT();
 
     // when
-    updateLEDDMABuffer(LED_GRB, &color1, 0);
+    updateLEDFrameBuffer(LED_GRB, &color1, 0);
+    ws2811PrepareDMABuffer(3);
 
     // and
     uint8_t byteIndex = 0;
@@ -75,6 +81,10 @@ TEST(WS2812, updateDMABuffer) {
     EXPECT_EQ(BIT_COMPARE_0, ledStripDMABuffer[(byteIndex * 8) + 6]);
     EXPECT_EQ(BIT_COMPARE_1, ledStripDMABuffer[(byteIndex * 8) + 7]);
     byteIndex++;
+
+    // and the rest of the buffer holds the line low
+    EXPECT_EQ(0, ledStripDMABuffer[(byteIndex * 8) + 0]);
+    EXPECT_EQ(0, ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE - 1]);
 }
 
 extern "C" {